@@ -0,0 +1,98 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// Arena.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the Arena class
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <charconv>
+#include "Arena.hpp"
+
+// Function to make room for at least n more bytes and return the write position
+char* Arena::Reserve(const std::size_t& n)
+{
+    if (m_size + n > m_buffer.size())
+    {
+        // Geometric growth, only happens while the arena warms up to the block size
+        m_buffer.resize(std::max(2 * m_buffer.size(), m_size + n));
+    }
+
+    return m_buffer.data() + m_size;
+}
+
+// Constructor with initial capacity in bytes
+Arena::Arena(const std::size_t& capacity) :
+    m_buffer(capacity),
+    m_size(0)
+{}
+
+// Copy constructor
+Arena::Arena(const Arena& source) :
+    m_buffer(source.m_buffer),
+    m_size(source.m_size)
+{}
+
+// Assignment operator
+Arena& Arena::operator=(const Arena& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_buffer = source.m_buffer;
+    m_size = source.m_size;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to discard the contents while keeping the capacity
+void Arena::Reset()
+{
+    m_size = 0;
+}
+
+// Function to append a character
+void Arena::Append(const char& c)
+{
+    *Reserve(1) = c;
+    m_size += 1;
+}
+
+// Function to append a sequence of characters
+void Arena::Append(const char* data, const std::size_t& length)
+{
+    std::memcpy(Reserve(length), data, length);
+    m_size += length;
+}
+
+// Function to append a string
+void Arena::Append(const std::string& text)
+{
+    Append(text.data(), text.size());
+}
+
+// Function to append an integer
+void Arena::Append(const int& value)
+{
+    char* first = Reserve(16);
+    m_size += std::to_chars(first, first + 16, value).ptr - first;
+}
+
+// Function to append a double in fixed notation with 6 decimals
+void Arena::Append(const double& value)
+{
+    // Typical values fit in 32 characters, very large magnitudes need up to 320
+    char* first = Reserve(32);
+    std::to_chars_result result = std::to_chars(first, first + 32, value, std::chars_format::fixed, 6);
+
+    if (result.ec != std::errc())
+    {
+        first = Reserve(320);
+        result = std::to_chars(first, first + 320, value, std::chars_format::fixed, 6);
+    }
+
+    m_size += result.ptr - first;
+}
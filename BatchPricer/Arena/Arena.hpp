@@ -0,0 +1,58 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// Arena.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the Arena class
+
+// If ARENA_HPP is not defined
+#ifndef ARENA_HPP
+// Define ARENA_HPP
+#define ARENA_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// Class definition for Arena, a bump buffer that holds the formatted output rows of a block.
+// Reset() only rewinds the write position, so once the buffer has grown to the size of a
+// block, formatting further blocks into it performs no memory allocation.
+class Arena
+{
+private:
+
+    // Underlying storage, never shrunk
+    std::vector<char> m_buffer;
+    // Number of bytes in use
+    std::size_t m_size;
+
+    // Function to make room for at least n more bytes and return the write position
+    char* Reserve(const std::size_t& n);
+
+public:
+
+    // Constructor with initial capacity in bytes
+    Arena(const std::size_t& capacity = 1 << 16);
+
+    // Copy constructor
+    Arena(const Arena& source);
+
+    // Assignment operator
+    Arena& operator=(const Arena& source);
+
+    // Function to discard the contents while keeping the capacity
+    void Reset();
+
+    // Functions to append data
+    void Append(const char& c);
+    void Append(const char* data, const std::size_t& length);
+    void Append(const std::string& text);
+    void Append(const int& value);
+    // Append a double in fixed notation with 6 decimals, the format of std::to_string
+    void Append(const double& value);
+
+    // Get inline functions
+    const char* Data() const { return m_buffer.data(); }
+    std::size_t Size() const { return m_size; }
+};
+
+// End of the conditional inclusion of the header file
+#endif
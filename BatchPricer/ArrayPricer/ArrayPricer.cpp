@@ -14,6 +14,8 @@
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
+#include <type_traits>
 
 #include "ArrayPricer.hpp"
 
@@ -45,6 +47,54 @@ void ArrayPricer<OptionType>::WriteCSV(const std::string& filename, const std::v
     file.close();
 }
 
+// Function to evaluate a measure of the current option through the cache when there is one
+template <typename OptionType>
+double ArrayPricer<OptionType>::Evaluate(double(OptionType::* func)(void) const) const
+{
+    unsigned int tag = m_cache ? PricingCache::MeasureTag(func) : 0;
+    PricingCache::Key key;
+
+    // Measures without a tag are not cached
+    if (tag == 0 || !m_cache->MakeKey(*this, tag, 0, key))
+    {
+        return (this->*func)();
+    }
+
+    double values[PricingCache::MAX_VALUES];
+    int count = 0;
+    if (!m_cache->Find(key, values, count))
+    {
+        values[0] = (this->*func)();
+        m_cache->Insert(key, values, 1);
+    }
+
+    return values[0];
+}
+
+// Function to evaluate a measure with a shock size of the current option through the cache when there is one
+template <typename OptionType>
+double ArrayPricer<OptionType>::Evaluate(double(OptionType::* func)(const double&) const, const double& h) const
+{
+    unsigned int tag = m_cache ? PricingCache::MeasureTag(func) : 0;
+    PricingCache::Key key;
+
+    // Measures without a tag are not cached
+    if (tag == 0 || !m_cache->MakeKey(*this, tag, h, key))
+    {
+        return (this->*func)(h);
+    }
+
+    double values[PricingCache::MAX_VALUES];
+    int count = 0;
+    if (!m_cache->Find(key, values, count))
+    {
+        values[0] = (this->*func)(h);
+        m_cache->Insert(key, values, 1);
+    }
+
+    return values[0];
+}
+
 // Constructor with array of parameter values
 template <typename OptionType>
 ArrayPricer<OptionType>::ArrayPricer(const OptionType& option, const std::vector<double>& array,
@@ -53,7 +103,11 @@ ArrayPricer<OptionType>::ArrayPricer(const OptionType& option, const std::vector
     m_array(array),
     m_parameter(parameter),
     m_print(print)
-{}
+{
+    // A European option keeps its intermediates between the measures of a grid point
+    if constexpr (std::is_same<OptionType, EuropeanOption>::value)
+        this->Memoize(true);
+}
 
 // Constructor with start, end, and step size for parameter values
 template <typename OptionType>
@@ -63,7 +117,11 @@ ArrayPricer<OptionType>::ArrayPricer(const OptionType& option, const double& sta
     m_array(createArray(start, end, h)),
     m_parameter(parameter),
     m_print(print)
-{}
+{
+    // A European option keeps its intermediates between the measures of a grid point
+    if constexpr (std::is_same<OptionType, EuropeanOption>::value)
+        this->Memoize(true);
+}
 
 // Copy constructor
 template <typename OptionType>
@@ -71,7 +129,8 @@ ArrayPricer<OptionType>::ArrayPricer(const ArrayPricer& source) :
     OptionType(source),
     m_array(source.m_array),
     m_parameter(source.m_parameter),
-    m_print(source.m_print)
+    m_print(source.m_print),
+    m_cache(source.m_cache)
 {}
 
 // Assignment operator
@@ -86,138 +145,63 @@ ArrayPricer<OptionType>& ArrayPricer<OptionType>::operator=(const ArrayPricer& s
     m_array = source.m_array;
     m_parameter = source.m_parameter;
     m_print = source.m_print;
+    m_cache = source.m_cache;
 
     return *this;
 }
 
-// Function to price array of options using member function pointer
+// Function to attach a cache of results, or detach it with a null pointer
 template <typename OptionType>
-std::vector<std::vector<double>> ArrayPricer<OptionType>::PriceArray(double(OptionType::* func)(void) const, const std::string& output_path)
+ArrayPricer<OptionType>& ArrayPricer<OptionType>::Cache(const std::shared_ptr<PricingCache>& cache)
 {
-    std::vector<std::vector<double>> output_matrix;
-    std::vector<double> price_array;
-
-    if (m_parameter == "T")
-    {
-        for (const auto& parameter : m_array)
-        {
-            this->T(parameter);
-            price_array.push_back((this->*func)());
-        }
-    }
-
-    else if (m_parameter == "K")
-    {
-        for (const auto& parameter : m_array)
-        {
-            this->K(parameter);
-            price_array.push_back((this->*func)());
-        }
-    }
-    else if (m_parameter == "S")
-    {
-        for (const auto& parameter : m_array)
-        {
-            this->S(parameter);
-            price_array.push_back((this->*func)());
-        }
-    }
-    else if (m_parameter == "r")
-    {
-        for (const auto& parameter : m_array)
-        {
-            this->r(parameter);
-            price_array.push_back((this->*func)());
-        }
-    }
-    else if (m_parameter == "sigma")
-    {
-        for (const auto& parameter : m_array)
-        {
-            this->sigma(parameter);
-            price_array.push_back((this->*func)());
-        }
-    }
-    else if (m_parameter == "b")
-    {
-        for (const auto& parameter : m_array)
-        {
-            this->b(parameter);
-            price_array.push_back((this->*func)());
-        }
-    }
-
-    if (m_print)
-    {
-        std::cout << *this << std::endl;
-
-        for (int i = 0; i < m_array.size(); ++i)
-        {
-            std::cout << m_parameter << ": " << m_array[i] << " -> " << price_array[i] << std::endl;
-        }
-    }
-
-    output_matrix.push_back(m_array);
-    output_matrix.push_back(price_array);
+    m_cache = cache;
+    return *this;
+}
 
-    if (!output_path.empty()) WriteCSV(output_path, output_matrix);
+// Function to set the varied parameter of the current option
+template <typename OptionType>
+void ArrayPricer<OptionType>::SetParameter(const double& value)
+{
+    if (m_parameter == "T") this->T(value);
+    else if (m_parameter == "K") this->K(value);
+    else if (m_parameter == "S") this->S(value);
+    else if (m_parameter == "r") this->r(value);
+    else if (m_parameter == "sigma") this->sigma(value);
+    else if (m_parameter == "b") this->b(value);
+    else throw std::invalid_argument("Unknown parameter to vary: " + m_parameter);
+}
 
-    return output_matrix;
+// Function to price array of options using member function pointer
+template <typename OptionType>
+std::vector<std::vector<double>> ArrayPricer<OptionType>::PriceArray(double(OptionType::* func)(void) const, const std::string& output_path)
+{
+    return PriceArray(std::vector<Measure>{ Measure(func) }, output_path);
 }
 
 // Function to price array of options using member function pointer with parameter
 template <typename OptionType>
 std::vector<std::vector<double>> ArrayPricer<OptionType>::PriceArray(double(OptionType::* func)(const double&) const, const double& h, const std::string& output_path)
 {
-    std::vector<std::vector<double>> output_matrix;
-    std::vector<double> price_array;
+    return PriceArray(std::vector<Measure>{ Measure(func, h) }, output_path);
+}
 
-    if (m_parameter == "T")
-    {
-        for (const auto& parameter : m_array)
-        {
-            this->T(parameter);
-            price_array.push_back((this->*func)(h));
-        }
-    }
-    else if (m_parameter == "K")
-    {
-        for (const auto& parameter : m_array)
-        {
-            this->K(parameter);
-            price_array.push_back((this->*func)(h));
-        }
-    }
-    else if (m_parameter == "S")
-    {
-        for (const auto& parameter : m_array)
-        {
-            this->S(parameter);
-            price_array.push_back((this->*func)(h));
-        }
-    }
-    else if (m_parameter == "r")
-    {
-        for (const auto& parameter : m_array)
-        {
-            this->r(parameter);
-            price_array.push_back((this->*func)(h));
-        }
-    }
-    else if (m_parameter == "sigma")
-    {
-        for (const auto& parameter : m_array)
-        {
-            this->sigma(parameter);
-            price_array.push_back((this->*func)(h));
-        }
-    }
-    else if (m_parameter == "b")
+// Function to price array of options for several measures in a single sweep
+template <typename OptionType>
+std::vector<std::vector<double>> ArrayPricer<OptionType>::PriceArray(const std::vector<Measure>& measures, const std::string& output_path)
+{
+    // The parameter is set once per grid point and every measure is evaluated right after, so the measures share the
+    // intermediates that a memoizing option keeps between calls and k measures cost about one sweep
+    std::vector<std::vector<double>> output_matrix(measures.size() + 1);
+    output_matrix[0] = m_array;
+
+    for (const auto& parameter : m_array)
     {
-        for (const auto& parameter : m_array)
+        SetParameter(parameter);
+
+        for (std::size_t j = 0; j < measures.size(); ++j)
         {
-            this->b(parameter);
-            price_array.push_back((this->*func)(h));
+            const Measure& measure = measures[j];
+            output_matrix[j + 1].push_back(measure.func ? Evaluate(measure.func) : Evaluate(measure.numeric, measure.h));
         }
     }
 
@@ -225,15 +209,17 @@ std::vector<std::vector<double>> ArrayPricer<OptionType>::PriceArray(double(Opti
     {
         std::cout << *this << std::endl;
 
-        for (int i = 0; i < m_array.size(); ++i)
+        for (std::size_t i = 0; i < m_array.size(); ++i)
         {
-            std::cout << m_parameter << ": " << m_array[i] << " -> " << price_array[i] << std::endl;
+            std::cout << m_parameter << ": " << m_array[i] << " -> ";
+            for (std::size_t j = 1; j < output_matrix.size(); ++j)
+            {
+                std::cout << (j > 1 ? ", " : "") << output_matrix[j][i];
+            }
+            std::cout << std::endl;
         }
     }
 
-    output_matrix.push_back(m_array);
-    output_matrix.push_back(price_array);
-
     if (!output_path.empty()) WriteCSV(output_path, output_matrix);
 
     return output_matrix;
@@ -11,21 +11,44 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <memory>
 
 #include "../Functions/Functions.hpp"
 #include "../Options/EuropeanOption.hpp"
 #include "../Options/AmericanOption.hpp"
+#include "../Options/HestonOption.hpp"
+#include "../PricingCache/PricingCache.hpp"
 
 // Define the ArrayPrice class, derived from a templated OptionType class
 template <typename OptionType>
 class ArrayPricer : public OptionType
 {
+public:
+    // Measure of a sweep: an analytic member function, or a numeric one with its shock size
+    struct Measure
+    {
+        double(OptionType::* func)(void) const; // Analytic measure, null for a numeric one
+        double(OptionType::* numeric)(const double&) const; // Numeric measure, null for an analytic one
+        double h; // Shock size of the numeric measure
+
+        // Constructor with an analytic measure
+        Measure(double(OptionType::* func)(void) const) : func(func), numeric(nullptr), h(0) {}
+        // Constructor with a numeric measure and its shock size
+        Measure(double(OptionType::* numeric)(const double&) const, const double& h) : func(nullptr), numeric(numeric), h(h) {}
+    };
+
 private:
     std::vector<double> m_array; // Array of parameter values
     std::string m_parameter; // Parameter to vary
     bool m_print; // Flag to print results
+    std::shared_ptr<PricingCache> m_cache; // Optional cache of results, may be shared with other pricers
     // Function to write data to a CSV file
     void WriteCSV(const std::string& filename, const std::vector<std::vector<double>>& data) const;
+    // Functions to evaluate a measure of the current option through the cache when there is one
+    double Evaluate(double(OptionType::* func)(void) const) const;
+    double Evaluate(double(OptionType::* func)(const double&) const, const double& h) const;
+    // Function to set the varied parameter of the current option
+    void SetParameter(const double& value);
 
 public:
     // Constructor with array of parameter values
@@ -42,10 +65,16 @@ public:
     // Assignment operator
     ArrayPricer& operator=(const ArrayPricer& source);
 
+    // Function to attach a cache of results, or detach it with a null pointer
+    ArrayPricer& Cache(const std::shared_ptr<PricingCache>& cache);
+
     // Function to price array of options using member function pointer
     std::vector<std::vector<double>> PriceArray(double(OptionType::* func)(void) const, const std::string& output_path = "");
     // Function to price array of options using member function pointer with parameter
     std::vector<std::vector<double>> PriceArray(double(OptionType::* func)(const double&) const, const double& h = 1, const std::string& output_path = "");
+    // Function to price array of options for several measures in a single sweep, returns the parameter values followed
+    // by one row per measure, in the order of the list
+    std::vector<std::vector<double>> PriceArray(const std::vector<Measure>& measures, const std::string& output_path = "");
 };
 
 // Must be the same name as in source file #define
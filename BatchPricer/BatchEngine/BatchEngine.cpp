@@ -0,0 +1,79 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// BatchEngine.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the templated BatchEngine class
+
+// If BATCHENGINE_CPP is not defined
+#ifndef BATCHENGINE_CPP
+// Define BATCHENGINE_CPP
+#define BATCHENGINE_CPP
+
+#include <vector>
+
+#include "BatchEngine.hpp"
+
+// Default constructor
+template <typename Model>
+BatchEngine<Model>::BatchEngine()
+{}
+
+// Constructor with a vector of options
+template <typename Model>
+BatchEngine<Model>::BatchEngine(const std::vector<OptionType>& options)
+{
+    m_parameters.reserve(options.size());
+    for (const auto& option : options)
+    {
+        Add(option);
+    }
+}
+
+// Copy constructor
+template <typename Model>
+BatchEngine<Model>::BatchEngine(const BatchEngine& source) :
+    m_parameters(source.m_parameters)
+{}
+
+// Assignment operator
+template <typename Model>
+BatchEngine<Model>& BatchEngine<Model>::operator=(const BatchEngine& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_parameters = source.m_parameters;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to append an option to the batch
+template <typename Model>
+void BatchEngine<Model>::Add(const OptionType& option)
+{
+    m_parameters.push_back(Model::Load(option));
+}
+
+// Function to evaluate a measure for n options given by their parameters into out
+template <typename Model>
+template <unsigned int Measure>
+void BatchEngine<Model>::Run(const Parameters* parameters, const std::size_t& n, double* out)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        out[i] = Model::template Evaluate<Measure>(parameters[i]);
+    }
+}
+
+// Function to evaluate a measure for every option of the batch into out
+template <typename Model>
+template <unsigned int Measure>
+void BatchEngine<Model>::Run(std::vector<double>& out) const
+{
+    out.resize(m_parameters.size());
+    Run<Measure>(m_parameters.data(), m_parameters.size(), out.data());
+}
+
+// End of the conditional inclusion of the header file
+#endif
@@ -0,0 +1,75 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// BatchEngine.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the templated BatchEngine class
+
+// If BATCHENGINE_HPP is not defined
+#ifndef BATCHENGINE_HPP
+// Define BATCHENGINE_HPP
+#define BATCHENGINE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+
+#include "StaticModel.hpp"
+#include "BlackScholesModel.hpp"
+#include "PerpetualModel.hpp"
+
+// Define the BatchEngine class, a batch pricer templated on a pricing model derived from StaticModel and, through
+// its Run functions, on the measure. The parameters of the options are copied once into a contiguous array of
+// plain structures, and each run is a loop over that array whose body is the kernel of the model for the measure,
+// resolved at compile time: there is no virtual call, member function pointer or string comparison per option,
+// so the compiler inlines the whole kernel and can vectorize the loop where the math library allows it.
+template <typename Model>
+class BatchEngine
+{
+    static_assert(std::is_base_of<StaticModel<Model>, Model>::value, "BatchEngine needs a model derived from StaticModel");
+
+public:
+    // Option class and parameters of the model
+    typedef typename Model::OptionType OptionType;
+    typedef typename Model::Parameters Parameters;
+
+private:
+    std::vector<Parameters> m_parameters; // Parameters of the options, in insertion order
+
+public:
+    // Default constructor
+    BatchEngine();
+
+    // Constructor with a vector of options
+    BatchEngine(const std::vector<OptionType>& options);
+
+    // Copy constructor
+    BatchEngine(const BatchEngine& source);
+
+    // Assignment operator
+    BatchEngine& operator=(const BatchEngine& source);
+
+    // Function to append an option to the batch
+    void Add(const OptionType& option);
+
+    // Function to return the number of options in the batch
+    std::size_t Size() const { return m_parameters.size(); }
+
+    // Function to return the parameters of the options
+    const std::vector<Parameters>& Rows() const { return m_parameters; }
+
+    // Function to evaluate a measure for n options given by their parameters into out
+    template <unsigned int Measure>
+    static void Run(const Parameters* parameters, const std::size_t& n, double* out);
+
+    // Function to evaluate a measure for every option of the batch into out, resized to the batch
+    template <unsigned int Measure>
+    void Run(std::vector<double>& out) const;
+};
+
+// Must be the same name as in source file #define
+#ifndef BATCHENGINE_CPP
+#include "BatchEngine.cpp"
+#endif
+// It includes the contents of BatchEngine.cpp in the header file of BATCHENGINE_CPP is not already defined
+
+// End of the conditional inclusion of the header file
+#endif
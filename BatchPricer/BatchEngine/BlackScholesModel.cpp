@@ -0,0 +1,12 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// BlackScholesModel.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the BlackScholesModel class
+
+#include "BlackScholesModel.hpp"
+
+// Function to read the parameters of an option
+BlackScholesModel::Parameters BlackScholesModel::Load(const EuropeanOption& option)
+{
+    return Parameters{ option.type() == "Call", option.T(), option.K(), option.S(), option.r(), option.sigma(), option.b() };
+}
@@ -0,0 +1,70 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// BlackScholesModel.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the BlackScholesModel class
+
+// If BLACKSCHOLESMODEL_HPP is not defined
+#ifndef BLACKSCHOLESMODEL_HPP
+// Define BLACKSCHOLESMODEL_HPP
+#define BLACKSCHOLESMODEL_HPP
+
+#include "StaticModel.hpp"
+#include "../Options/EuropeanOption.hpp"
+#include "../Options/BlackScholes.hpp"
+
+// Class definition for BlackScholesModel, the generalized Black-Scholes model of European options dispatched at
+// compile time. The measures are the EuropeanOption flags Price, PricePutCallParity, Delta, Gamma, Vega, Theta and
+// Rho, evaluated with the same Black-Scholes kernels as the EuropeanOption Greek functions.
+class BlackScholesModel : public StaticModel<BlackScholesModel>
+{
+public:
+    // Option class priced by the model
+    typedef EuropeanOption OptionType;
+
+    // Parameters of one option, the option type is held as a flag so that the kernels do not compare strings
+    struct Parameters
+    {
+        bool call;
+        double T;
+        double K;
+        double S;
+        double r;
+        double sigma;
+        double b;
+    };
+
+    // Function to read the parameters of an option
+    static Parameters Load(const EuropeanOption& option);
+
+    // Function to evaluate a measure of one option
+    template <unsigned int Measure>
+    static double Kernel(const Parameters& p);
+};
+
+// Evaluate one measure, the flag is resolved at compile time to a single Black-Scholes kernel
+template <unsigned int Measure>
+double BlackScholesModel::Kernel(const Parameters& p)
+{
+    static_assert(Measure == EuropeanOption::MEASURE_PRICE || Measure == EuropeanOption::MEASURE_PRICE_PUT_CALL_PARITY ||
+        Measure == EuropeanOption::MEASURE_DELTA || Measure == EuropeanOption::MEASURE_GAMMA ||
+        Measure == EuropeanOption::MEASURE_VEGA || Measure == EuropeanOption::MEASURE_THETA || Measure == EuropeanOption::MEASURE_RHO,
+        "BlackScholesModel evaluates Price, PricePutCallParity, Delta, Gamma, Vega, Theta and Rho");
+
+    if constexpr (Measure == EuropeanOption::MEASURE_PRICE)
+        return BlackScholesPrice(p.call, p.T, p.K, p.S, p.r, p.sigma, p.b);
+    else if constexpr (Measure == EuropeanOption::MEASURE_PRICE_PUT_CALL_PARITY)
+        return BlackScholesPricePutCallParity(p.call, p.T, p.K, p.S, p.r, p.sigma, p.b);
+    else if constexpr (Measure == EuropeanOption::MEASURE_DELTA)
+        return BlackScholesDelta(p.call, p.T, p.K, p.S, p.r, p.sigma, p.b);
+    else if constexpr (Measure == EuropeanOption::MEASURE_GAMMA)
+        return BlackScholesGamma(p.T, p.K, p.S, p.r, p.sigma, p.b);
+    else if constexpr (Measure == EuropeanOption::MEASURE_VEGA)
+        return BlackScholesVega(p.T, p.K, p.S, p.r, p.sigma, p.b);
+    else if constexpr (Measure == EuropeanOption::MEASURE_THETA)
+        return BlackScholesTheta(p.call, p.T, p.K, p.S, p.r, p.sigma, p.b);
+    else
+        return BlackScholesRho(p.call, p.T, p.K, p.S, p.r, p.sigma, p.b);
+}
+
+// End of the conditional inclusion of the header file
+#endif
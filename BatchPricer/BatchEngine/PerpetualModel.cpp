@@ -0,0 +1,12 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// PerpetualModel.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the PerpetualModel class
+
+#include "PerpetualModel.hpp"
+
+// Function to read the parameters of an option
+PerpetualModel::Parameters PerpetualModel::Load(const AmericanOption& option)
+{
+    return Parameters{ option.type() == "Call" ? 1.0 : -1.0, option.K(), option.S(), option.r(), option.sigma(), option.b() };
+}
@@ -0,0 +1,76 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// PerpetualModel.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the PerpetualModel class
+
+// If PERPETUALMODEL_HPP is not defined
+#ifndef PERPETUALMODEL_HPP
+// Define PERPETUALMODEL_HPP
+#define PERPETUALMODEL_HPP
+
+#include <cmath>
+
+#include "StaticModel.hpp"
+#include "../Options/AmericanOption.hpp"
+
+// Class definition for PerpetualModel, the closed-form model of American perpetual options dispatched at compile
+// time. The measures are the AmericanOption flags Price, Delta, Gamma, Vega, Rho and CarryRho, with the formulas of
+// the AmericanOption fused kernel; the numeric sensitivities need a shock size and stay with AmericanOption.
+class PerpetualModel : public StaticModel<PerpetualModel>
+{
+public:
+    // Option class priced by the model
+    typedef AmericanOption OptionType;
+
+    // Parameters of one option, the option type is held as the sign of the root of the characteristic equation
+    struct Parameters
+    {
+        double sign; // 1 for a call (root Y1), -1 for a put (root Y2)
+        double K;
+        double S;
+        double r;
+        double sigma;
+        double b;
+    };
+
+    // Function to read the parameters of an option
+    static Parameters Load(const AmericanOption& option);
+
+    // Function to evaluate a measure of one option
+    template <unsigned int Measure>
+    static double Kernel(const Parameters& p);
+};
+
+// Evaluate one measure. With y = Y1 for calls and Y2 for puts, V = K / |y - 1| * x^y where x = (y - 1) / y * S / K,
+// and the sensitivities follow from dV/dS = y * V / S and dV/dy = V * ln(x) as in AmericanOption::Measures.
+template <unsigned int Measure>
+double PerpetualModel::Kernel(const Parameters& p)
+{
+    static_assert(Measure == AmericanOption::MEASURE_PRICE || Measure == AmericanOption::MEASURE_DELTA ||
+        Measure == AmericanOption::MEASURE_GAMMA || Measure == AmericanOption::MEASURE_VEGA ||
+        Measure == AmericanOption::MEASURE_RHO || Measure == AmericanOption::MEASURE_CARRY_RHO,
+        "PerpetualModel evaluates Price, Delta, Gamma, Vega, Rho and CarryRho");
+
+    const double sigma2 = p.sigma * p.sigma;
+    const double a = p.b / sigma2 - 0.5;
+    const double root = std::sqrt(a * a + 2 * p.r / sigma2);
+    const double y = -a + p.sign * root;
+    const double x = ((y - 1) / y) * (p.S / p.K);
+    const double price = p.K / (p.sign * (y - 1)) * std::pow(x, y);
+
+    if constexpr (Measure == AmericanOption::MEASURE_PRICE)
+        return price;
+    else if constexpr (Measure == AmericanOption::MEASURE_DELTA)
+        return y * price / p.S;
+    else if constexpr (Measure == AmericanOption::MEASURE_GAMMA)
+        return y * (y - 1) * price / (p.S * p.S);
+    else if constexpr (Measure == AmericanOption::MEASURE_VEGA)
+        return price * std::log(x) * (2 * p.b - p.sign * 2 * (a * p.b + p.r) / root) / (sigma2 * p.sigma);
+    else if constexpr (Measure == AmericanOption::MEASURE_RHO)
+        return price * std::log(x) * p.sign / (sigma2 * root);
+    else
+        return price * std::log(x) * (p.sign * a / root - 1) / sigma2;
+}
+
+// End of the conditional inclusion of the header file
+#endif
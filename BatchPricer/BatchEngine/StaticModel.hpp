@@ -0,0 +1,36 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// StaticModel.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the templated StaticModel class
+
+// If STATICMODEL_HPP is not defined
+#ifndef STATICMODEL_HPP
+// Define STATICMODEL_HPP
+#define STATICMODEL_HPP
+
+// Define the StaticModel class, the base of the pricing models dispatched at compile time (curiously recurring
+// template pattern). A model Derived provides
+//   - OptionType, the option class it prices,
+//   - Parameters, a plain structure of the parameters of one option, and static Parameters Load(const OptionType&),
+//   - template <unsigned int Measure> static double Kernel(const Parameters&), one measure flag of OptionType.
+// Evaluate resolves to the kernel of the model without a virtual call or a member function pointer, so a loop
+// over the parameters of many options inlines the kernel into its body. The virtual Option::Price stays for
+// single options priced through the base class.
+template <typename Derived>
+class StaticModel
+{
+public:
+    // Function to evaluate a measure of one option with the kernel of the model
+    template <unsigned int Measure, typename Parameters>
+    static double Evaluate(const Parameters& parameters)
+    {
+        return Derived::template Kernel<Measure>(parameters);
+    }
+
+protected:
+    // Models are never instantiated, they only carry their types and kernels
+    StaticModel() = default;
+};
+
+// End of the conditional inclusion of the header file
+#endif
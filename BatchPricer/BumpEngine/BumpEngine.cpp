@@ -0,0 +1,266 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// BumpEngine.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the templated BumpEngine class
+
+// If BUMPENGINE_CPP is not defined
+#ifndef BUMPENGINE_CPP
+// Define BUMPENGINE_CPP
+#define BUMPENGINE_CPP
+
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+#include "BumpEngine.hpp"
+
+// Function to build the shift pattern of every bumped parameter
+template <typename OptionType>
+void BumpEngine<OptionType>::BuildOffsets()
+{
+    m_block = 1;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        m_offsets[i].clear();
+        m_start[i] = m_block;
+
+        if ((m_parameters & (1u << i)) == 0)
+        {
+            continue;
+        }
+
+        if (m_scheme == SCHEME_CENTRAL)
+        {
+            m_offsets[i] = { 1, -1 };
+            if (m_richardson) m_offsets[i].insert(m_offsets[i].end(), { 0.5, -0.5 });
+        }
+        else
+        {
+            m_offsets[i] = { 1 };
+            if (m_richardson) m_offsets[i].push_back(0.5);
+            // The forward second difference of the spot needs a second shifted point
+            if (i == 0) m_offsets[i].push_back(2);
+        }
+
+        m_block += m_offsets[i].size();
+    }
+}
+
+// Function to shift parameter i of an option
+template <typename OptionType>
+void BumpEngine<OptionType>::Bump(OptionType& option, const int& i, const double& shift)
+{
+    switch (i)
+    {
+    case 0:
+        option.S(option.S() + shift);
+        break;
+    case 1:
+        option.sigma(option.sigma() + shift);
+        break;
+    case 2:
+        option.r(option.r() + shift);
+        break;
+    default:
+        if constexpr (HasMaturity<OptionType>::value)
+        {
+            option.T(option.T() + shift);
+        }
+        else
+        {
+            throw std::logic_error("The option does not have a time to expiration to bump.");
+        }
+        break;
+    }
+}
+
+// Function to return the price of an option shifted by offset steps of parameter i
+template <typename OptionType>
+double BumpEngine<OptionType>::PriceAt(const std::size_t& base, const int& i, const double& offset) const
+{
+    if (offset == 0)
+    {
+        return m_prices[base];
+    }
+
+    std::size_t k = std::find(m_offsets[i].begin(), m_offsets[i].end(), offset) - m_offsets[i].begin();
+    return m_prices[base + m_start[i] + k];
+}
+
+// Function to estimate the first derivative along parameter i with a step of scale step sizes
+template <typename OptionType>
+double BumpEngine<OptionType>::FirstDerivative(const std::size_t& base, const int& i, const double& scale) const
+{
+    double h = scale * m_h[i];
+
+    if (m_scheme == SCHEME_CENTRAL)
+    {
+        return (PriceAt(base, i, scale) - PriceAt(base, i, -scale)) / (2 * h);
+    }
+
+    return (PriceAt(base, i, scale) - PriceAt(base, i, 0)) / h;
+}
+
+// Function to estimate the second derivative along parameter i with a step of scale step sizes
+template <typename OptionType>
+double BumpEngine<OptionType>::SecondDerivative(const std::size_t& base, const int& i, const double& scale) const
+{
+    double h = scale * m_h[i];
+
+    if (m_scheme == SCHEME_CENTRAL)
+    {
+        return (PriceAt(base, i, scale) - 2 * PriceAt(base, i, 0) + PriceAt(base, i, -scale)) / (h * h);
+    }
+
+    return (PriceAt(base, i, 2 * scale) - 2 * PriceAt(base, i, scale) + PriceAt(base, i, 0)) / (h * h);
+}
+
+// Constructor with a portfolio, the bumped parameters, the scheme and the Richardson flag
+template <typename OptionType>
+BumpEngine<OptionType>::BumpEngine(const std::vector<OptionType>& portfolio, const unsigned int& parameters,
+    const Scheme& scheme, const bool& richardson) :
+    m_portfolio(portfolio),
+    m_parameters(parameters & BUMP_ALL),
+    m_scheme(scheme),
+    m_richardson(richardson),
+    m_h{ 0.01, 1e-4, 1e-4, 1e-4 }
+{
+    // Options without a time to expiration are not bumped in time and report a NaN Theta
+    if constexpr (!HasMaturity<OptionType>::value)
+    {
+        m_parameters &= ~static_cast<unsigned int>(BUMP_TIME);
+    }
+
+    BuildOffsets();
+}
+
+// Copy constructor
+template <typename OptionType>
+BumpEngine<OptionType>::BumpEngine(const BumpEngine& source) :
+    m_portfolio(source.m_portfolio),
+    m_parameters(source.m_parameters),
+    m_scheme(source.m_scheme),
+    m_richardson(source.m_richardson),
+    m_h{ source.m_h[0], source.m_h[1], source.m_h[2], source.m_h[3] }
+{
+    BuildOffsets();
+}
+
+// Assignment operator
+template <typename OptionType>
+BumpEngine<OptionType>& BumpEngine<OptionType>::operator=(const BumpEngine& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_portfolio = source.m_portfolio;
+    m_parameters = source.m_parameters;
+    m_scheme = source.m_scheme;
+    m_richardson = source.m_richardson;
+    std::copy(source.m_h, source.m_h + 4, m_h);
+    BuildOffsets();
+
+    return *this;
+}
+
+// Function to set the step size of a parameter
+template <typename OptionType>
+BumpEngine<OptionType>& BumpEngine<OptionType>::Step(const Parameter& parameter, const double& h)
+{
+    if (h <= 0)
+    {
+        throw std::invalid_argument("The step size must be positive");
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        if (parameter & (1u << i)) m_h[i] = h;
+    }
+
+    return *this;
+}
+
+// Function to return the number of prices a run evaluates
+template <typename OptionType>
+std::size_t BumpEngine<OptionType>::ScenarioCount() const
+{
+    return m_portfolio.size() * m_block;
+}
+
+// Function to revalue every scenario in one pass and return the sensitivities of every option
+template <typename OptionType>
+const std::vector<typename BumpEngine<OptionType>::Risk>& BumpEngine<OptionType>::Run()
+{
+    // Generate the base and bumped copies of every option
+    m_scenarios.clear();
+    m_scenarios.reserve(ScenarioCount());
+
+    for (const auto& option : m_portfolio)
+    {
+        m_scenarios.push_back(option);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            for (const auto& offset : m_offsets[i])
+            {
+                m_scenarios.push_back(option);
+                Bump(m_scenarios.back(), i, offset * m_h[i]);
+            }
+        }
+    }
+
+    // Single pricing pass over all the scenarios, the calls are resolved statically on OptionType
+    m_prices.resize(m_scenarios.size());
+    for (std::size_t k = 0; k < m_scenarios.size(); ++k)
+    {
+        m_prices[k] = m_scenarios[k].OptionType::Price();
+    }
+
+    // Assemble the sensitivities from the shared base price and the shifted prices
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    m_risks.assign(m_portfolio.size(), Risk{ nan, nan, nan, nan, nan, nan });
+
+    for (std::size_t j = 0; j < m_portfolio.size(); ++j)
+    {
+        std::size_t base = j * m_block;
+        Risk& risk = m_risks[j];
+        risk.price = m_prices[base];
+
+        double first[4];
+        double gamma = nan;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            if ((m_parameters & (1u << i)) == 0)
+            {
+                first[i] = nan;
+                continue;
+            }
+
+            first[i] = FirstDerivative(base, i, 1);
+            if (i == 0) gamma = SecondDerivative(base, i, 1);
+
+            if (m_richardson)
+            {
+                // The central differences have O(h^2) error and the forward differences O(h)
+                double weight = m_scheme == SCHEME_CENTRAL ? 4 : 2;
+                first[i] = (weight * FirstDerivative(base, i, 0.5) - first[i]) / (weight - 1);
+                if (i == 0) gamma = (weight * SecondDerivative(base, i, 0.5) - gamma) / (weight - 1);
+            }
+        }
+
+        risk.delta = first[0];
+        risk.gamma = gamma;
+        risk.vega = first[1];
+        risk.rho = first[2];
+        risk.theta = -first[3];
+    }
+
+    return m_risks;
+}
+
+// End of the conditional inclusion of the header file
+#endif
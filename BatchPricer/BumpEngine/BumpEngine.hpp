@@ -0,0 +1,121 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// BumpEngine.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the templated BumpEngine class
+
+// If BUMPENGINE_HPP is not defined
+#ifndef BUMPENGINE_HPP
+// Define BUMPENGINE_HPP
+#define BUMPENGINE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "../Options/Option.hpp"
+
+// Define the BumpEngine class, a finite-difference risk engine over a portfolio of any Option subclass.
+// Every bumped copy of every option (spot, volatility, rate and time shifts) is generated up front and priced
+// in a single pass, and the sensitivities are then assembled from the shared base price and the shifted prices,
+// so Delta and Gamma together cost three prices per option with the central scheme instead of five. The central
+// and forward schemes are supported, optionally with Richardson extrapolation, which combines the estimates for
+// steps h and h/2 to cancel the leading error term and makes the result far less sensitive to the step size.
+template <typename OptionType>
+class BumpEngine
+{
+public:
+
+    // Bumped parameters, combined into a bitmask
+    enum Parameter : unsigned int
+    {
+        BUMP_SPOT = 1u << 0,
+        BUMP_VOL = 1u << 1,
+        BUMP_RATE = 1u << 2,
+        BUMP_TIME = 1u << 3,
+        BUMP_ALL = (1u << 4) - 1
+    };
+
+    // Finite-difference schemes
+    enum Scheme
+    {
+        SCHEME_CENTRAL,
+        SCHEME_FORWARD
+    };
+
+    // Sensitivities of an option, NaN for parameters that were not bumped
+    struct Risk
+    {
+        double price; // Base price
+        double delta; // dV/dS
+        double gamma; // d2V/dS2
+        double vega; // dV/dsigma
+        double rho; // dV/dr with the cost of carry held fixed
+        double theta; // -dV/dT
+    };
+
+private:
+
+    std::vector<OptionType> m_portfolio; // Options to revalue
+    unsigned int m_parameters; // Bitmask of the bumped parameters
+    Scheme m_scheme; // Finite-difference scheme
+    bool m_richardson; // Flag to apply Richardson extrapolation
+    double m_h[4]; // Step sizes of spot, volatility, rate and time
+
+    std::vector<double> m_offsets[4]; // Shifts of each parameter, in multiples of its step size
+    std::size_t m_start[4]; // Position of the shifts of each parameter within the scenarios of an option
+    std::size_t m_block; // Number of scenarios per option, the base first
+    std::vector<OptionType> m_scenarios; // Base and bumped copies of every option, option by option
+    std::vector<double> m_prices; // Prices of the scenarios
+    std::vector<Risk> m_risks; // Sensitivities of every option
+
+    // Detects whether OptionType has a time to expiration that can be read
+    template <typename T, typename = void>
+    struct HasMaturity : std::false_type {};
+    template <typename T>
+    struct HasMaturity<T, std::void_t<decltype(std::declval<const T&>().T())>> : std::true_type {};
+
+    // Function to build the shift pattern of every bumped parameter
+    void BuildOffsets();
+
+    // Function to shift parameter i (bit position in Parameter) of an option
+    static void Bump(OptionType& option, const int& i, const double& shift);
+
+    // Function to return the price of the option whose base scenario is at base, shifted by offset steps of parameter i
+    double PriceAt(const std::size_t& base, const int& i, const double& offset) const;
+
+    // Functions to estimate the first and second derivatives along parameter i with a step of scale step sizes
+    double FirstDerivative(const std::size_t& base, const int& i, const double& scale) const;
+    double SecondDerivative(const std::size_t& base, const int& i, const double& scale) const;
+
+public:
+
+    // Constructor with a portfolio, the bumped parameters, the scheme and the Richardson flag. The time bump is left out
+    // for option types without a time to expiration.
+    BumpEngine(const std::vector<OptionType>& portfolio, const unsigned int& parameters = BUMP_ALL,
+        const Scheme& scheme = SCHEME_CENTRAL, const bool& richardson = false);
+
+    // Copy constructor
+    BumpEngine(const BumpEngine& source);
+
+    // Assignment operator
+    BumpEngine& operator=(const BumpEngine& source);
+
+    // Function to set the step size of a parameter
+    BumpEngine& Step(const Parameter& parameter, const double& h);
+
+    // Function to return the number of prices a run evaluates
+    std::size_t ScenarioCount() const;
+
+    // Function to revalue every scenario in one pass and return the sensitivities of every option
+    const std::vector<Risk>& Run();
+};
+
+// Must be the same name as in source file #define
+#ifndef BUMPENGINE_CPP
+#include "BumpEngine.cpp"
+#endif
+// It includes the contents of BumpEngine.cpp in the header file of BUMPENGINE_CPP is not already defined
+
+// End of the conditional inclusion of the header file
+#endif
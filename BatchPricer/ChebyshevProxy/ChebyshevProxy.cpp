@@ -0,0 +1,425 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// ChebyshevProxy.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the templated ChebyshevProxy class
+
+// If CHEBYSHEVPROXY_CPP is not defined
+#ifndef CHEBYSHEVPROXY_CPP
+// Define CHEBYSHEVPROXY_CPP
+#define CHEBYSHEVPROXY_CPP
+
+#include <vector>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+#include <boost/math/constants/constants.hpp>
+
+#include "ChebyshevProxy.hpp"
+
+// Function to return node m of axis a
+template <typename OptionType>
+double ChebyshevProxy<OptionType>::Node(const int& a, const std::size_t& m) const
+{
+    const Domain& domain = m_domains[a];
+    if (domain.degree == 0)
+    {
+        return (domain.lower + domain.upper) / 2;
+    }
+
+    // Chebyshev nodes of the first kind, the interval ends are never sampled
+    const double x = std::cos(boost::math::constants::pi<double>() * (m + 0.5) / (domain.degree + 1));
+    return domain.lower + (domain.upper - domain.lower) * (x + 1) / 2;
+}
+
+// Function to map a parameter of axis a to [-1, 1]
+template <typename OptionType>
+double ChebyshevProxy<OptionType>::Scale(const int& a, const double& value) const
+{
+    const Domain& domain = m_domains[a];
+    if (domain.degree == 0)
+    {
+        return 0;
+    }
+
+    return 2 * (value - domain.lower) / (domain.upper - domain.lower) - 1;
+}
+
+// Function to evaluate the measure of the option at S, sigma and T
+template <typename OptionType>
+double ChebyshevProxy<OptionType>::Sample(OptionType& option, const double& S, const double& sigma, const double& T) const
+{
+    option.S(S);
+    option.sigma(sigma);
+    if constexpr (HasMaturity<OptionType>::value)
+    {
+        option.T(T);
+    }
+
+    return (option.*m_measure)();
+}
+
+// Function to run task(i) for i in [0, count) on m_threads threads
+template <typename OptionType>
+template <typename Function>
+void ChebyshevProxy<OptionType>::Parallel(const std::size_t& count, Function task) const
+{
+    std::atomic<std::size_t> next(0);
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+
+    // The first exception thrown by a task stops every thread and is rethrown once they have all joined
+    auto stage = [&]()
+    {
+        try
+        {
+            for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+                i = next.fetch_add(1, std::memory_order_relaxed))
+            {
+                task(i);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(failure_mutex);
+            if (!failure) failure = std::current_exception();
+            next = count;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < m_threads && static_cast<std::size_t>(t) < count; ++t)
+    {
+        workers.emplace_back(stage);
+    }
+    stage();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    if (failure)
+    {
+        std::rethrow_exception(failure);
+    }
+}
+
+// Function to turn the samples along axis a into Chebyshev coefficients in place
+template <typename OptionType>
+void ChebyshevProxy<OptionType>::Transform(std::vector<double>& values, const int& a) const
+{
+    const std::size_t n = Nodes(a);
+    if (n == 1)
+    {
+        return;
+    }
+
+    // Discrete cosine transform matrix, the coefficient of T_0 takes half the weight of the others
+    const double pi = boost::math::constants::pi<double>();
+    std::vector<double> cosines(n * n);
+    for (std::size_t j = 0; j < n; ++j)
+    {
+        for (std::size_t m = 0; m < n; ++m)
+        {
+            cosines[j * n + m] = (j == 0 ? 1.0 : 2.0) / n * std::cos(pi * j * (m + 0.5) / n);
+        }
+    }
+
+    // Lines along axis a are n values at this stride, there are outer lines of them inner values apart
+    const std::size_t stride = a == 2 ? 1 : a == 1 ? Nodes(2) : Nodes(1) * Nodes(2);
+    const std::size_t outer = values.size() / (n * stride);
+    std::vector<double> line(n);
+
+    for (std::size_t o = 0; o < outer; ++o)
+    {
+        for (std::size_t s = 0; s < stride; ++s)
+        {
+            double* first = &values[o * n * stride + s];
+            for (std::size_t m = 0; m < n; ++m) line[m] = first[m * stride];
+
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                double sum = 0;
+                for (std::size_t m = 0; m < n; ++m) sum += cosines[j * n + m] * line[m];
+                first[j * stride] = sum;
+            }
+        }
+    }
+}
+
+// Function to write T_k(x) for k in [0, n] into basis
+template <typename OptionType>
+void ChebyshevProxy<OptionType>::Basis(const double& x, const std::size_t& n, double* basis)
+{
+    basis[0] = 1;
+    if (n > 0) basis[1] = x;
+    for (std::size_t k = 2; k <= n; ++k)
+    {
+        basis[k] = 2 * x * basis[k - 1] - basis[k - 2];
+    }
+}
+
+// Constructor with the option, the intervals of S, sigma and T, the measure and the number of threads
+template <typename OptionType>
+ChebyshevProxy<OptionType>::ChebyshevProxy(const OptionType& option, const Domain& S, const Domain& sigma, const Domain& T,
+    const Measure& measure, const int& threads) :
+    m_option(option),
+    m_measure(measure),
+    m_domains{ S, sigma, T },
+    m_threads(std::max(threads, 1)),
+    m_error_bound(0),
+    m_validated_error(-1)
+{
+    if (measure == nullptr)
+    {
+        throw std::invalid_argument("The proxy needs a measure to interpolate");
+    }
+
+    for (int a = 0; a < 3; ++a)
+    {
+        const Domain& domain = m_domains[a];
+        if (!std::isfinite(domain.lower) || !std::isfinite(domain.upper) || domain.lower > domain.upper ||
+            (domain.degree > 0 && domain.lower == domain.upper))
+        {
+            throw std::invalid_argument("Each interval of the proxy must be finite and not empty");
+        }
+        if (domain.degree > MAX_DEGREE)
+        {
+            throw std::invalid_argument("The degree of the proxy along an axis must not exceed " + std::to_string(MAX_DEGREE));
+        }
+    }
+
+    if (!(S.lower > 0) || !(sigma.lower > 0))
+    {
+        throw std::invalid_argument("The spot and volatility intervals of the proxy must be positive");
+    }
+    if constexpr (HasMaturity<OptionType>::value)
+    {
+        if (!(T.lower > 0))
+        {
+            throw std::invalid_argument("The time to expiration interval of the proxy must be positive");
+        }
+    }
+    else if (T.degree != 0)
+    {
+        throw std::invalid_argument("The option does not have a time to expiration, the degree along T must be 0");
+    }
+}
+
+// Copy constructor
+template <typename OptionType>
+ChebyshevProxy<OptionType>::ChebyshevProxy(const ChebyshevProxy& source) :
+    m_option(source.m_option),
+    m_measure(source.m_measure),
+    m_domains{ source.m_domains[0], source.m_domains[1], source.m_domains[2] },
+    m_threads(source.m_threads),
+    m_coefficients(source.m_coefficients),
+    m_error_bound(source.m_error_bound),
+    m_validated_error(source.m_validated_error)
+{}
+
+// Assignment operator
+template <typename OptionType>
+ChebyshevProxy<OptionType>& ChebyshevProxy<OptionType>::operator=(const ChebyshevProxy& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_option = source.m_option;
+    m_measure = source.m_measure;
+    std::copy(source.m_domains, source.m_domains + 3, m_domains);
+    m_threads = source.m_threads;
+    m_coefficients = source.m_coefficients;
+    m_error_bound = source.m_error_bound;
+    m_validated_error = source.m_validated_error;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to sample the measure on the Chebyshev nodes and compute the coefficients
+template <typename OptionType>
+ChebyshevProxy<OptionType>& ChebyshevProxy<OptionType>::Build()
+{
+    const std::size_t n0 = Nodes(0), n1 = Nodes(1), n2 = Nodes(2);
+    std::vector<double> values(n0 * n1 * n2);
+
+    // Each task samples the T line of one (S, sigma) node on its own copy of the option
+    Parallel(n0 * n1, [&](const std::size_t& line)
+    {
+        OptionType option(m_option);
+        const double S = Node(0, line / n1), sigma = Node(1, line % n1);
+        for (std::size_t k = 0; k < n2; ++k)
+        {
+            values[line * n2 + k] = Sample(option, S, sigma, Node(2, k));
+        }
+    });
+
+    for (int a = 0; a < 3; ++a)
+    {
+        Transform(values, a);
+    }
+
+    // Sum the coefficients of the highest degree along each axis that has more than one node
+    double tail = 0;
+    for (std::size_t i = 0; i < n0; ++i)
+    {
+        for (std::size_t j = 0; j < n1; ++j)
+        {
+            for (std::size_t k = 0; k < n2; ++k)
+            {
+                if ((n0 > 1 && i == n0 - 1) || (n1 > 1 && j == n1 - 1) || (n2 > 1 && k == n2 - 1))
+                {
+                    tail += std::abs(values[(i * n1 + j) * n2 + k]);
+                }
+            }
+        }
+    }
+
+    m_coefficients.swap(values);
+    m_error_bound = 2 * tail;
+    m_validated_error = -1;
+
+    return *this;
+}
+
+// Function to return whether S, sigma and T are inside the intervals of the proxy
+template <typename OptionType>
+bool ChebyshevProxy<OptionType>::Contains(const double& S, const double& sigma, const double& T) const
+{
+    bool inside = S >= m_domains[0].lower && S <= m_domains[0].upper && sigma >= m_domains[1].lower && sigma <= m_domains[1].upper;
+    if constexpr (HasMaturity<OptionType>::value)
+    {
+        inside = inside && T >= m_domains[2].lower && T <= m_domains[2].upper;
+    }
+
+    return inside;
+}
+
+// Function to return the interpolated measure at S, sigma and T
+template <typename OptionType>
+double ChebyshevProxy<OptionType>::Value(const double& S, const double& sigma, const double& T) const
+{
+    if (!Built())
+    {
+        throw std::logic_error("The proxy must be built before it is evaluated");
+    }
+    if (!Contains(S, sigma, T))
+    {
+        throw std::invalid_argument("The parameters are outside the intervals of the proxy");
+    }
+
+    double basis[3][MAX_DEGREE + 1];
+    for (int a = 0; a < 3; ++a)
+    {
+        Basis(Scale(a, a == 0 ? S : a == 1 ? sigma : T), m_domains[a].degree, basis[a]);
+    }
+
+    // Contract the coefficients with the polynomials of T, then of sigma, then of S, the sums of the innermost
+    // axis are independent of each other so the loop does not wait on a recurrence
+    const std::size_t n0 = Nodes(0), n1 = Nodes(1), n2 = Nodes(2);
+    const double* c = m_coefficients.data();
+    double value = 0;
+
+    for (std::size_t i = 0; i < n0; ++i)
+    {
+        double row = 0;
+        for (std::size_t j = 0; j < n1; ++j)
+        {
+            const double* line = c + (i * n1 + j) * n2;
+            double sum = 0;
+            for (std::size_t k = 0; k < n2; ++k) sum += line[k] * basis[2][k];
+            row += sum * basis[1][j];
+        }
+        value += row * basis[0][i];
+    }
+
+    return value;
+}
+
+// Function to return the interpolated measure of an option, read at its S, sigma and T
+template <typename OptionType>
+double ChebyshevProxy<OptionType>::Value(const OptionType& option) const
+{
+    if constexpr (HasMaturity<OptionType>::value)
+    {
+        return Value(option.S(), option.sigma(), option.T());
+    }
+    else
+    {
+        return Value(option.S(), option.sigma(), m_domains[2].lower);
+    }
+}
+
+// Function to return the interpolated measure of every option into out
+template <typename OptionType>
+void ChebyshevProxy<OptionType>::Value(const std::vector<OptionType>& options, std::vector<double>& out) const
+{
+    out.resize(options.size());
+    for (std::size_t i = 0; i < options.size(); ++i)
+    {
+        out[i] = Value(options[i]);
+    }
+}
+
+// Function to compare the proxy with the measure on a grid between the nodes and return the largest absolute error
+template <typename OptionType>
+double ChebyshevProxy<OptionType>::Validate(const std::size_t& points)
+{
+    if (!Built())
+    {
+        throw std::logic_error("The proxy must be built before it is validated");
+    }
+    if (points == 0)
+    {
+        throw std::invalid_argument("The number of validation points per axis must be positive");
+    }
+
+    // Points at the middle of equal cells of each interval, a single one along an axis of degree 0
+    auto count = [&](const int& a) { return m_domains[a].degree == 0 ? std::size_t(1) : points; };
+    auto point = [&](const int& a, const std::size_t& p)
+    {
+        const Domain& domain = m_domains[a];
+        return domain.degree == 0 ? Node(a, 0) : domain.lower + (domain.upper - domain.lower) * (p + 0.5) / points;
+    };
+
+    const std::size_t p1 = count(1), p2 = count(2);
+    std::vector<double> errors(count(0) * p1, 0);
+
+    Parallel(errors.size(), [&](const std::size_t& line)
+    {
+        OptionType option(m_option);
+        const double S = point(0, line / p1), sigma = point(1, line % p1);
+        for (std::size_t k = 0; k < p2; ++k)
+        {
+            const double T = point(2, k);
+            errors[line] = std::max(errors[line], std::abs(Value(S, sigma, T) - Sample(option, S, sigma, T)));
+        }
+    });
+
+    m_validated_error = *std::max_element(errors.begin(), errors.end());
+    return m_validated_error;
+}
+
+// Overloaded stream insertion operator
+template <typename OptionType>
+std::ostream& operator<<(std::ostream& os, const ChebyshevProxy<OptionType>& proxy)
+{
+    os << "Chebyshev proxy: degrees " << proxy.Axis(0).degree << " x " << proxy.Axis(1).degree << " x " << proxy.Axis(2).degree
+        << ", " << proxy.SampleCount() << " samples, error bound " << proxy.ErrorBound();
+    if (proxy.ValidatedError() >= 0)
+    {
+        os << ", validated error " << proxy.ValidatedError();
+    }
+
+    return os;
+}
+
+// End of the conditional inclusion of the header file
+#endif
@@ -0,0 +1,145 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// ChebyshevProxy.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the templated ChebyshevProxy class
+
+// If CHEBYSHEVPROXY_HPP is not defined
+#ifndef CHEBYSHEVPROXY_HPP
+// Define CHEBYSHEVPROXY_HPP
+#define CHEBYSHEVPROXY_HPP
+
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <ostream>
+
+// Define the ChebyshevProxy class, a tensor Chebyshev interpolant of a measure of any option class in spot,
+// volatility and time to expiration. Build() evaluates the measure of the option on the tensor grid of Chebyshev
+// nodes of the three intervals, sharing the nodes out between threads, and turns the samples into the coefficients
+// of the interpolating polynomial with one discrete cosine transform per axis. A query evaluates the Chebyshev
+// polynomials of each axis at its parameter once and contracts the coefficients with them, a fixed number of
+// independent multiply-adds whatever the cost of the pricing engine, which
+// pays off for engines slower than the closed forms (Heston, lattices, Monte Carlo) repriced over many scenarios.
+// The parameters other than S, sigma and T are those of the option the proxy was built from. An option class
+// without a time to expiration is interpolated in S and sigma only, with a T interval of degree 0.
+template <typename OptionType>
+class ChebyshevProxy
+{
+public:
+
+    // Highest degree along an axis, the Chebyshev polynomials of a query are kept on the stack
+    static const std::size_t MAX_DEGREE = 64;
+
+    // Interpolated measure of the option
+    typedef double (OptionType::* Measure)(void) const;
+
+    // Interval of a parameter and degree of the polynomial along it, degree + 1 nodes are sampled
+    struct Domain
+    {
+        double lower;
+        double upper;
+        std::size_t degree;
+    };
+
+private:
+
+    OptionType m_option; // Option sampled, with S, sigma and T moved to the nodes
+    Measure m_measure; // Interpolated measure
+    Domain m_domains[3]; // Intervals of S, sigma and T
+    int m_threads; // Number of sampling threads
+    std::vector<double> m_coefficients; // Chebyshev coefficients, T fastest then sigma then S
+    double m_error_bound; // Estimated bound of the interpolation error
+    double m_validated_error; // Largest error measured by Validate(), negative before
+
+    // Detects whether OptionType has a time to expiration that can be set
+    template <typename T, typename = void>
+    struct HasMaturity : std::false_type {};
+    template <typename T>
+    struct HasMaturity<T, std::void_t<decltype(std::declval<T&>().T(0.0)), decltype(std::declval<const T&>().T())>> :
+        std::true_type {};
+
+    // Function to return the number of nodes along axis a
+    std::size_t Nodes(const int& a) const { return m_domains[a].degree + 1; }
+
+    // Function to return node m of axis a
+    double Node(const int& a, const std::size_t& m) const;
+
+    // Function to map a parameter of axis a to [-1, 1]
+    double Scale(const int& a, const double& value) const;
+
+    // Function to evaluate the measure of the option at S, sigma and T
+    double Sample(OptionType& option, const double& S, const double& sigma, const double& T) const;
+
+    // Function to run task(i) for i in [0, count) on m_threads threads, each claiming indexes in turn
+    template <typename Function>
+    void Parallel(const std::size_t& count, Function task) const;
+
+    // Function to turn the samples along axis a into Chebyshev coefficients in place
+    void Transform(std::vector<double>& values, const int& a) const;
+
+    // Function to write T_k(x) for k in [0, n] into basis
+    static void Basis(const double& x, const std::size_t& n, double* basis);
+
+public:
+
+    // Constructor with the option, the intervals of S, sigma and T, the measure and the number of threads
+    ChebyshevProxy(const OptionType& option, const Domain& S, const Domain& sigma, const Domain& T,
+        const Measure& measure = &OptionType::Price, const int& threads = 1);
+
+    // Copy constructor
+    ChebyshevProxy(const ChebyshevProxy& source);
+
+    // Assignment operator
+    ChebyshevProxy& operator=(const ChebyshevProxy& source);
+
+    // Function to sample the measure on the Chebyshev nodes and compute the coefficients
+    ChebyshevProxy& Build();
+
+    // Function to return whether the proxy has been built
+    bool Built() const { return !m_coefficients.empty(); }
+
+    // Function to return the number of samples Build() evaluates
+    std::size_t SampleCount() const { return Nodes(0) * Nodes(1) * Nodes(2); }
+
+    // Function to return whether S, sigma and T are inside the intervals of the proxy
+    bool Contains(const double& S, const double& sigma, const double& T) const;
+
+    // Function to return the interpolated measure at S, sigma and T, which must be inside the intervals
+    double Value(const double& S, const double& sigma, const double& T) const;
+
+    // Function to return the interpolated measure of an option, read at its S, sigma and T
+    double Value(const OptionType& option) const;
+
+    // Function to return the interpolated measure of every option into out, resized to the options
+    void Value(const std::vector<OptionType>& options, std::vector<double>& out) const;
+
+    // Function to return the estimated bound of the interpolation error, twice the sum of the magnitudes of the
+    // coefficients of the highest degree along each axis. The coefficients of a smooth measure decay geometrically,
+    // so the first neglected ones are bounded by the last ones kept and the bound holds unless the degree is too low
+    // to resolve the measure, which Validate() detects.
+    double ErrorBound() const { return m_error_bound; }
+
+    // Function to compare the proxy with the measure at points per axis points of a grid between the nodes, on
+    // m_threads threads, and return the largest absolute error
+    double Validate(const std::size_t& points = 9);
+
+    // Function to return the largest error measured by Validate(), negative if it has not been run
+    double ValidatedError() const { return m_validated_error; }
+
+    // Function to return the interval and degree of axis a, 0 for S, 1 for sigma and 2 for T
+    const Domain& Axis(const int& a) const { return m_domains[a]; }
+};
+
+// Overloaded stream insertion operator
+template <typename OptionType>
+std::ostream& operator<<(std::ostream& os, const ChebyshevProxy<OptionType>& proxy);
+
+// Must be the same name as in source file #define
+#ifndef CHEBYSHEVPROXY_CPP
+#include "ChebyshevProxy.cpp"
+#endif
+// It includes the contents of ChebyshevProxy.cpp in the header file of CHEBYSHEVPROXY_CPP is not already defined
+
+// End of the conditional inclusion of the header file
+#endif
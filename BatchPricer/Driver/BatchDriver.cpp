@@ -0,0 +1,598 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// BatchDriver.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the BatchDriver class
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <memory>
+#include <csignal>
+
+#include "BatchDriver.hpp"
+#include "../StreamPricer/StreamPricer.hpp"
+#include "../ReorderPricer/ReorderPricer.hpp"
+#include "../ShardPlan/ShardPlan.hpp"
+#include "../PricingCache/PricingCache.hpp"
+#include "../VolSurface/VolSurface.hpp"
+#include "../YieldCurve/YieldCurve.hpp"
+#include "../RiskAggregator/RiskAggregator.hpp"
+#include "../HistoricalVaR/HistoricalVaR.hpp"
+#include "../PricingService/PricingServer.hpp"
+#include "../PricingService/LoadGenerator.hpp"
+#include "../Functions/Functions.hpp"
+
+// Set by SIGINT and SIGTERM to stop serving
+static volatile std::sig_atomic_t g_interrupted = 0;
+
+// Signal handler of the pricing server
+static void Interrupt(int)
+{
+    g_interrupted = 1;
+}
+
+// Function to return the output delimiter for the format
+char BatchDriver::Delimiter() const
+{
+    return m_format == "tsv" ? '\t' : ',';
+}
+
+// Constructor with command-line arguments
+BatchDriver::BatchDriver(const int& argc, char* argv[]) :
+    m_arguments(argv, argv + argc),
+    m_style("european"),
+    m_configuration("price"),
+    m_format("csv"),
+    m_threads(std::max(1, static_cast<int>(std::thread::hardware_concurrency()))),
+    m_chunk_size(10000),
+    m_h(1),
+    m_cache_size(0),
+    m_quantum(1e-12),
+    m_checkpoint_interval(10),
+    m_resume(false),
+    m_reorder("none"),
+    m_run_rows(1000000),
+    m_shard_count(0),
+    m_shard(-1),
+    m_merge(false),
+    m_budget(500),
+    m_max_batch(256),
+    m_duration(0),
+    m_connections(4),
+    m_requests(10000),
+    m_window(1)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+
+        // Flags without a value
+        if (argument == "--resume")
+        {
+            m_resume = true;
+            continue;
+        }
+        if (argument == "--merge")
+        {
+            m_merge = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            throw std::invalid_argument("Missing value for argument: " + argument);
+        }
+
+        std::string value = argv[++i];
+
+        if (argument == "--input") m_input_path = value;
+        else if (argument == "--output") m_output_path = value;
+        else if (argument == "--style") m_style = value;
+        else if (argument == "--config") m_configuration = value;
+        else if (argument == "--format") m_format = value;
+        else if (argument == "--threads") m_threads = std::stoi(value);
+        else if (argument == "--chunk") m_chunk_size = std::stoul(value);
+        else if (argument == "--shock") m_h = std::stod(value);
+        else if (argument == "--cache") m_cache_size = std::stoul(value);
+        else if (argument == "--quantum") m_quantum = std::stod(value);
+        else if (argument == "--surface") m_surface_path = value;
+        else if (argument == "--rate-curve") m_rate_curve_path = value;
+        else if (argument == "--carry-curve") m_carry_curve_path = value;
+        else if (argument == "--var") m_scenario_path = value;
+        else if (argument == "--checkpoint") m_checkpoint_path = value;
+        else if (argument == "--checkpoint-every") m_checkpoint_interval = std::stoul(value);
+        else if (argument == "--rejects") m_reject_path = value;
+        else if (argument == "--reorder") m_reorder = value;
+        else if (argument == "--run") m_run_rows = std::stoul(value);
+        else if (argument == "--shards") m_shard_count = std::stoul(value);
+        else if (argument == "--shard") m_shard = std::stol(value);
+        else if (argument == "--serve") m_serve_path = value;
+        else if (argument == "--load") m_load_path = value;
+        else if (argument == "--budget") m_budget = std::stod(value);
+        else if (argument == "--batch") m_max_batch = std::stoul(value);
+        else if (argument == "--duration") m_duration = std::stod(value);
+        else if (argument == "--connections") m_connections = std::stoul(value);
+        else if (argument == "--requests") m_requests = std::stoul(value);
+        else if (argument == "--window") m_window = std::stoul(value);
+        else if (argument == "--aggregate")
+        {
+            // One view per edge, however many edges the list has
+            std::vector<std::string_view> edges(std::count(value.begin(), value.end(), ',') + 1);
+            std::size_t count = splitFields(value, edges.data(), edges.size());
+            m_buckets.assign(count, 0);
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                if (!parseField(edges[k], m_buckets[k])) throw std::invalid_argument("Malformed expiry bucket edges: " + value);
+            }
+        }
+        else throw std::invalid_argument("Unknown argument: " + argument);
+    }
+
+    if (m_resume && m_checkpoint_path.empty())
+    {
+        throw std::invalid_argument("--resume needs the --checkpoint file of the interrupted run");
+    }
+    if (!m_checkpoint_path.empty() && (!m_buckets.empty() || !m_scenario_path.empty()))
+    {
+        throw std::invalid_argument("Checkpoints are only available when pricing the rows of the input");
+    }
+    if (!m_reject_path.empty() && (!m_buckets.empty() || !m_scenario_path.empty()))
+    {
+        throw std::invalid_argument("Reject files are only available when pricing the rows of the input");
+    }
+    if (m_checkpoint_interval < 1)
+    {
+        throw std::invalid_argument("The checkpoint interval must be positive");
+    }
+    if (m_reorder != "none" && m_reorder != "block" && m_reorder != "global")
+    {
+        throw std::invalid_argument("Unknown pricing order: " + m_reorder);
+    }
+    if (m_reorder == "block" && m_style != "european")
+    {
+        throw std::invalid_argument("--reorder block is only available for European options");
+    }
+    if (m_reorder != "none" && (!m_buckets.empty() || !m_scenario_path.empty()))
+    {
+        throw std::invalid_argument("--reorder is only available when pricing the rows of the input");
+    }
+    if (m_reorder == "global" && !m_checkpoint_path.empty())
+    {
+        throw std::invalid_argument("--reorder global cannot be combined with checkpoints");
+    }
+    if (m_run_rows < 1)
+    {
+        throw std::invalid_argument("The number of rows per sorted run must be positive");
+    }
+    if ((m_shard >= 0 || m_merge) && m_shard_count == 0)
+    {
+        throw std::invalid_argument("--shard and --merge need the --shards count of the run");
+    }
+    if (m_shard_count > 0 && (m_shard < -1 || m_shard >= static_cast<long>(m_shard_count) || (m_shard >= 0 && m_merge)))
+    {
+        throw std::invalid_argument("--shard must be between 0 and the number of shards minus one, without --merge");
+    }
+    if (m_shard_count > 0 && (!m_buckets.empty() || !m_scenario_path.empty() || !m_checkpoint_path.empty() ||
+        m_reorder == "global" || !m_serve_path.empty() || !m_load_path.empty()))
+    {
+        throw std::invalid_argument("Sharded runs only price the rows of the input, without checkpoints or global reordering");
+    }
+    if (!m_serve_path.empty() && !m_load_path.empty())
+    {
+        throw std::invalid_argument("--serve and --load cannot be combined");
+    }
+    if ((m_input_path.empty() || m_output_path.empty()) && m_serve_path.empty() && m_load_path.empty())
+    {
+        throw std::invalid_argument("Both --input and --output are required");
+    }
+    if (m_style != "european" && m_style != "american")
+    {
+        throw std::invalid_argument("Unknown option style: " + m_style);
+    }
+    if (m_format != "csv" && m_format != "tsv")
+    {
+        throw std::invalid_argument("Unknown output format: " + m_format);
+    }
+    if (m_threads < 1 || m_chunk_size < 1)
+    {
+        throw std::invalid_argument("Threads and chunk size must be positive");
+    }
+    if (m_quantum < 0)
+    {
+        throw std::invalid_argument("The cache quantum must not be negative");
+    }
+    if (!m_surface_path.empty() && m_style != "european")
+    {
+        throw std::invalid_argument("A volatility surface can only be used with European options");
+    }
+    if ((!m_rate_curve_path.empty() || !m_carry_curve_path.empty()) && m_style != "european")
+    {
+        throw std::invalid_argument("Rate and carry curves can only be used with European options");
+    }
+    if ((!m_buckets.empty() || !m_scenario_path.empty()) && m_style != "european")
+    {
+        throw std::invalid_argument("Risk aggregation and historical VaR are only available for European options");
+    }
+    if (!m_buckets.empty() && !m_scenario_path.empty())
+    {
+        throw std::invalid_argument("--aggregate and --var cannot be combined");
+    }
+}
+
+// Copy constructor
+BatchDriver::BatchDriver(const BatchDriver& source) :
+    m_arguments(source.m_arguments),
+    m_input_path(source.m_input_path),
+    m_output_path(source.m_output_path),
+    m_style(source.m_style),
+    m_configuration(source.m_configuration),
+    m_format(source.m_format),
+    m_threads(source.m_threads),
+    m_chunk_size(source.m_chunk_size),
+    m_h(source.m_h),
+    m_cache_size(source.m_cache_size),
+    m_quantum(source.m_quantum),
+    m_surface_path(source.m_surface_path),
+    m_rate_curve_path(source.m_rate_curve_path),
+    m_carry_curve_path(source.m_carry_curve_path),
+    m_buckets(source.m_buckets),
+    m_scenario_path(source.m_scenario_path),
+    m_checkpoint_path(source.m_checkpoint_path),
+    m_checkpoint_interval(source.m_checkpoint_interval),
+    m_resume(source.m_resume),
+    m_reject_path(source.m_reject_path),
+    m_reorder(source.m_reorder),
+    m_run_rows(source.m_run_rows),
+    m_shard_count(source.m_shard_count),
+    m_shard(source.m_shard),
+    m_merge(source.m_merge),
+    m_serve_path(source.m_serve_path),
+    m_load_path(source.m_load_path),
+    m_budget(source.m_budget),
+    m_max_batch(source.m_max_batch),
+    m_duration(source.m_duration),
+    m_connections(source.m_connections),
+    m_requests(source.m_requests),
+    m_window(source.m_window)
+{}
+
+// Assignment operator
+BatchDriver& BatchDriver::operator=(const BatchDriver& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_arguments = source.m_arguments;
+    m_input_path = source.m_input_path;
+    m_output_path = source.m_output_path;
+    m_style = source.m_style;
+    m_configuration = source.m_configuration;
+    m_format = source.m_format;
+    m_threads = source.m_threads;
+    m_chunk_size = source.m_chunk_size;
+    m_h = source.m_h;
+    m_cache_size = source.m_cache_size;
+    m_quantum = source.m_quantum;
+    m_surface_path = source.m_surface_path;
+    m_rate_curve_path = source.m_rate_curve_path;
+    m_carry_curve_path = source.m_carry_curve_path;
+    m_buckets = source.m_buckets;
+    m_scenario_path = source.m_scenario_path;
+    m_checkpoint_path = source.m_checkpoint_path;
+    m_checkpoint_interval = source.m_checkpoint_interval;
+    m_resume = source.m_resume;
+    m_reject_path = source.m_reject_path;
+    m_reorder = source.m_reorder;
+    m_run_rows = source.m_run_rows;
+    m_shard_count = source.m_shard_count;
+    m_shard = source.m_shard;
+    m_merge = source.m_merge;
+    m_serve_path = source.m_serve_path;
+    m_load_path = source.m_load_path;
+    m_budget = source.m_budget;
+    m_max_batch = source.m_max_batch;
+    m_duration = source.m_duration;
+    m_connections = source.m_connections;
+    m_requests = source.m_requests;
+    m_window = source.m_window;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to print the command-line usage
+void BatchDriver::PrintUsage(std::ostream& os)
+{
+    os << "Usage: BatchPricer --input <path> --output <path> [options]\n"
+        << "       BatchPricer --serve <socket> [--budget <us>] [--batch <n>] [--duration <s>] [--shock <h>]\n"
+        << "       BatchPricer --load <socket> [--connections <n>] [--requests <n>] [--window <n>] [--style] [--config]\n"
+        << "  --style european|american   Option style of the input file (default: european)\n"
+        << "  --config <configuration>    price, basic, all or a comma-separated list such as Price,Delta,Vega (default: price)\n"
+        << "  --threads <n>               Number of pricing threads (default: hardware concurrency)\n"
+        << "  --chunk <rows>              Number of rows per pipeline block (default: 10000)\n"
+        << "  --format csv|tsv            Output format (default: csv)\n"
+        << "  --shock <h>                 Shock size for numeric sensitivities (default: 1)\n"
+        << "  --cache <entries>           Capacity of the pricing cache, 0 disables it (default: 0)\n"
+        << "  --quantum <q>               Grid spacing of the cache keys, 0 for exact matching (default: 1e-12)\n"
+        << "  --surface <path>            Volatility surface file overriding the input volatilities, European only\n"
+        << "  --rate-curve <path>         Discount curve file overriding the input risk-free rates, European only\n"
+        << "  --carry-curve <path>        Carry curve file overriding the input costs of carry, European only\n"
+        << "  --aggregate <edges>         Net the Greeks of a positions file per underlying and expiry bucket, e.g. 0.25,0.5,1,2,5,\n"
+        << "                              and write the risk report to the output instead of the priced rows\n"
+        << "  --var <path>                Revalue a positions file under the historical shocks of a scenario file and\n"
+        << "                              write the P&L of each scenario to the output, printing VaR and ES\n"
+        << "  --checkpoint <path>         Append a checkpoint record (input offset, rows, output offset) to a file as blocks\n"
+        << "                              are written\n"
+        << "  --checkpoint-every <blocks> Number of blocks between checkpoint records (default: 10)\n"
+        << "  --resume                    Continue an interrupted run from the last record of its --checkpoint file\n"
+        << "  --rejects <path>            Write the rows that fail validation to a file with the reason, instead of only\n"
+        << "                              counting them; the other rows are priced as usual\n"
+        << "  --reorder none|block|global Price in (type, T, r, b, S) order and write the rows in input order: block sorts\n"
+        << "                              each pipeline block in memory (European only), global sorts the whole file\n"
+        << "                              through temporary run files next to the output (default: none)\n"
+        << "  --run <rows>                Number of rows sorted in memory per run of --reorder global (default: 1000000)\n"
+        << "  --shards <n>                Split the input into n byte-range shards priced by n local worker processes,\n"
+        << "                              then merge their outputs in input order and print the timing of every shard\n"
+        << "  --shard <k>                 With --shards, price only shard k as a worker, e.g. on another host sharing the files\n"
+        << "  --merge                     With --shards, only merge the outputs of shards priced by workers started elsewhere\n"
+        << "  --serve <socket>            Serve single-option pricing requests on a Unix-domain socket in micro-batches\n"
+        << "  --budget <us>               Latency budget a request may wait for its batch to fill (default: 500)\n"
+        << "  --batch <n>                 Largest number of requests per micro-batch (default: 256)\n"
+        << "  --duration <s>              Seconds to serve for, 0 to serve until interrupted (default: 0)\n"
+        << "  --load <socket>             Send generated single-option requests to a pricing server and report latency\n"
+        << "  --connections <n>           Concurrent connections of the load generator (default: 4)\n"
+        << "  --requests <n>              Requests per connection of the load generator (default: 10000)\n"
+        << "  --window <n>                Requests in flight per connection of the load generator (default: 1)\n";
+}
+
+// Function to build the European matrix pricer configured by the arguments
+MatrixPricerEuropean BatchDriver::EuropeanPricer(const std::shared_ptr<PricingCache>& cache) const
+{
+    MatrixPricerEuropean pricer(std::vector<EuropeanOption>(), false, m_configuration);
+    pricer.Cache(cache);
+    if (!m_surface_path.empty()) pricer.Surface(std::make_shared<VolSurface>(m_surface_path));
+    pricer.Curves(m_rate_curve_path.empty() ? nullptr : std::make_shared<YieldCurve>(m_rate_curve_path),
+        m_carry_curve_path.empty() ? nullptr : std::make_shared<YieldCurve>(m_carry_curve_path));
+    pricer.Reorder(m_reorder != "none");
+
+    return pricer;
+}
+
+// Function to build the American matrix pricer configured by the arguments
+MatrixPricerAmerican BatchDriver::AmericanPricer(const std::shared_ptr<PricingCache>& cache) const
+{
+    MatrixPricerAmerican pricer(std::vector<AmericanOption>(), false, m_configuration, m_h);
+    pricer.Cache(cache);
+
+    return pricer;
+}
+
+// Function to price one shard as a worker, or to run the local workers and merge the shards
+int BatchDriver::RunShards(const std::shared_ptr<PricingCache>& cache) const
+{
+    auto start = std::chrono::steady_clock::now();
+    ShardPlan plan(m_input_path, m_output_path, m_shard_count);
+
+    if (m_shard >= 0)
+    {
+        // Worker: price the byte range of the shard, the first shard also writes the output header
+        std::size_t k = static_cast<std::size_t>(m_shard);
+        const ShardPlan::Shard& shard = plan.Shards()[k];
+        const std::string reject_path = m_reject_path.empty() ? "" : m_reject_path + ".shard" + std::to_string(k);
+        std::size_t rows = 0, rejected = 0;
+
+        if (m_style == "european")
+        {
+            StreamPricer<MatrixPricerEuropean> stream(EuropeanPricer(cache), m_threads, m_chunk_size, Delimiter());
+            rows = stream.Rejects(reject_path).Run(m_input_path, plan.ShardPath(k), shard.begin, shard.end, k == 0);
+            rejected = stream.Rejected();
+        }
+        else
+        {
+            StreamPricer<MatrixPricerAmerican> stream(AmericanPricer(cache), m_threads, m_chunk_size, Delimiter());
+            rows = stream.Rejects(reject_path).Run(m_input_path, plan.ShardPath(k), shard.begin, shard.end, k == 0);
+            rejected = stream.Rejected();
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        plan.WriteReport(k, rows, seconds);
+        std::cout << "Priced " << rows << " options of shard " << k << " in " << seconds << " s" << std::endl;
+        if (rejected > 0)
+        {
+            std::cout << "Rejected " << rejected << " rows of shard " << k << " that failed validation" << std::endl;
+        }
+
+        return 0;
+    }
+
+    if (!m_merge)
+    {
+        // Coordinator: the workers get the same arguments plus the shard to price
+        std::size_t failures = plan.RunLocal(m_arguments);
+        if (failures > 0)
+        {
+            std::cerr << failures << " of " << m_shard_count << " shard workers failed" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<ShardPlan::Report> reports = plan.Merge();
+    if (!m_reject_path.empty())
+    {
+        plan.Concatenate(m_reject_path);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    unsigned long long rows = 0;
+    for (const auto& report : reports) rows += report.rows;
+
+    ShardPlan::PrintReports(std::cout, reports);
+    std::cout << "Priced " << rows << " options in " << seconds << " s (" << (seconds > 0 ? rows / seconds : 0)
+        << " options/s) using " << m_shard_count << " processes of " << m_threads << " threads" << std::endl;
+
+    return rows > 0 ? 0 : 1;
+}
+
+// Function to run the pricing server
+int BatchDriver::Serve() const
+{
+    PricingServer server(m_serve_path, m_budget, m_max_batch, m_h);
+    server.Start();
+
+    std::signal(SIGINT, Interrupt);
+    std::signal(SIGTERM, Interrupt);
+    std::cout << "Serving on " << m_serve_path << " with a latency budget of " << m_budget << " us" << std::endl;
+
+    // Print the statistics every ten seconds while requests are coming in
+    auto start = std::chrono::steady_clock::now();
+    auto report = start;
+    unsigned long long reported = 0;
+
+    while (!g_interrupted &&
+        (m_duration <= 0 || std::chrono::steady_clock::now() - start < std::chrono::duration<double>(m_duration)))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        if (std::chrono::steady_clock::now() - report >= std::chrono::seconds(10) && server.Stats().requests != reported)
+        {
+            reported = server.Stats().requests;
+            report = std::chrono::steady_clock::now();
+            std::cout << server << std::endl;
+        }
+    }
+
+    server.Stop();
+    std::cout << server << std::endl;
+
+    return 0;
+}
+
+// Function to run the load generator
+int BatchDriver::Load() const
+{
+    bool american = m_style == "american";
+    unsigned int mask = american ? MatrixPricerAmerican::ResolveConfiguration(m_configuration)
+        : MatrixPricerEuropean::ResolveConfiguration(m_configuration);
+
+    LoadGenerator generator(m_load_path, m_connections, m_requests, m_window, mask,
+        american ? PRICING_MODEL_AMERICAN : PRICING_MODEL_EUROPEAN);
+    generator.Run();
+    std::cout << generator << std::endl;
+
+    return generator.Errors() == 0 ? 0 : 1;
+}
+
+// Function to run the batch
+int BatchDriver::Run() const
+{
+    if (!m_serve_path.empty())
+    {
+        return Serve();
+    }
+    if (!m_load_path.empty())
+    {
+        return Load();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::size_t rows = 0, rejected = 0;
+
+    // Rows already written by an interrupted run, counted by the last checkpoint record
+    std::size_t resumed = 0;
+    StreamPricer<MatrixPricerEuropean>::Checkpoint record;
+    if (m_resume && StreamPricer<MatrixPricerEuropean>::ReadCheckpoint(m_checkpoint_path, record))
+    {
+        resumed = static_cast<std::size_t>(record.rows);
+    }
+
+    // Repeated contracts are priced once and then served from the cache
+    std::shared_ptr<PricingCache> cache;
+    if (m_cache_size > 0)
+    {
+        cache = std::make_shared<PricingCache>(m_cache_size, m_quantum);
+    }
+
+    if (m_shard_count > 0)
+    {
+        return RunShards(cache);
+    }
+
+    if (!m_scenario_path.empty())
+    {
+        HistoricalVaR simulation(m_input_path, m_threads);
+        // Every position is priced once per scenario
+        rows = simulation.Run(HistoricalVaR::ReadScenarios(m_scenario_path)).size() * simulation.Size();
+        simulation.WriteCSV(m_output_path);
+        std::cout << simulation << std::endl;
+    }
+    else if (!m_buckets.empty())
+    {
+        RiskAggregator aggregator(m_buckets, m_threads, m_chunk_size);
+        rows = aggregator.Run(m_input_path);
+        aggregator.WriteCSV(m_output_path);
+    }
+    else if (m_style == "european")
+    {
+        MatrixPricerEuropean pricer = EuropeanPricer(cache);
+        if (m_reorder == "global")
+        {
+            ReorderPricer<MatrixPricerEuropean> reorder(pricer, m_threads, m_chunk_size, Delimiter(), m_run_rows);
+            rows = reorder.Rejects(m_reject_path).Run(m_input_path, m_output_path);
+            rejected = reorder.Rejected();
+        }
+        else
+        {
+            StreamPricer<MatrixPricerEuropean> stream(pricer, m_threads, m_chunk_size, Delimiter());
+            rows = stream.Checkpoints(m_checkpoint_path, m_checkpoint_interval).Rejects(m_reject_path)
+                .Run(m_input_path, m_output_path, m_resume);
+            rejected = stream.Rejected();
+        }
+    }
+    else
+    {
+        MatrixPricerAmerican pricer = AmericanPricer(cache);
+        if (m_reorder == "global")
+        {
+            ReorderPricer<MatrixPricerAmerican> reorder(pricer, m_threads, m_chunk_size, Delimiter(), m_run_rows);
+            rows = reorder.Rejects(m_reject_path).Run(m_input_path, m_output_path);
+            rejected = reorder.Rejected();
+        }
+        else
+        {
+            StreamPricer<MatrixPricerAmerican> stream(pricer, m_threads, m_chunk_size, Delimiter());
+            rows = stream.Checkpoints(m_checkpoint_path, m_checkpoint_interval).Rejects(m_reject_path)
+                .Run(m_input_path, m_output_path, m_resume);
+            rejected = stream.Rejected();
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (resumed > 0)
+    {
+        std::cout << "Resumed after " << resumed << " options written by the interrupted run" << std::endl;
+        rows -= resumed;
+    }
+
+    std::cout << "Priced " << rows << " options in " << seconds << " s (" << (seconds > 0 ? rows / seconds : 0)
+        << " options/s) using " << m_threads << " threads" << std::endl;
+
+    if (rejected > 0)
+    {
+        std::cout << "Rejected " << rejected << " rows that failed validation"
+            << (m_reject_path.empty() ? "" : ", written to " + m_reject_path) << std::endl;
+    }
+
+    if (cache)
+    {
+        std::cout << *cache << std::endl;
+    }
+
+    return rows + resumed > 0 ? 0 : 1;
+}
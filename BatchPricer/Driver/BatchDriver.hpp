@@ -0,0 +1,119 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// BatchDriver.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the BatchDriver class
+
+// If BATCHDRIVER_HPP is not defined
+#ifndef BATCHDRIVER_HPP
+// Define BATCHDRIVER_HPP
+#define BATCHDRIVER_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <memory>
+
+#include "../MatrixPricer/MatrixPricerEuropean.hpp"
+#include "../MatrixPricer/MatrixPricerAmerican.hpp"
+
+// Class definition for BatchDriver, the command-line front end of the batch pricers
+class BatchDriver
+{
+private:
+
+    // Command-line arguments, program first, passed on to the worker processes of a sharded run
+    std::vector<std::string> m_arguments;
+
+    // Input CSV file path
+    std::string m_input_path;
+    // Output file path
+    std::string m_output_path;
+    // Option style (european or american)
+    std::string m_style;
+    // Configuration setting ("price", "basic", "all" or a comma-separated list of measures)
+    std::string m_configuration;
+    // Output format (csv or tsv)
+    std::string m_format;
+    // Number of pricing threads
+    int m_threads;
+    // Number of rows per chunk
+    std::size_t m_chunk_size;
+    // Shock size for numeric sensitivities
+    double m_h;
+    // Capacity of the pricing cache in entries, 0 disables it
+    std::size_t m_cache_size;
+    // Grid spacing of the pricing cache keys
+    double m_quantum;
+    // Volatility surface file path, empty to use the volatilities of the input file
+    std::string m_surface_path;
+    // Discount and carry curve file paths, empty to use the rates and costs of carry of the input file
+    std::string m_rate_curve_path;
+    std::string m_carry_curve_path;
+    // Upper edges of the expiry buckets of the risk report, empty to price the rows instead of aggregating them
+    std::vector<double> m_buckets;
+    // Historical shock file path, empty to price the rows instead of simulating the P&L of the book
+    std::string m_scenario_path;
+    // Checkpoint file path, empty to run without checkpoints, and number of blocks between checkpoints
+    std::string m_checkpoint_path;
+    std::size_t m_checkpoint_interval;
+    // Flag to continue an interrupted run from its checkpoint file
+    bool m_resume;
+    // Reject file path for the rows that fail validation, empty to only count them
+    std::string m_reject_path;
+    // Pricing order (none, block or global) and number of rows sorted in memory per run of the global order
+    std::string m_reorder;
+    std::size_t m_run_rows;
+    // Number of shards of a multi-process run, 0 to price in this process
+    std::size_t m_shard_count;
+    // Shard priced by this worker process, -1 to run the workers and merge their outputs
+    long m_shard;
+    // Flag to only merge the outputs of shards priced by workers started elsewhere
+    bool m_merge;
+    // Socket path to serve pricing requests on, empty to price a file
+    std::string m_serve_path;
+    // Socket path of a pricing server to send generated load to, empty to price a file
+    std::string m_load_path;
+    // Latency budget of a served request in microseconds and largest micro-batch
+    double m_budget;
+    std::size_t m_max_batch;
+    // Seconds to serve for, 0 to serve until interrupted
+    double m_duration;
+    // Connections, requests per connection and requests in flight per connection of the load generator
+    std::size_t m_connections;
+    std::size_t m_requests;
+    std::size_t m_window;
+
+    // Function to return the output delimiter for the format
+    char Delimiter() const;
+
+    // Functions to build the matrix pricers configured by the arguments
+    MatrixPricerEuropean EuropeanPricer(const std::shared_ptr<PricingCache>& cache) const;
+    MatrixPricerAmerican AmericanPricer(const std::shared_ptr<PricingCache>& cache) const;
+
+    // Function to price one shard as a worker, or to run the local workers and merge the shards, returns the process exit code
+    int RunShards(const std::shared_ptr<PricingCache>& cache) const;
+
+    // Functions to run the pricing server and the load generator, return the process exit code
+    int Serve() const;
+    int Load() const;
+
+public:
+
+    // Constructor with command-line arguments
+    BatchDriver(const int& argc, char* argv[]);
+
+    // Copy constructor
+    BatchDriver(const BatchDriver& source);
+
+    // Assignment operator
+    BatchDriver& operator=(const BatchDriver& source);
+
+    // Function to print the command-line usage
+    static void PrintUsage(std::ostream& os);
+
+    // Function to run the batch, returns the process exit code
+    int Run() const;
+};
+
+// End of the conditional inclusion of the header file
+#endif
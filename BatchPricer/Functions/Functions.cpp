@@ -5,6 +5,9 @@
 
 #include <iostream>
 #include <vector>
+#include <string>
+#include <string_view>
+#include <charconv>
 #include "Functions.hpp"
 
 // Function to create an array of doubles from start to end with step size h
@@ -17,3 +20,46 @@ std::vector<double> createArray(const double& start, const double& end, const do
     }
     return array;
 }
+
+// Function to split a CSV line in place into at most max_fields views
+std::size_t splitFields(const std::string& line, std::string_view* fields, const std::size_t& max_fields, const char& delimiter)
+{
+    std::size_t count = 0;
+    std::size_t start = 0;
+
+    while (count < max_fields)
+    {
+        std::size_t end = line.find(delimiter, start);
+        fields[count++] = std::string_view(line).substr(start, end == std::string::npos ? std::string::npos : end - start);
+
+        if (end == std::string::npos) break;
+        start = end + 1;
+    }
+
+    return count;
+}
+
+// Function to remove surrounding blanks and carriage returns from a field
+static std::string_view trimField(std::string_view field)
+{
+    while (!field.empty() && (field.front() == ' ' || field.front() == '\t')) field.remove_prefix(1);
+    while (!field.empty() && (field.back() == ' ' || field.back() == '\t' || field.back() == '\r')) field.remove_suffix(1);
+    if (!field.empty() && field.front() == '+') field.remove_prefix(1);
+    return field;
+}
+
+// Function to parse a double field without allocating
+bool parseField(std::string_view field, double& value)
+{
+    field = trimField(field);
+    std::from_chars_result result = std::from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == std::errc() && result.ptr == field.data() + field.size() && !field.empty();
+}
+
+// Function to parse an integer field without allocating
+bool parseField(std::string_view field, int& value)
+{
+    field = trimField(field);
+    std::from_chars_result result = std::from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == std::errc() && result.ptr == field.data() + field.size() && !field.empty();
+}
@@ -9,9 +9,18 @@
 #define FUNCTIONS_HPP
 
 #include <vector>
+#include <string>
+#include <string_view>
 
 // Function to create an array of doubles from start to end with step size h
 std::vector<double> createArray(const double& start, const double& end, const double& h = 2);
 
+// Function to split a CSV line in place into at most max_fields views, returns the number of fields found
+std::size_t splitFields(const std::string& line, std::string_view* fields, const std::size_t& max_fields, const char& delimiter = ',');
+
+// Functions to parse a field without allocating, return false if the field is not a number
+bool parseField(std::string_view field, double& value);
+bool parseField(std::string_view field, int& value);
+
 // End of the conditional inclusion of the header file
 #endif
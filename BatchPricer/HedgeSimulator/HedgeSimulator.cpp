@@ -0,0 +1,425 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// HedgeSimulator.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the templated HedgeSimulator class
+
+// If HEDGESIMULATOR_CPP is not defined
+#ifndef HEDGESIMULATOR_CPP
+// Define HEDGESIMULATOR_CPP
+#define HEDGESIMULATOR_CPP
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+#include "HedgeSimulator.hpp"
+#include "../Options/BlackScholes.hpp"
+#include "../Functions/Functions.hpp"
+
+// Number of paths simulated together, step by step
+static const std::size_t HEDGE_BLOCK = 256;
+
+// Constructor with the option
+inline HedgeKernel<EuropeanOption>::HedgeKernel(const EuropeanOption& option) :
+    m_call(option.type() == "Call"),
+    m_T(option.T()),
+    m_K(option.K()),
+    m_r(option.r()),
+    m_b(option.b()),
+    m_sigma(option.sigma()),
+    m_tau(0),
+    m_sqrt_tau(0),
+    m_carry(1),
+    m_discount(1)
+{
+    Time(0);
+}
+
+// Function to update the time terms to an elapsed time t
+inline void HedgeKernel<EuropeanOption>::Time(const double& t)
+{
+    m_tau = m_T - t;
+
+    if (m_tau > 0)
+    {
+        m_sqrt_tau = std::sqrt(m_tau);
+        m_carry = std::exp((m_b - m_r) * m_tau);
+        m_discount = std::exp(-m_r * m_tau);
+    }
+}
+
+// Function to return the price and the Delta at spot S
+inline void HedgeKernel<EuropeanOption>::Evaluate(const double& S, const double& h, double& price, double& delta) const
+{
+    // At expiry the option is worth its payoff
+    if (m_tau <= 0)
+    {
+        price = Payoff(S);
+        delta = m_call ? (S > m_K ? 1.0 : 0.0) : (S < m_K ? -1.0 : 0.0);
+        return;
+    }
+
+    if (h > 0)
+    {
+        double up = 0, down = 0, unused = 0;
+        Evaluate(S + h, 0, up, unused);
+        Evaluate(S - h, 0, down, unused);
+        Evaluate(S, 0, price, unused);
+        delta = (up - down) / (2 * h);
+        return;
+    }
+
+    // Only d1, d2 and their normal probabilities depend on the spot, the factors of the remaining time come from Time()
+    const BlackScholesTerms<double> x = BlackScholesEvaluate(m_tau, m_K, S, m_r, m_sigma, m_b, m_sqrt_tau, m_carry, m_discount,
+        BLACKSCHOLES_N_D1 | BLACKSCHOLES_N_D2);
+
+    price = BlackScholesPrice(m_call, x);
+    delta = BlackScholesDelta(m_call, x);
+}
+
+// Function to return the price at spot S
+inline double HedgeKernel<AmericanOption>::Value(const double& S)
+{
+    return Exercised(S) ? Payoff(S) : m_option.S(S).Price();
+}
+
+// Constructor with the option
+inline HedgeKernel<AmericanOption>::HedgeKernel(const AmericanOption& option) :
+    m_call(option.type() == "Call"),
+    m_K(option.K()),
+    m_boundary(option.ExerciseBoundary()),
+    m_option(option)
+{}
+
+// Function to return the price and the Delta at spot S
+inline void HedgeKernel<AmericanOption>::Evaluate(const double& S, const double& h, double& price, double& delta)
+{
+    constexpr unsigned int measures = AmericanOption::MEASURE_PRICE | AmericanOption::MEASURE_DELTA;
+
+    if (h > 0 || Exercised(S))
+    {
+        price = Value(S);
+        delta = h > 0 ? (Value(S + h) - Value(S - h)) / (2 * h) : (m_call ? 1.0 : -1.0);
+        return;
+    }
+
+    // The price and the analytic Delta share one evaluation of the perpetual formula
+    double values[2];
+    m_option.S(S).Measures<measures>(measures, 0, values);
+    price = values[0];
+    delta = values[1];
+}
+
+// Function run by each thread: simulates the blocks of paths it claims
+template <typename OptionType>
+void HedgeSimulator<OptionType>::SimulateStage(std::atomic<std::size_t>& next_block)
+{
+    for (;;)
+    {
+        std::size_t first = next_block.fetch_add(HEDGE_BLOCK, std::memory_order_relaxed);
+        if (first >= m_pnl.size())
+        {
+            return;
+        }
+
+        SimulateBlock(first, std::min(first + HEDGE_BLOCK, m_pnl.size()));
+    }
+}
+
+// Function to simulate the paths [first, last)
+template <typename OptionType>
+void HedgeSimulator<OptionType>::SimulateBlock(const std::size_t& first, const std::size_t& last)
+{
+    const std::size_t n = last - first;
+    const double dt = m_horizon / m_steps;
+    const double growth = std::exp(m_option.r() * dt);
+    const double dividend = std::exp((m_option.r() - m_option.b()) * dt) - 1;
+    const double shift = (m_drift - m_volatility * m_volatility / 2) * dt;
+    const double scale = m_volatility * std::sqrt(dt);
+    const bool generated = m_paths.empty();
+
+    HedgeKernel<OptionType> kernel(m_option);
+    std::vector<double> S(n), delta(n), cash(n);
+    std::vector<char> open(n, 1);
+
+    // One generator per path, seeded by the path number
+    std::vector<std::mt19937_64> generators;
+    std::vector<std::normal_distribution<double>> normals(generated ? n : 0);
+    for (std::size_t i = 0; generated && i < n; ++i)
+    {
+        std::seed_seq seed{ m_seed, static_cast<unsigned long long>(first + i) };
+        generators.emplace_back(seed);
+    }
+
+    // Sell the option and buy the initial hedge
+    double price = 0, hedge = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        S[i] = generated ? m_option.S() : m_paths[first + i][0];
+        kernel.Evaluate(S[i], m_h, price, hedge);
+        delta[i] = hedge;
+        cash[i] = price - hedge * S[i];
+    }
+
+    for (std::size_t k = 1; k <= m_steps; ++k)
+    {
+        // The time terms are shared by every path of the block
+        kernel.Time(k * dt);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            // Cash accrues interest and the hedge earns the dividend yield
+            cash[i] = cash[i] * growth + delta[i] * S[i] * dividend;
+
+            if (!open[i])
+            {
+                continue;
+            }
+
+            S[i] = generated ? S[i] * std::exp(shift + scale * normals[i](generators[i])) : m_paths[first + i][k];
+
+            // The holder of an American option exercises on reaching the boundary, the position is then closed
+            if (kernel.Exercised(S[i]))
+            {
+                cash[i] += delta[i] * S[i] - kernel.Payoff(S[i]);
+                delta[i] = 0;
+                open[i] = 0;
+                continue;
+            }
+
+            kernel.Evaluate(S[i], m_h, price, hedge);
+
+            if (k == m_steps)
+            {
+                // Close the hedge and buy the option back at the end of the backtest
+                cash[i] += delta[i] * S[i] - price;
+                delta[i] = 0;
+            }
+            else
+            {
+                cash[i] -= (hedge - delta[i]) * S[i];
+                delta[i] = hedge;
+            }
+        }
+    }
+
+    std::copy(cash.begin(), cash.end(), m_pnl.begin() + first);
+}
+
+// Constructor with the option, the horizon, the number of rebalancing steps and the number of threads
+template <typename OptionType>
+HedgeSimulator<OptionType>::HedgeSimulator(const OptionType& option, const double& horizon, const std::size_t& steps,
+    const int& threads) :
+    m_option(option),
+    m_horizon(horizon),
+    m_steps(steps),
+    m_threads(std::max(threads, 1)),
+    m_h(0),
+    m_path_count(0),
+    m_drift(option.r()),
+    m_volatility(option.sigma()),
+    m_seed(1)
+{
+    if (!(horizon > 0) || steps == 0)
+    {
+        throw std::invalid_argument("The hedging horizon and the number of steps must be positive");
+    }
+    if (horizon > HedgeKernel<OptionType>(option).Maturity())
+    {
+        throw std::invalid_argument("The hedging horizon must not go beyond the expiry of the option");
+    }
+}
+
+// Copy constructor
+template <typename OptionType>
+HedgeSimulator<OptionType>::HedgeSimulator(const HedgeSimulator& source) :
+    m_option(source.m_option),
+    m_horizon(source.m_horizon),
+    m_steps(source.m_steps),
+    m_threads(source.m_threads),
+    m_h(source.m_h),
+    m_paths(source.m_paths),
+    m_path_count(source.m_path_count),
+    m_drift(source.m_drift),
+    m_volatility(source.m_volatility),
+    m_seed(source.m_seed),
+    m_pnl(source.m_pnl)
+{}
+
+// Assignment operator
+template <typename OptionType>
+HedgeSimulator<OptionType>& HedgeSimulator<OptionType>::operator=(const HedgeSimulator& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_option = source.m_option;
+    m_horizon = source.m_horizon;
+    m_steps = source.m_steps;
+    m_threads = source.m_threads;
+    m_h = source.m_h;
+    m_paths = source.m_paths;
+    m_path_count = source.m_path_count;
+    m_drift = source.m_drift;
+    m_volatility = source.m_volatility;
+    m_seed = source.m_seed;
+    m_pnl = source.m_pnl;
+
+    return *this;
+}
+
+// Function to generate paths of geometric Brownian motion
+template <typename OptionType>
+HedgeSimulator<OptionType>& HedgeSimulator<OptionType>::Generate(const std::size_t& paths, const double& drift,
+    const double& volatility, const unsigned long long& seed)
+{
+    if (volatility < 0)
+    {
+        throw std::invalid_argument("The volatility of the paths must not be negative");
+    }
+
+    m_paths.clear();
+    m_path_count = paths;
+    m_drift = drift;
+    m_volatility = volatility;
+    m_seed = seed;
+
+    return *this;
+}
+
+// Function to read paths from a file
+template <typename OptionType>
+HedgeSimulator<OptionType>& HedgeSimulator<OptionType>::Load(const std::string& input_path)
+{
+    std::ifstream file(input_path);
+    if (!file)
+    {
+        throw std::invalid_argument("Unable to open path file: " + input_path);
+    }
+
+    std::vector<std::vector<double>> paths;
+    std::vector<std::string_view> fields(m_steps + 2);
+    std::string line;
+
+    // Skip the header row
+    std::getline(file, line);
+
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line == "\r")
+        {
+            continue;
+        }
+
+        // Every path has an id and one spot per step, the initial spot included
+        std::vector<double> path(m_steps + 1);
+        bool valid = splitFields(line, fields.data(), fields.size()) == fields.size() &&
+            line.find(',', fields.back().data() - line.data()) == std::string::npos;
+
+        for (std::size_t k = 0; valid && k <= m_steps; ++k)
+        {
+            valid = parseField(fields[k + 1], path[k]) && path[k] > 0;
+        }
+
+        if (!valid)
+        {
+            throw std::invalid_argument("Path rows need an id and " + std::to_string(m_steps + 1) + " positive spots: " + line);
+        }
+
+        paths.push_back(path);
+    }
+
+    m_paths = paths;
+    m_path_count = m_paths.size();
+
+    return *this;
+}
+
+// Function to hedge with the numeric Delta of step h
+template <typename OptionType>
+HedgeSimulator<OptionType>& HedgeSimulator<OptionType>::NumericDelta(const double& h)
+{
+    if (h < 0)
+    {
+        throw std::invalid_argument("The step of the numeric Delta must not be negative");
+    }
+
+    m_h = h;
+    return *this;
+}
+
+// Function to run the backtest
+template <typename OptionType>
+const std::vector<double>& HedgeSimulator<OptionType>::Run()
+{
+    m_pnl.assign(m_path_count, 0);
+
+    std::atomic<std::size_t> next_block(0);
+    std::vector<std::thread> workers;
+
+    for (int t = 1; t < m_threads; ++t)
+    {
+        workers.emplace_back(&HedgeSimulator::SimulateStage, this, std::ref(next_block));
+    }
+    SimulateStage(next_block);
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    return m_pnl;
+}
+
+// Function to return the statistics of the hedging P&L of the last run
+template <typename OptionType>
+HedgeStatistics HedgeSimulator<OptionType>::Summary() const
+{
+    HedgeStatistics stats{ m_pnl.size(), 0, 0, 0, 0, 0, 0 };
+    if (m_pnl.empty())
+    {
+        return stats;
+    }
+
+    std::vector<double> sorted(m_pnl);
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0, squares = 0;
+    for (const auto& pnl : sorted)
+    {
+        sum += pnl;
+    }
+    stats.mean = sum / sorted.size();
+    for (const auto& pnl : sorted)
+    {
+        squares += (pnl - stats.mean) * (pnl - stats.mean);
+    }
+
+    stats.stddev = sorted.size() > 1 ? std::sqrt(squares / (sorted.size() - 1)) : 0;
+    stats.min = sorted.front();
+    stats.max = sorted.back();
+    stats.q05 = sorted[static_cast<std::size_t>(0.05 * (sorted.size() - 1))];
+    stats.q95 = sorted[static_cast<std::size_t>(0.95 * (sorted.size() - 1))];
+
+    return stats;
+}
+
+// Overloaded stream insertion operator for the statistics
+inline std::ostream& operator<<(std::ostream& os, const HedgeStatistics& stats)
+{
+    os << "Hedging P&L over " << stats.paths << " paths, Mean: " << stats.mean << ", Standard deviation: " << stats.stddev
+        << ", Min: " << stats.min << ", 5%: " << stats.q05 << ", 95%: " << stats.q95 << ", Max: " << stats.max;
+
+    return os;
+}
+
+// End of the conditional inclusion of the header file
+#endif
@@ -0,0 +1,178 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// HedgeSimulator.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the templated HedgeSimulator class
+
+// If HEDGESIMULATOR_HPP is not defined
+#ifndef HEDGESIMULATOR_HPP
+// Define HEDGESIMULATOR_HPP
+#define HEDGESIMULATOR_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <ostream>
+#include <atomic>
+#include <limits>
+#include <algorithm>
+
+#include "../Options/EuropeanOption.hpp"
+#include "../Options/AmericanOption.hpp"
+
+// Incremental pricer of an option along a path, in which only the spot and the elapsed time change. Everything that
+// depends on neither is computed once on construction, everything that depends on time only is computed once per
+// step by Time() and shared by all the paths, and Evaluate() then only does the work that depends on the spot.
+// Evaluate() calls the formulas of the option class, the Black-Scholes kernels for a European option and the
+// perpetual formula of AmericanOption, with central differences of the price when h is positive.
+template <typename OptionType>
+class HedgeKernel;
+
+// Incremental pricer of a European option
+template <>
+class HedgeKernel<EuropeanOption>
+{
+private:
+
+    bool m_call;
+    double m_T, m_K, m_r, m_b, m_sigma; // Invariants
+    double m_tau, m_sqrt_tau, m_carry, m_discount; // Time terms of the current step
+
+public:
+
+    // Constructor with the option
+    HedgeKernel(const EuropeanOption& option);
+
+    // Function to return the time at which the option expires
+    double Maturity() const { return m_T; }
+
+    // Function to update the time terms to an elapsed time t
+    void Time(const double& t);
+
+    // Function to return the price and the Delta at spot S, with central differences of step h when h is positive
+    void Evaluate(const double& S, const double& h, double& price, double& delta) const;
+
+    // Function to return whether the holder exercises at spot S, never before expiry for a European option
+    bool Exercised(const double&) const { return false; }
+
+    // Function to return the exercise value at spot S
+    double Payoff(const double& S) const { return m_call ? std::max(S - m_K, 0.0) : std::max(m_K - S, 0.0); }
+};
+
+// Incremental pricer of an American perpetual option, which does not depend on time at all
+template <>
+class HedgeKernel<AmericanOption>
+{
+private:
+
+    bool m_call;
+    double m_K, m_boundary; // Strike and optimal exercise boundary
+    AmericanOption m_option; // Option repriced at each spot
+
+    // Function to return the price at spot S, the payoff at or beyond the exercise boundary
+    double Value(const double& S);
+
+public:
+
+    // Constructor with the option
+    HedgeKernel(const AmericanOption& option);
+
+    // Function to return the time at which the option expires
+    double Maturity() const { return std::numeric_limits<double>::infinity(); }
+
+    // Function to update the time terms, a perpetual option has none
+    void Time(const double&) {}
+
+    // Function to return the price and the Delta at spot S, with central differences of step h when h is positive
+    void Evaluate(const double& S, const double& h, double& price, double& delta);
+
+    // Function to return whether the holder exercises at spot S, on reaching the optimal exercise boundary
+    bool Exercised(const double& S) const { return m_call ? S >= m_boundary : S <= m_boundary; }
+
+    // Function to return the exercise value at spot S
+    double Payoff(const double& S) const { return m_call ? std::max(S - m_K, 0.0) : std::max(m_K - S, 0.0); }
+};
+
+// Statistics of the hedging P&L across paths
+struct HedgeStatistics
+{
+    std::size_t paths;
+    double mean;
+    double stddev;
+    double min;
+    double max;
+    double q05; // 5% quantile
+    double q95; // 95% quantile
+};
+
+// Overloaded stream insertion operator for the statistics
+inline std::ostream& operator<<(std::ostream& os, const HedgeStatistics& stats);
+
+// Define the HedgeSimulator class, a backtest of delta hedging a short option position along spot paths, read from
+// a file or generated as geometric Brownian motion. At every rebalance the option is repriced and the hedge in the
+// underlying is reset to its Delta, the cash account accrues at the risk-free rate and the hedge pays the dividend
+// yield r - b. The hedging P&L of a path is the final cash plus the hedge minus the value of the option. Paths are
+// processed in blocks, step by step across the block, so the time terms of each step are computed once per block,
+// and the blocks are shared out between threads. Generated paths draw from one seeded generator each, so the P&L of
+// every path is the same for any number of threads.
+template <typename OptionType>
+class HedgeSimulator
+{
+private:
+
+    OptionType m_option; // Option sold and hedged
+    double m_horizon; // Length of the backtest in years
+    std::size_t m_steps; // Number of rebalancing steps
+    int m_threads; // Number of simulation threads
+    double m_h; // Step of the numeric Delta, 0 for the analytic Delta
+
+    std::vector<std::vector<double>> m_paths; // Spot paths read from a file, empty for generated paths
+    std::size_t m_path_count; // Number of generated paths
+    double m_drift; // Drift of the generated paths
+    double m_volatility; // Volatility of the generated paths
+    unsigned long long m_seed; // Seed of the generated paths
+
+    std::vector<double> m_pnl; // Hedging P&L of each path of the last run
+
+    // Function run by each thread: simulates the blocks of paths it claims
+    void SimulateStage(std::atomic<std::size_t>& next_block);
+
+    // Function to simulate the paths [first, last)
+    void SimulateBlock(const std::size_t& first, const std::size_t& last);
+
+public:
+
+    // Constructor with the option, the horizon, the number of rebalancing steps and the number of threads
+    HedgeSimulator(const OptionType& option, const double& horizon, const std::size_t& steps, const int& threads = 1);
+
+    // Copy constructor
+    HedgeSimulator(const HedgeSimulator& source);
+
+    // Assignment operator
+    HedgeSimulator& operator=(const HedgeSimulator& source);
+
+    // Function to generate paths of geometric Brownian motion with a drift and a volatility
+    HedgeSimulator& Generate(const std::size_t& paths, const double& drift, const double& volatility,
+        const unsigned long long& seed = 1);
+
+    // Function to read paths from a file: a header row followed by one row "id,S0,S1,...,Sn" per path, n being the
+    // number of steps
+    HedgeSimulator& Load(const std::string& input_path);
+
+    // Function to hedge with the numeric Delta of step h instead of the analytic Delta, 0 to return to the analytic one
+    HedgeSimulator& NumericDelta(const double& h);
+
+    // Function to run the backtest, returns the hedging P&L of each path
+    const std::vector<double>& Run();
+
+    // Function to return the statistics of the hedging P&L of the last run
+    HedgeStatistics Summary() const;
+};
+
+// Must be the same name as in source file #define
+#ifndef HEDGESIMULATOR_CPP
+#include "HedgeSimulator.cpp"
+#endif
+// It includes the contents of HedgeSimulator.cpp in the header file of HEDGESIMULATOR_CPP is not already defined
+
+// End of the conditional inclusion of the header file
+#endif
@@ -0,0 +1,314 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// HistoricalVaR.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the HistoricalVaR class
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+#include "HistoricalVaR.hpp"
+#include "../Options/BlackScholes.hpp"
+#include "../RiskAggregator/RiskAggregator.hpp"
+#include "../Functions/Functions.hpp"
+
+// Number of scenarios per tile
+static const std::size_t SCENARIO_TILE = 32;
+
+// Function to load the positions into columns and price them unshocked
+void HistoricalVaR::Load(const std::vector<EuropeanOption>& positions, const std::vector<double>& quantities)
+{
+    if (positions.size() != quantities.size())
+    {
+        throw std::invalid_argument("The book needs one quantity per position");
+    }
+
+    for (std::size_t i = 0; i < positions.size(); ++i)
+    {
+        const EuropeanOption& option = positions[i];
+
+        m_call.push_back(option.type() == "Call");
+        m_T.push_back(option.T());
+        m_K.push_back(option.K());
+        m_S.push_back(option.S());
+        m_r.push_back(option.r());
+        m_sigma.push_back(option.sigma());
+        m_b.push_back(option.b());
+        m_quantity.push_back(quantities[i]);
+        m_base.push_back(BlackScholesPrice<double>(m_call.back(), option.T(), option.K(), option.S(), option.r(),
+            option.sigma(), option.b()));
+    }
+}
+
+// Function run by each thread: revalues the scenario tiles it claims against every position tile
+void HistoricalVaR::RevalueStage(std::atomic<std::size_t>& next_tile)
+{
+    const std::size_t positions = m_quantity.size();
+
+    for (;;)
+    {
+        std::size_t first = next_tile.fetch_add(SCENARIO_TILE, std::memory_order_relaxed);
+        if (first >= m_scenarios.size())
+        {
+            return;
+        }
+        std::size_t last = std::min(first + SCENARIO_TILE, m_scenarios.size());
+
+        // The position tile stays in cache while the scenarios of the tile are applied to it
+        for (std::size_t p0 = 0; p0 < positions; p0 += m_tile)
+        {
+            std::size_t p1 = std::min(p0 + m_tile, positions);
+
+            for (std::size_t k = first; k < last; ++k)
+            {
+                const Scenario& scenario = m_scenarios[k];
+                double pnl = 0;
+
+                for (std::size_t i = p0; i < p1; ++i)
+                {
+                    // Volatilities are kept positive under large negative shifts
+                    double sigma = std::max(m_sigma[i] + scenario.vol, 1e-4);
+                    double price = BlackScholesPrice<double>(m_call[i] != 0, m_T[i], m_K[i], m_S[i] * (1 + scenario.spot),
+                        m_r[i] + scenario.rate, sigma, m_b[i] + scenario.rate);
+                    pnl += m_quantity[i] * (price - m_base[i]);
+                }
+
+                m_pnl[k] += pnl;
+            }
+        }
+    }
+}
+
+// Constructor with the options of the book and their quantities
+HistoricalVaR::HistoricalVaR(const std::vector<EuropeanOption>& positions, const std::vector<double>& quantities,
+    const int& threads, const std::size_t& tile) :
+    m_threads(std::max(threads, 1)),
+    m_tile(std::max<std::size_t>(tile, 1))
+{
+    Load(positions, quantities);
+}
+
+// Constructor with the path of a positions file
+HistoricalVaR::HistoricalVaR(const std::string& positions_path, const int& threads, const std::size_t& tile) :
+    m_threads(std::max(threads, 1)),
+    m_tile(std::max<std::size_t>(tile, 1))
+{
+    std::ifstream file(positions_path);
+    if (!file)
+    {
+        throw std::invalid_argument("Unable to open positions file: " + positions_path);
+    }
+
+    std::vector<EuropeanOption> positions;
+    std::vector<double> quantities;
+    std::string line, underlying;
+    double quantity = 0;
+
+    // Skip the header row
+    std::getline(file, line);
+
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line == "\r")
+        {
+            continue;
+        }
+
+        positions.push_back(RiskAggregator::ParsePosition(line, quantity, underlying));
+        quantities.push_back(quantity);
+    }
+
+    Load(positions, quantities);
+}
+
+// Copy constructor
+HistoricalVaR::HistoricalVaR(const HistoricalVaR& source) :
+    m_call(source.m_call),
+    m_T(source.m_T),
+    m_K(source.m_K),
+    m_S(source.m_S),
+    m_r(source.m_r),
+    m_sigma(source.m_sigma),
+    m_b(source.m_b),
+    m_quantity(source.m_quantity),
+    m_base(source.m_base),
+    m_threads(source.m_threads),
+    m_tile(source.m_tile),
+    m_scenarios(source.m_scenarios),
+    m_pnl(source.m_pnl)
+{}
+
+// Assignment operator
+HistoricalVaR& HistoricalVaR::operator=(const HistoricalVaR& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_call = source.m_call;
+    m_T = source.m_T;
+    m_K = source.m_K;
+    m_S = source.m_S;
+    m_r = source.m_r;
+    m_sigma = source.m_sigma;
+    m_b = source.m_b;
+    m_quantity = source.m_quantity;
+    m_base = source.m_base;
+    m_threads = source.m_threads;
+    m_tile = source.m_tile;
+    m_scenarios = source.m_scenarios;
+    m_pnl = source.m_pnl;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to read a file of shock vectors
+std::vector<HistoricalVaR::Scenario> HistoricalVaR::ReadScenarios(const std::string& input_path)
+{
+    std::ifstream file(input_path);
+    if (!file)
+    {
+        throw std::invalid_argument("Unable to open scenario file: " + input_path);
+    }
+
+    std::vector<Scenario> scenarios;
+    std::string_view fields[4];
+    std::string line;
+
+    // Skip the header row
+    std::getline(file, line);
+
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line == "\r")
+        {
+            continue;
+        }
+
+        Scenario scenario{};
+        if (splitFields(line, fields, 4) != 4 || !parseField(fields[0], scenario.id) || !parseField(fields[1], scenario.spot) ||
+            !parseField(fields[2], scenario.vol) || !parseField(fields[3], scenario.rate))
+        {
+            throw std::invalid_argument("Malformed scenario row: " + line);
+        }
+
+        scenarios.push_back(scenario);
+    }
+
+    return scenarios;
+}
+
+// Function to revalue the book under every scenario
+const std::vector<double>& HistoricalVaR::Run(const std::vector<Scenario>& scenarios)
+{
+    m_scenarios = scenarios;
+    m_pnl.assign(scenarios.size(), 0);
+
+    std::atomic<std::size_t> next_tile(0);
+    std::vector<std::thread> workers;
+
+    for (int t = 1; t < m_threads; ++t)
+    {
+        workers.emplace_back(&HistoricalVaR::RevalueStage, this, std::ref(next_tile));
+    }
+    RevalueStage(next_tile);
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    return m_pnl;
+}
+
+// Function to return the unshocked value of the book
+double HistoricalVaR::Value() const
+{
+    double value = 0;
+
+    for (std::size_t i = 0; i < m_base.size(); ++i)
+    {
+        value += m_quantity[i] * m_base[i];
+    }
+
+    return value;
+}
+
+// Function to return the Value at Risk at a confidence level
+double HistoricalVaR::VaR(const double& confidence) const
+{
+    if (m_pnl.empty() || !(confidence > 0 && confidence < 1))
+    {
+        throw std::invalid_argument("VaR needs a run with scenarios and a confidence level between 0 and 1");
+    }
+
+    // The VaR is the loss of the m-th worst scenario, m being the number of scenarios in the tail
+    std::size_t m = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(m_pnl.size() * (1 - confidence) - 1e-9)));
+    std::vector<double> pnl(m_pnl);
+    std::nth_element(pnl.begin(), pnl.begin() + (m - 1), pnl.end());
+
+    return -pnl[m - 1];
+}
+
+// Function to return the Expected Shortfall at a confidence level
+double HistoricalVaR::ExpectedShortfall(const double& confidence) const
+{
+    if (m_pnl.empty() || !(confidence > 0 && confidence < 1))
+    {
+        throw std::invalid_argument("Expected Shortfall needs a run with scenarios and a confidence level between 0 and 1");
+    }
+
+    std::size_t m = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(m_pnl.size() * (1 - confidence) - 1e-9)));
+    std::vector<double> pnl(m_pnl);
+    std::partial_sort(pnl.begin(), pnl.begin() + m, pnl.end());
+
+    double tail = 0;
+    for (std::size_t k = 0; k < m; ++k)
+    {
+        tail += pnl[k];
+    }
+
+    return -tail / m;
+}
+
+// Function to write the P&L of each scenario of the last run to a CSV file
+void HistoricalVaR::WriteCSV(const std::string& output_path) const
+{
+    std::ofstream file(output_path);
+    if (!file.is_open())
+    {
+        std::cerr << "Unable to open file: " << output_path << std::endl;
+        return;
+    }
+
+    file << "Scenario,PnL\n";
+    for (std::size_t k = 0; k < m_pnl.size(); ++k)
+    {
+        file << m_scenarios[k].id << "," << std::to_string(m_pnl[k]) << "\n";
+    }
+
+    file.close();
+}
+
+// Overloaded stream insertion operator
+std::ostream& operator<<(std::ostream& os, const HistoricalVaR& simulation)
+{
+    os << "Book value: " << simulation.Value() << ", " << simulation.m_quantity.size() << " positions, "
+        << simulation.m_pnl.size() << " scenarios";
+
+    if (!simulation.m_pnl.empty())
+    {
+        os << ", VaR 95%: " << simulation.VaR(0.95) << ", ES 95%: " << simulation.ExpectedShortfall(0.95)
+            << ", VaR 99%: " << simulation.VaR(0.99) << ", ES 99%: " << simulation.ExpectedShortfall(0.99);
+    }
+
+    return os;
+}
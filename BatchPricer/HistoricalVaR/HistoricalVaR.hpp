@@ -0,0 +1,98 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// HistoricalVaR.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the HistoricalVaR class
+
+// If HISTORICALVAR_HPP is not defined
+#ifndef HISTORICALVAR_HPP
+// Define HISTORICALVAR_HPP
+#define HISTORICALVAR_HPP
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <atomic>
+
+#include "../Options/EuropeanOption.hpp"
+
+// Class definition for HistoricalVaR, a full-revaluation historical simulation of a book of European option positions.
+// Every position is repriced under every historical shock vector (a relative spot move, an absolute volatility shift
+// and an absolute rate shift, the rate shift also moving the cost of carry) and the quantity-weighted change in value
+// gives one P&L per scenario, from which the Value at Risk and the Expected Shortfall are read. The scenario x position
+// matrix is evaluated in tiles: a tile of positions is held in contiguous columns that stay in cache while a tile of
+// scenarios streams through it, and the scenario tiles are shared out between threads. Each scenario is summed by one
+// thread in position order, so the P&L vector does not depend on the number of threads.
+class HistoricalVaR
+{
+public:
+
+    // Historical shock vector applied to every position
+    struct Scenario
+    {
+        int id;
+        double spot; // Relative spot move dS / S
+        double vol; // Absolute volatility shift
+        double rate; // Absolute shift of the risk-free rate and the cost of carry
+    };
+
+private:
+
+    // Positions in columns
+    std::vector<char> m_call;
+    std::vector<double> m_T, m_K, m_S, m_r, m_sigma, m_b;
+    std::vector<double> m_quantity;
+    std::vector<double> m_base; // Unshocked price of each position
+
+    int m_threads; // Number of pricing threads
+    std::size_t m_tile; // Number of positions per tile
+    std::vector<Scenario> m_scenarios; // Scenarios of the last run
+    std::vector<double> m_pnl; // P&L of each scenario of the last run
+
+    // Function to load the positions into columns and price them unshocked
+    void Load(const std::vector<EuropeanOption>& positions, const std::vector<double>& quantities);
+
+    // Function run by each thread: revalues the scenario tiles it claims against every position tile
+    void RevalueStage(std::atomic<std::size_t>& next_tile);
+
+public:
+
+    // Constructor with the options of the book and their quantities
+    HistoricalVaR(const std::vector<EuropeanOption>& positions, const std::vector<double>& quantities, const int& threads = 1,
+        const std::size_t& tile = 256);
+
+    // Constructor with the path of a positions file (European batch schema with quantity and underlying columns)
+    HistoricalVaR(const std::string& positions_path, const int& threads = 1, const std::size_t& tile = 256);
+
+    // Copy constructor
+    HistoricalVaR(const HistoricalVaR& source);
+
+    // Assignment operator
+    HistoricalVaR& operator=(const HistoricalVaR& source);
+
+    // Function to read a file of shock vectors, one row "id,dS/S,dsigma,dr" per scenario after a header row
+    static std::vector<Scenario> ReadScenarios(const std::string& input_path);
+
+    // Function to revalue the book under every scenario, returns the P&L of each scenario
+    const std::vector<double>& Run(const std::vector<Scenario>& scenarios);
+
+    // Function to return the number of positions in the book
+    std::size_t Size() const { return m_quantity.size(); }
+
+    // Function to return the unshocked value of the book
+    double Value() const;
+
+    // Function to return the Value at Risk at a confidence level, as a positive loss
+    double VaR(const double& confidence) const;
+
+    // Function to return the Expected Shortfall at a confidence level, the average loss of the scenarios beyond the VaR
+    double ExpectedShortfall(const double& confidence) const;
+
+    // Function to write the P&L of each scenario of the last run to a CSV file
+    void WriteCSV(const std::string& output_path) const;
+
+    // Overloaded stream insertion operator
+    friend std::ostream& operator<<(std::ostream& os, const HistoricalVaR& simulation);
+};
+
+// End of the conditional inclusion of the header file
+#endif
@@ -8,9 +8,15 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+#include <cmath>
+#include <cstring>
 
-#include "MatrixPricerAmerican.hpp""
+#include "MatrixPricerAmerican.hpp"
 #include "../Options/AmericanOption.hpp"
+#include "../Functions/Functions.hpp"
 
 
 // Function to write data to a CSV file
@@ -20,14 +26,7 @@ void MatrixPricerAmerican::WriteCSV(const std::string& output_path, const std::v
 
     if (file.is_open())
     {
-        if (m_configuration == "price")
-        {
-            file << "Option,Type,K,S,r,sigma,b,Price\n";
-        }
-        else if (m_configuration == "all")
-        {
-            file << "Option,Type,K,S,r,sigma,b,Price,NumericDelta, NumericGamma\n";
-        }
+        file << Header() << "\n";
 
         // Write data
         for (const auto& row : output_matrix)
@@ -52,21 +51,170 @@ void MatrixPricerAmerican::WriteCSV(const std::string& output_path, const std::v
 
 }
 
+// Names of the measures, indexed by the bit position of their AmericanOption::MeasureFlag
+static const char* const MEASURE_NAMES[AmericanOption::MEASURE_COUNT] =
+{
+    "Price", "NumericDelta", "NumericGamma", "Delta", "Gamma", "Vega", "Rho", "CarryRho"
+};
+
+// Function to evaluate the measures of an option through the cache when there is one
+template <unsigned int Mask>
+int MatrixPricerAmerican::CachedMeasures(const AmericanOption& option, const double& h, double* values) const
+{
+    PricingCache::Key key;
+
+    if (!m_cache || !m_cache->MakeKey(option, m_mask, (m_mask & (AmericanOption::MEASURE_NUMERIC_DELTA | AmericanOption::MEASURE_NUMERIC_GAMMA)) != 0 ? h : 0, key))
+    {
+        return option.Measures<Mask>(m_mask, h, values);
+    }
+
+    int n = 0;
+    if (!m_cache->Find(key, values, n))
+    {
+        n = option.Measures<Mask>(m_mask, h, values);
+        m_cache->Insert(key, values, n);
+    }
+
+    return n;
+}
+
+// Function to evaluate the configured measures of an option
+int MatrixPricerAmerican::Evaluate(const AmericanOption& option, const double& h, double* values) const
+{
+    switch (m_mask)
+    {
+    case AmericanOption::MEASURE_CONFIG_PRICE:
+        return CachedMeasures<AmericanOption::MEASURE_CONFIG_PRICE>(option, h, values);
+    case AmericanOption::MEASURE_CONFIG_BASIC:
+        return CachedMeasures<AmericanOption::MEASURE_CONFIG_BASIC>(option, h, values);
+    default:
+        // "all" and custom subsets share the full kernel, which skips unselected measures and the
+        // intermediates only they need at run time
+        return CachedMeasures<AmericanOption::MEASURE_CONFIG_ALL>(option, h, values);
+    }
+}
+
+// Function to append an option and its measure values to an arena
+void MatrixPricerAmerican::FormatRow(const AmericanOption& option, const double* values, const int& n, Arena& arena,
+    const char& delimiter) const
+{
+    arena.Append(option.id());
+    arena.Append(delimiter);
+    arena.Append(option.type());
+    arena.Append(delimiter);
+    arena.Append(option.K());
+    arena.Append(delimiter);
+    arena.Append(option.S());
+    arena.Append(delimiter);
+    arena.Append(option.r());
+    arena.Append(delimiter);
+    arena.Append(option.sigma());
+    arena.Append(delimiter);
+    arena.Append(option.b());
+
+    for (int i = 0; i < n; ++i)
+    {
+        arena.Append(delimiter);
+        arena.Append(values[i]);
+    }
+
+    arena.Append('\n');
+}
+
+// Kernel pricing input lines into an arena, specialized on the measure bitmask
+template <unsigned int Mask>
+std::size_t MatrixPricerAmerican::PriceLinesKernel(const std::vector<std::string>& lines, const std::size_t& size, Arena& arena,
+    const char& delimiter, Arena* rejects) const
+{
+    double values[AmericanOption::MEASURE_COUNT];
+    std::size_t rejected = 0;
+    AmericanOption option("Call", 1, 1, 0, 1);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        // A rejected row is set aside with its reason and the block goes on
+        if (const char* reason = ValidateRow(lines[i], option))
+        {
+            ++rejected;
+            if (rejects == nullptr) continue;
+            rejects->Append(reason, std::strlen(reason));
+            rejects->Append(delimiter);
+            rejects->Append(lines[i]);
+            rejects->Append('\n');
+            continue;
+        }
+
+        int n = CachedMeasures<Mask>(option, m_h, values);
+        FormatRow(option, values, n, arena, delimiter);
+    }
+
+    return rejected;
+}
+
+// Kernel pricing the matrix of options, specialized on the measure bitmask
+template <unsigned int Mask>
+void MatrixPricerAmerican::PriceMatrixKernel(const double& h, std::vector<std::vector<std::string>>& output_matrix) const
+{
+    double values[AmericanOption::MEASURE_COUNT];
+
+    // Rows that are identical on the cache grid are priced and formatted once
+    std::unordered_map<PricingCache::Key, std::size_t, PricingCache::KeyHash> first_rows;
+    if (m_cache) first_rows.reserve(m_matrix.size());
+
+    for (const auto& option : m_matrix)
+    {
+        std::vector<std::string> row = option.ConvertToVectorString();
+
+        PricingCache::Key key;
+        if (m_cache && m_cache->MakeKey(option, m_mask, (m_mask & (AmericanOption::MEASURE_NUMERIC_DELTA | AmericanOption::MEASURE_NUMERIC_GAMMA)) != 0 ? h : 0, key))
+        {
+            auto first = first_rows.find(key);
+            if (first != first_rows.end())
+            {
+                const std::vector<std::string>& first_row = output_matrix[first->second];
+                row.insert(row.end(), first_row.begin() + row.size(), first_row.end());
+                output_matrix.push_back(std::move(row));
+                continue;
+            }
+            first_rows.emplace(key, output_matrix.size());
+        }
+
+        int n = CachedMeasures<Mask>(option, h, values);
+        row.reserve(row.size() + n);
+
+        for (int i = 0; i < n; ++i)
+        {
+            row.push_back(std::to_string(values[i]));
+        }
+
+        output_matrix.push_back(std::move(row));
+    }
+}
+
 // Constructor with matrix of options
-MatrixPricerAmerican::MatrixPricerAmerican(const std::vector<AmericanOption>& matrix, const bool& print, const std::string& configuration) :
+MatrixPricerAmerican::MatrixPricerAmerican(const std::vector<AmericanOption>& matrix, const bool& print, const std::string& configuration,
+    const double& h) :
     m_matrix(matrix),
     m_configuration(configuration),
-    m_print(print)
+    m_print(print),
+    m_h(h),
+    m_mask(ResolveConfiguration(configuration)),
+    m_measures(MeasureNames(m_mask))
 {}
 
 // Constructor with input file path
-MatrixPricerAmerican::MatrixPricerAmerican(const std::string& input_path, const bool& print, const std::string& configuration) :
+MatrixPricerAmerican::MatrixPricerAmerican(const std::string& input_path, const bool& print, const std::string& configuration,
+    const double& h) :
     m_configuration(configuration),
-    m_print(print)
+    m_print(print),
+    m_h(h),
+    m_mask(ResolveConfiguration(configuration)),
+    m_measures(MeasureNames(m_mask))
 {
     std::ifstream file(input_path);
     std::string line;
     bool header = true;
+    AmericanOption option("Call", 1, 1, 0, 1);
 
     while (std::getline(file, line))
     {
@@ -74,17 +222,15 @@ MatrixPricerAmerican::MatrixPricerAmerican(const std::string& input_path, const
             header = false;
             continue;
         }
+        if (line.empty()) continue;
 
-        std::istringstream ss(line);
-        std::vector<std::string> row;
-        std::string value;
-
-        while (std::getline(ss, value, ','))
+        // A malformed row is kept aside with its reason instead of stopping the whole batch
+        if (const char* reason = ValidateRow(line, option))
         {
-            row.push_back(value);
+            m_rejects.push_back(std::string(reason) + "," + line);
+            continue;
         }
-        m_matrix.push_back(AmericanOption(row[1], std::stod(row[2]), std::stod(row[3]), std::stod(row[4]), std::stod(row[5]),
-            std::stod(row[6]), std::stoi(row[0])));
+        m_matrix.push_back(option);
     }
 }
 
@@ -92,7 +238,12 @@ MatrixPricerAmerican::MatrixPricerAmerican(const std::string& input_path, const
 MatrixPricerAmerican::MatrixPricerAmerican(const MatrixPricerAmerican& source) :
     m_matrix(source.m_matrix),
     m_configuration(source.m_configuration),
-    m_print(source.m_print)
+    m_print(source.m_print),
+    m_h(source.m_h),
+    m_mask(source.m_mask),
+    m_measures(source.m_measures),
+    m_cache(source.m_cache),
+    m_rejects(source.m_rejects)
 {}
 
 // Assignment operator
@@ -107,32 +258,209 @@ MatrixPricerAmerican& MatrixPricerAmerican::operator=(const MatrixPricerAmerican
     m_matrix = source.m_matrix;
     m_configuration = source.m_configuration;
     m_print = source.m_print;
+    m_h = source.m_h;
+    m_mask = source.m_mask;
+    m_measures = source.m_measures;
+    m_cache = source.m_cache;
+    m_rejects = source.m_rejects;
 
     // Return the current object (the object pointed by this)
     return *this;
 }
 
-// Function to price the matrix of options
-std::vector<std::vector<std::string>> MatrixPricerAmerican::Price(double const& h, const std::string& output_path) const
+// Function to attach a cache of results, or detach it with a null pointer
+MatrixPricerAmerican& MatrixPricerAmerican::Cache(const std::shared_ptr<PricingCache>& cache)
 {
-    std::vector<std::vector<std::string>> output_matrix;
+    m_cache = cache;
+    return *this;
+}
 
-    for (const auto& option : m_matrix)
+// Function to resolve a configuration into a bitmask of measures
+unsigned int MatrixPricerAmerican::ResolveConfiguration(const std::string& configuration)
+{
+    if (configuration == "price") return AmericanOption::MEASURE_CONFIG_PRICE;
+    if (configuration == "basic") return AmericanOption::MEASURE_CONFIG_BASIC;
+    if (configuration == "all") return AmericanOption::MEASURE_CONFIG_ALL;
+
+    // Custom configuration given as a comma-separated list of measures, output in flag order
+    unsigned int mask = 0;
+    std::istringstream ss(configuration);
+    std::string measure;
+
+    while (std::getline(ss, measure, ','))
     {
-        std::vector<std::string> row = option.ConvertToVectorString();
+        const char* const* name = std::find(MEASURE_NAMES, MEASURE_NAMES + AmericanOption::MEASURE_COUNT, measure);
 
-        if (m_configuration == "price")
+        if (name == MEASURE_NAMES + AmericanOption::MEASURE_COUNT)
         {
-            row.push_back(std::to_string(option.Price()));
+            throw std::invalid_argument("Unknown American option measure: " + measure);
         }
-        else if (m_configuration == "all")
+        mask |= 1u << (name - MEASURE_NAMES);
+    }
+
+    if (mask == 0)
+    {
+        throw std::invalid_argument("Empty configuration");
+    }
+
+    return mask;
+}
+
+// Function to list the names of the measures in a bitmask, in output order
+std::vector<std::string> MatrixPricerAmerican::MeasureNames(const unsigned int& mask)
+{
+    std::vector<std::string> names;
+
+    for (unsigned int i = 0; i < AmericanOption::MEASURE_COUNT; ++i)
+    {
+        if (mask & (1u << i)) names.push_back(MEASURE_NAMES[i]);
+    }
+
+    return names;
+}
+
+// Function to parse a line of the input CSV file into an option
+AmericanOption MatrixPricerAmerican::ParseRow(const std::string& line)
+{
+    AmericanOption option("Call", 1, 1, 0, 1);
+
+    if (const char* reason = ValidateRow(line, option))
+    {
+        throw std::invalid_argument("Malformed American option row (" + std::string(reason) + "): " + line);
+    }
+
+    return option;
+}
+
+// Function to parse and validate a line of the input CSV file into an option without throwing
+const char* MatrixPricerAmerican::ValidateRow(const std::string& line, AmericanOption& option)
+{
+    // The fields are views into the line, so parsing does not allocate
+    std::string_view row[7];
+    int id = 0;
+    double K = 0, S = 0, r = 0, sigma = 0, b = 0;
+
+    if (splitFields(line, row, 7) < 7)
+    {
+        return "Missing fields";
+    }
+    if (!parseField(row[0], id) || !parseField(row[2], K) || !parseField(row[3], S) || !parseField(row[4], r) ||
+        !parseField(row[5], sigma) || !parseField(row[6], b))
+    {
+        return "Malformed number";
+    }
+    if (row[1] != "Call" && row[1] != "Put")
+    {
+        return "Unknown option type";
+    }
+
+    // The range checks are written so that a NaN fails them
+    if (!(K > 0) || !(S > 0) || !(sigma > 0) || std::isinf(K) || std::isinf(S) || std::isinf(sigma))
+    {
+        return "K/S/sigma not positive and finite";
+    }
+    if (!std::isfinite(r) || !std::isfinite(b))
+    {
+        return "r/b not finite";
+    }
+
+    option = AmericanOption(std::string(row[1]), K, S, r, sigma, b, id);
+    return nullptr;
+}
+
+// Function to validate a line of the input CSV file without keeping the option
+const char* MatrixPricerAmerican::ValidateRow(const std::string& line)
+{
+    AmericanOption option("Call", 1, 1, 0, 1);
+    return ValidateRow(line, option);
+}
+
+// Function to build the output header for the configuration
+std::string MatrixPricerAmerican::Header(const char& delimiter) const
+{
+    std::string header = "Option,Type,K,S,r,sigma,b";
+
+    if (delimiter != ',')
+    {
+        for (auto& c : header)
         {
-            row.push_back(std::to_string(option.Price()));
-            row.push_back(std::to_string(option.NumericDelta(h)));
-            row.push_back(std::to_string(option.NumericGamma(h)));
+            if (c == ',') c = delimiter;
         }
+    }
+
+    for (const auto& measure : m_measures)
+    {
+        header += delimiter + measure;
+    }
+
+    return header;
+}
+
+// Function to price a single option into an output row using the pricer shock size
+std::vector<std::string> MatrixPricerAmerican::PriceRow(const AmericanOption& option) const
+{
+    return PriceRow(option, m_h);
+}
+
+// Function to price a single option into an output row with a given shock size
+std::vector<std::string> MatrixPricerAmerican::PriceRow(const AmericanOption& option, const double& h) const
+{
+    double values[AmericanOption::MEASURE_COUNT];
+    int n = Evaluate(option, h, values);
+
+    std::vector<std::string> row = option.ConvertToVectorString();
+    row.reserve(row.size() + n);
+
+    for (int i = 0; i < n; ++i)
+    {
+        row.push_back(std::to_string(values[i]));
+    }
+
+    return row;
+}
+
+// Function to price a single option and append its output row to an arena
+void MatrixPricerAmerican::PriceRow(const AmericanOption& option, Arena& arena, const char& delimiter) const
+{
+    double values[AmericanOption::MEASURE_COUNT];
+    int n = Evaluate(option, m_h, values);
+    FormatRow(option, values, n, arena, delimiter);
+}
+
+// Function to parse and price the first size input lines, appending the output rows to an arena
+std::size_t MatrixPricerAmerican::PriceLines(const std::vector<std::string>& lines, const std::size_t& size, Arena& arena,
+    const char& delimiter, Arena* rejects) const
+{
+    // Dispatch once per block to the kernel specialized for the configuration
+    switch (m_mask)
+    {
+    case AmericanOption::MEASURE_CONFIG_PRICE:
+        return PriceLinesKernel<AmericanOption::MEASURE_CONFIG_PRICE>(lines, size, arena, delimiter, rejects);
+    case AmericanOption::MEASURE_CONFIG_BASIC:
+        return PriceLinesKernel<AmericanOption::MEASURE_CONFIG_BASIC>(lines, size, arena, delimiter, rejects);
+    default:
+        return PriceLinesKernel<AmericanOption::MEASURE_CONFIG_ALL>(lines, size, arena, delimiter, rejects);
+    }
+}
 
-        output_matrix.push_back(row);
+// Function to price the matrix of options
+std::vector<std::vector<std::string>> MatrixPricerAmerican::Price(double const& h, const std::string& output_path) const
+{
+    std::vector<std::vector<std::string>> output_matrix;
+    output_matrix.reserve(m_matrix.size());
+
+    // Dispatch once to the kernel specialized for the configuration
+    switch (m_mask)
+    {
+    case AmericanOption::MEASURE_CONFIG_PRICE:
+        PriceMatrixKernel<AmericanOption::MEASURE_CONFIG_PRICE>(h, output_matrix);
+        break;
+    case AmericanOption::MEASURE_CONFIG_BASIC:
+        PriceMatrixKernel<AmericanOption::MEASURE_CONFIG_BASIC>(h, output_matrix);
+        break;
+    default:
+        PriceMatrixKernel<AmericanOption::MEASURE_CONFIG_ALL>(h, output_matrix);
+        break;
     }
 
     if (m_print)
@@ -148,17 +476,10 @@ std::vector<std::vector<std::string>> MatrixPricerAmerican::Price(double const&
             std::cout << "sigma: " << row[5] << ", ";
             std::cout << "b: " << row[6] << "\n";
 
-            // Print the calculated parameters
-            if (m_configuration == "price")
-            {
-                std::cout << "Price: " << row[7] << "\n";
-            }
-
-            else if (m_configuration == "all")
+            // Print the calculated measures
+            for (size_t i = 0; i < m_measures.size(); ++i)
             {
-                std::cout << "Price: " << row[7] << ", ";
-                std::cout << "NumericDelta: " << row[8] << ", ";
-                std::cout << "NumericGamma: " << row[9] << ", ";
+                std::cout << m_measures[i] << ": " << row[7 + i] << (i < m_measures.size() - 1 ? ", " : "\n");
             }
         }
     }
@@ -10,7 +10,11 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <utility>
 #include "../Options/AmericanOption.hpp"
+#include "../Arena/Arena.hpp"
+#include "../PricingCache/PricingCache.hpp"
 
 // Class definition for MatrixPricerAmerican
 class MatrixPricerAmerican
@@ -23,17 +27,51 @@ private:
     std::string m_configuration;
     // Flag to print results
     bool m_print; 
+    // Shock size used by the numeric sensitivities
+    double m_h;
+    // Bitmask of the measures computed for each option, resolved from the configuration
+    unsigned int m_mask;
+    // Names of the computed measures in output order
+    std::vector<std::string> m_measures;
+    // Optional cache of results, may be shared with other pricers
+    std::shared_ptr<PricingCache> m_cache;
+    // Rows of the input file that failed validation, each as "reason,line"
+    std::vector<std::string> m_rejects;
 
     // Function to write data to a CSV file
     void WriteCSV(const std::string& output_path, const std::vector<std::vector<std::string>>& output_matrix) const;
 
+    // Function to evaluate the configured measures of an option, returns the number of values written
+    int Evaluate(const AmericanOption& option, const double& h, double* values) const;
+
+    // Function to evaluate the measures of an option through the cache when there is one
+    template <unsigned int Mask>
+    int CachedMeasures(const AmericanOption& option, const double& h, double* values) const;
+
+    // Function to append an option and its measure values to an arena
+    void FormatRow(const AmericanOption& option, const double* values, const int& n, Arena& arena, const char& delimiter) const;
+
+    // Kernel pricing input lines into an arena, specialized on the measure bitmask
+    template <unsigned int Mask>
+    std::size_t PriceLinesKernel(const std::vector<std::string>& lines, const std::size_t& size, Arena& arena, const char& delimiter,
+        Arena* rejects) const;
+
+    // Kernel pricing the matrix of options, specialized on the measure bitmask
+    template <unsigned int Mask>
+    void PriceMatrixKernel(const double& h, std::vector<std::vector<std::string>>& output_matrix) const;
+
 public:
 
+    // Option type priced by this class
+    typedef AmericanOption OptionType;
+
     // Constructor with matrix of options
-    MatrixPricerAmerican(const std::vector<AmericanOption>& matrix, const bool& print = true, const std::string& configuration = "all");
+    MatrixPricerAmerican(const std::vector<AmericanOption>& matrix, const bool& print = true, const std::string& configuration = "all",
+        const double& h = 1);
 
     // Constructor with input file path
-    MatrixPricerAmerican(const std::string& input_path, const bool& print = true, const std::string& configuration = "all");
+    MatrixPricerAmerican(const std::string& input_path, const bool& print = true, const std::string& configuration = "all",
+        const double& h = 1);
 
     // Copy constructor
     MatrixPricerAmerican(const MatrixPricerAmerican& source);
@@ -41,7 +79,49 @@ public:
     // Assignment operator
     MatrixPricerAmerican& operator=(const MatrixPricerAmerican& source);
 
-    // Function to price the matrix of options
+    // Function to attach a cache of results, or detach it with a null pointer
+    MatrixPricerAmerican& Cache(const std::shared_ptr<PricingCache>& cache);
+    // Function to return the attached cache
+    const std::shared_ptr<PricingCache>& Cache() const { return m_cache; }
+
+    // Function to resolve a configuration ("price", "basic", "all" or a comma-separated list of measures) into a bitmask
+    static unsigned int ResolveConfiguration(const std::string& configuration);
+
+    // Function to list the names of the measures in a bitmask, in output order
+    static std::vector<std::string> MeasureNames(const unsigned int& mask);
+
+    // Function to parse a line of the input CSV file into an option, throws if the row does not pass ValidateRow
+    static AmericanOption ParseRow(const std::string& line);
+
+    // Function to parse and validate a line of the input CSV file into option without throwing. Returns nullptr for
+    // a valid row, or else the reason it is rejected and leaves option unchanged: a missing or malformed field, a
+    // type other than "Call" or "Put", K, S or sigma not positive, or r or b not finite.
+    static const char* ValidateRow(const std::string& line, AmericanOption& option);
+    // Function to validate a line of the input CSV file without keeping the option
+    static const char* ValidateRow(const std::string& line);
+
+    // Function to return the rows of the input file rejected by the constructor, each as "reason,line"
+    const std::vector<std::string>& Rejects() const { return m_rejects; }
+
+    // Function to build the output header for the configuration
+    std::string Header(const char& delimiter = ',') const;
+
+    // Function to price a single option into an output row using the pricer shock size
+    std::vector<std::string> PriceRow(const AmericanOption& option) const;
+    // Function to price a single option into an output row with a given shock size
+    std::vector<std::string> PriceRow(const AmericanOption& option, const double& h) const;
+
+    // Function to price a single option and append its output row to an arena
+    void PriceRow(const AmericanOption& option, Arena& arena, const char& delimiter = ',') const;
+
+    // Function to parse and price the first size input lines, appending the output rows to an arena. Rows that fail
+    // validation are not priced, they are appended to rejects as "reason,line" when it is given. Returns the number
+    // of rejected rows.
+    std::size_t PriceLines(const std::vector<std::string>& lines, const std::size_t& size, Arena& arena, const char& delimiter = ',',
+        Arena* rejects = nullptr) const;
+
+    // Function to price the matrix of options. The rows are returned as strings, so every row allocates its vector and
+    // its formatted values; PriceLines is the allocation-free path
     std::vector<std::vector<std::string>> Price(const double& h = 1, const std::string& output_path = "") const;
 };
 
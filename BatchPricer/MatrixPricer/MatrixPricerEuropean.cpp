@@ -8,7 +8,14 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+#include <tuple>
+#include <cmath>
+#include <cstring>
 #include "../Options/EuropeanOption.hpp"
+#include "../Functions/Functions.hpp"
 #include "MatrixPricerEuropean.hpp"
 
 // Function to write data to a CSV file
@@ -18,18 +25,7 @@ void MatrixPricerEuropean::WriteCSV(const std::string& output_path, const std::v
 
     if (file.is_open())
     {
-        if (m_configuration == "price")
-        {
-            file << "Option,Type,T,K,S,r,sigma,b,Price\n";
-        }
-        else if (m_configuration == "basic")
-        {
-            file << "Option,Type,T,K,S,r,sigma,b,Price,PricePutCallParity,Delta,Gamma,Vega,Theta,Rho\n";
-        }
-        else if (m_configuration == "all")
-        {
-            file << "Option,Type,T,K,S,r,sigma,b,Price,PricePutCallParity,Delta,Gamma,Vega,Theta,Rho,Vanna,Charm,Speed,Color,DvegaDtime, Vomma,Veta,Zomma,Lambda,Ultima\n";
-        }
+        file << Header() << "\n";
 
         // Write data
         for (const auto& row : output_matrix)
@@ -54,21 +50,319 @@ void MatrixPricerEuropean::WriteCSV(const std::string& output_path, const std::v
 
 }
 
+// Names of the measures, indexed by the bit position of their EuropeanOption::MeasureFlag
+static const char* const MEASURE_NAMES[EuropeanOption::MEASURE_COUNT] =
+{
+    "Price", "PricePutCallParity", "Delta", "Gamma", "Vega", "Theta", "Rho", "Vanna", "Charm", "Speed",
+    "Color", "DvegaDtime", "Vomma", "Veta", "Zomma", "Lambda", "Ultima"
+};
+
+// Function to evaluate the measures of an option through the cache when there is one
+template <unsigned int Mask>
+int MatrixPricerEuropean::CachedMeasures(const EuropeanOption& option, double* values, const EuropeanOption::TermFactors* factors) const
+{
+    PricingCache::Key key;
+    bool cached = m_cache && m_cache->MakeKey(option, m_mask, 0, key);
+
+    int n = 0;
+    if (cached && m_cache->Find(key, values, n))
+    {
+        return n;
+    }
+
+    // Each variant of the model runs its own kernel, the options sharing T, r and b also share their variant
+    const EuropeanOption::TermFactors term = factors ? *factors : option.Factors();
+    switch (option.Model())
+    {
+    case EuropeanOption::CARRY_STOCK:
+        n = option.Measures<Mask, EuropeanOption::CARRY_STOCK>(m_mask, values, term);
+        break;
+    case EuropeanOption::CARRY_FUTURES:
+        n = option.Measures<Mask, EuropeanOption::CARRY_FUTURES>(m_mask, values, term);
+        break;
+    default:
+        n = option.Measures<Mask, EuropeanOption::CARRY_GENERAL>(m_mask, values, term);
+        break;
+    }
+    if (cached) m_cache->Insert(key, values, n);
+
+    return n;
+}
+
+// Function to evaluate the measures of size options in (type, T, r, b, S) order
+template <unsigned int Mask>
+void MatrixPricerEuropean::EvaluateInOrder(const EuropeanOption* options, const std::size_t& size, double* values, int* counts) const
+{
+    // Consecutive options of the same type and variant of the model take the same branches and kernel, and the runs
+    // of equal T, r and b share their discount and carry factors, which are computed once per run
+    std::vector<OrderEntry>& order = ThreadScratch().order;
+    order.resize(size);
+    for (std::size_t k = 0; k < size; ++k)
+    {
+        const EuropeanOption& option = options[k];
+        order[k] = { option.type() == "Call", option.Model(), option.T(), option.r(), option.b(), option.S(), k };
+    }
+    std::sort(order.begin(), order.end(), [](const OrderEntry& x, const OrderEntry& y)
+    {
+        return std::tie(x.call, x.model, x.T, x.r, x.b, x.S, x.k) < std::tie(y.call, y.model, y.T, y.r, y.b, y.S, y.k);
+    });
+
+    EuropeanOption::TermFactors factors{};
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const OrderEntry& entry = order[i];
+        if (i == 0 || entry.T != order[i - 1].T || entry.r != order[i - 1].r || entry.b != order[i - 1].b)
+        {
+            factors = options[entry.k].Factors();
+        }
+
+        counts[entry.k] = CachedMeasures<Mask>(options[entry.k], values + entry.k * m_measures.size(), &factors);
+    }
+}
+
+// Function to evaluate the configured measures of an option
+int MatrixPricerEuropean::Evaluate(const EuropeanOption& option, double* values) const
+{
+    switch (m_mask)
+    {
+    case EuropeanOption::MEASURE_CONFIG_PRICE:
+        return CachedMeasures<EuropeanOption::MEASURE_CONFIG_PRICE>(option, values);
+    case EuropeanOption::MEASURE_CONFIG_BASIC:
+        return CachedMeasures<EuropeanOption::MEASURE_CONFIG_BASIC>(option, values);
+    default:
+        // "all" and custom subsets share the full kernel, which skips unselected measures and the
+        // intermediates only they need at run time
+        return CachedMeasures<EuropeanOption::MEASURE_CONFIG_ALL>(option, values);
+    }
+}
+
+// Function to append an option and its measure values to an arena
+void MatrixPricerEuropean::FormatRow(const EuropeanOption& option, const double* values, const int& n, Arena& arena,
+    const char& delimiter) const
+{
+    arena.Append(option.id());
+    arena.Append(delimiter);
+    arena.Append(option.type());
+    arena.Append(delimiter);
+    arena.Append(option.T());
+    arena.Append(delimiter);
+    arena.Append(option.K());
+    arena.Append(delimiter);
+    arena.Append(option.S());
+    arena.Append(delimiter);
+    arena.Append(option.r());
+    arena.Append(delimiter);
+    arena.Append(option.sigma());
+    arena.Append(delimiter);
+    arena.Append(option.b());
+
+    for (int i = 0; i < n; ++i)
+    {
+        arena.Append(delimiter);
+        arena.Append(values[i]);
+    }
+
+    arena.Append('\n');
+}
+
+// Kernel pricing input lines into an arena, specialized on the measure bitmask
+template <unsigned int Mask>
+std::size_t MatrixPricerEuropean::PriceLinesKernel(const std::vector<std::string>& lines, const std::size_t& size, Arena& arena,
+    const char& delimiter, Arena* rejects) const
+{
+    double values[EuropeanOption::MEASURE_COUNT];
+    std::size_t rejected = 0;
+    EuropeanOption option("Call", 1, 1, 1, 0, 1);
+
+    // A rejected row is set aside with its reason and the block goes on
+    auto reject = [&](const char* reason, const std::string& line)
+    {
+        ++rejected;
+        if (rejects == nullptr) return;
+        rejects->Append(reason, std::strlen(reason));
+        rejects->Append(delimiter);
+        rejects->Append(line);
+        rejects->Append('\n');
+    };
+
+    if (!m_reorder)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            if (const char* reason = ValidateRow(lines[i], option))
+            {
+                reject(reason, lines[i]);
+                continue;
+            }
+            if (HasMarketData()) Resolve(option);
+            int n = CachedMeasures<Mask>(option, values);
+            FormatRow(option, values, n, arena, delimiter);
+        }
+        return rejected;
+    }
+
+    // Parse the whole block, look its market data up in expiry order, price it in locality order and format the rows
+    // back in input order, in the scratch buffers of the thread
+    Scratch& scratch = ThreadScratch();
+    std::vector<EuropeanOption>& options = scratch.options;
+    options.clear();
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (const char* reason = ValidateRow(lines[i], option))
+        {
+            reject(reason, lines[i]);
+            continue;
+        }
+        options.push_back(option);
+    }
+    if (HasMarketData()) Resolve(options, scratch);
+
+    scratch.values.resize(options.size() * m_measures.size());
+    scratch.counts.resize(options.size());
+    EvaluateInOrder<Mask>(options.data(), options.size(), scratch.values.data(), scratch.counts.data());
+
+    for (std::size_t i = 0; i < options.size(); ++i)
+    {
+        FormatRow(options[i], scratch.values.data() + i * m_measures.size(), scratch.counts[i], arena, delimiter);
+    }
+
+    return rejected;
+}
+
+// Function to look up the volatility, rate and cost of carry of an option on the attached surface and curves
+void MatrixPricerEuropean::Resolve(EuropeanOption& option) const
+{
+    if (m_rate_curve) option.r(*m_rate_curve);
+    if (m_carry_curve) option.b(*m_carry_curve);
+    if (m_surface) option.sigma(m_surface->Volatility(option.T(), option.K(), option.S()));
+}
+
+// Function to return the scratch buffers of the calling thread
+MatrixPricerEuropean::Scratch& MatrixPricerEuropean::ThreadScratch()
+{
+    // Each pipeline thread keeps its own buffers, shared by every pricer it runs
+    static thread_local Scratch scratch;
+    return scratch;
+}
+
+// Function to look up the market data of options on the surface and curves in expiry order, in place
+void MatrixPricerEuropean::Resolve(std::vector<EuropeanOption>& options, Scratch& scratch) const
+{
+    const std::size_t size = options.size();
+
+    // The surface reuses its expiry cell between lookups in increasing expiry, the curves only need their few nodes
+    // and evaluate each run of equal maturities once, so the options are sorted by expiry only for the surface
+    scratch.expiries.resize(size);
+    for (std::size_t k = 0; k < size; ++k)
+    {
+        scratch.expiries[k] = { options[k].T(), k };
+    }
+    if (m_surface) std::sort(scratch.expiries.begin(), scratch.expiries.end());
+
+    scratch.T.resize(size);
+    scratch.K.resize(size);
+    scratch.S.resize(size);
+    scratch.market.resize(size);
+    for (std::size_t k = 0; k < size; ++k)
+    {
+        const EuropeanOption& option = options[scratch.expiries[k].second];
+        scratch.T[k] = scratch.expiries[k].first;
+        scratch.K[k] = option.K();
+        scratch.S[k] = option.S();
+    }
+
+    if (m_rate_curve)
+    {
+        m_rate_curve->ZeroRates(scratch.T.data(), scratch.market.data(), size);
+        for (std::size_t k = 0; k < size; ++k) options[scratch.expiries[k].second].r(scratch.market[k]);
+    }
+    if (m_carry_curve)
+    {
+        m_carry_curve->ZeroRates(scratch.T.data(), scratch.market.data(), size);
+        for (std::size_t k = 0; k < size; ++k) options[scratch.expiries[k].second].b(scratch.market[k]);
+    }
+    if (m_surface)
+    {
+        m_surface->Volatilities(scratch.T.data(), scratch.K.data(), scratch.S.data(), scratch.market.data(), size);
+        for (std::size_t k = 0; k < size; ++k) options[scratch.expiries[k].second].sigma(scratch.market[k]);
+    }
+}
+
+// Kernel pricing a matrix of options, specialized on the measure bitmask
+template <unsigned int Mask>
+void MatrixPricerEuropean::PriceMatrixKernel(const std::vector<EuropeanOption>& matrix,
+    std::vector<std::vector<std::string>>& output_matrix) const
+{
+    double values[EuropeanOption::MEASURE_COUNT];
+
+    // With reordering every option is priced up front in locality order and the rows are formatted in input order
+    std::vector<double> matrix_values;
+    std::vector<int> counts;
+    if (m_reorder)
+    {
+        matrix_values.resize(matrix.size() * m_measures.size());
+        counts.resize(matrix.size());
+        EvaluateInOrder<Mask>(matrix.data(), matrix.size(), matrix_values.data(), counts.data());
+    }
+
+    // Rows that are identical on the cache grid are priced and formatted once
+    std::unordered_map<PricingCache::Key, std::size_t, PricingCache::KeyHash> first_rows;
+    if (m_cache) first_rows.reserve(matrix.size());
+
+    for (std::size_t k = 0; k < matrix.size(); ++k)
+    {
+        const EuropeanOption& option = matrix[k];
+        std::vector<std::string> row = option.ConvertToVectorString();
+
+        PricingCache::Key key;
+        if (m_cache && m_cache->MakeKey(option, m_mask, 0, key))
+        {
+            auto first = first_rows.find(key);
+            if (first != first_rows.end())
+            {
+                const std::vector<std::string>& first_row = output_matrix[first->second];
+                row.insert(row.end(), first_row.begin() + row.size(), first_row.end());
+                output_matrix.push_back(std::move(row));
+                continue;
+            }
+            first_rows.emplace(key, output_matrix.size());
+        }
+
+        const double* option_values = m_reorder ? matrix_values.data() + k * m_measures.size() : values;
+        int n = m_reorder ? counts[k] : CachedMeasures<Mask>(option, values);
+        row.reserve(row.size() + n);
+
+        for (int i = 0; i < n; ++i)
+        {
+            row.push_back(std::to_string(option_values[i]));
+        }
+
+        output_matrix.push_back(std::move(row));
+    }
+}
+
 // Constructor with matrix of options
 MatrixPricerEuropean::MatrixPricerEuropean(const std::vector<EuropeanOption>& matrix, const bool& print, const std::string& configuration) :
     m_matrix(matrix),
     m_configuration(configuration),
-    m_print(print)
+    m_print(print),
+    m_mask(ResolveConfiguration(configuration)),
+    m_measures(MeasureNames(m_mask)),
+    m_reorder(false)
 {}
 
 // Constructor with input file path
 MatrixPricerEuropean::MatrixPricerEuropean(const std::string& input_path, const bool& print, const std::string& configuration) :
     m_configuration(configuration),
-    m_print(print)
+    m_print(print),
+    m_mask(ResolveConfiguration(configuration)),
+    m_measures(MeasureNames(m_mask)),
+    m_reorder(false)
 {
     std::ifstream file(input_path);
     std::string line;
     bool header = true;
+    EuropeanOption option("Call", 1, 1, 1, 0, 1);
 
     while (std::getline(file, line))
     {
@@ -76,18 +370,15 @@ MatrixPricerEuropean::MatrixPricerEuropean(const std::string& input_path, const
             header = false;
             continue;
         }
+        if (line.empty()) continue;
 
-        std::istringstream ss(line);
-        std::vector<std::string> row;
-        std::string value;
-
-        while (std::getline(ss, value, ','))
+        // A malformed row is kept aside with its reason instead of stopping the whole batch
+        if (const char* reason = ValidateRow(line, option))
         {
-            row.push_back(value);
+            m_rejects.push_back(std::string(reason) + "," + line);
+            continue;
         }
-
-        m_matrix.push_back(EuropeanOption(std::string(row[1]), std::stod(row[2]), std::stod(row[3]), std::stod(row[4]),
-            std::stod(row[5]), std::stod(row[6]), std::stoi(row[0]), std::stod(row[7])));
+        m_matrix.push_back(option);
     }
 }
 
@@ -95,71 +386,267 @@ MatrixPricerEuropean::MatrixPricerEuropean(const std::string& input_path, const
 MatrixPricerEuropean::MatrixPricerEuropean(const MatrixPricerEuropean& source) :
     m_matrix(source.m_matrix),
     m_configuration(source.m_configuration),
-    m_print(source.m_print)
+    m_print(source.m_print),
+    m_mask(source.m_mask),
+    m_measures(source.m_measures),
+    m_cache(source.m_cache),
+    m_surface(source.m_surface),
+    m_rate_curve(source.m_rate_curve),
+    m_carry_curve(source.m_carry_curve),
+    m_reorder(source.m_reorder),
+    m_rejects(source.m_rejects)
 {}
 
 // Assignment operator
 MatrixPricerEuropean& MatrixPricerEuropean::operator=(const MatrixPricerEuropean& source)
 {
     // Check for self assignment
-    // Compare the address of the object with 
-    // the address of its source object 
+    // Compare the address of the object with
+    // the address of its source object
     if (this == &source)
         return *this;
 
     m_matrix = source.m_matrix;
     m_configuration = source.m_configuration;
     m_print = source.m_print;
+    m_mask = source.m_mask;
+    m_measures = source.m_measures;
+    m_cache = source.m_cache;
+    m_surface = source.m_surface;
+    m_rate_curve = source.m_rate_curve;
+    m_carry_curve = source.m_carry_curve;
+    m_reorder = source.m_reorder;
+    m_rejects = source.m_rejects;
 
     // Return the current object (the object pointed by this)
     return *this;
 }
 
-// Function to price the matrix of options
-std::vector<std::vector<std::string>> MatrixPricerEuropean::Price(const std::string& output_path) const
+// Function to set whether each batch is priced in (type, T, r, b, S) order
+MatrixPricerEuropean& MatrixPricerEuropean::Reorder(const bool& reorder)
 {
-    std::vector<std::vector<std::string>> output_matrix;
+    m_reorder = reorder;
+    return *this;
+}
 
-    for (const auto& option : m_matrix)
+// Function to attach a cache of results, or detach it with a null pointer
+MatrixPricerEuropean& MatrixPricerEuropean::Cache(const std::shared_ptr<PricingCache>& cache)
+{
+    m_cache = cache;
+    return *this;
+}
+
+// Function to attach a volatility surface, or detach it with a null pointer
+MatrixPricerEuropean& MatrixPricerEuropean::Surface(const std::shared_ptr<VolSurface>& surface)
+{
+    m_surface = surface;
+    return *this;
+}
+
+// Function to attach discount and carry curves, or detach either with a null pointer
+MatrixPricerEuropean& MatrixPricerEuropean::Curves(const std::shared_ptr<YieldCurve>& rate_curve,
+    const std::shared_ptr<YieldCurve>& carry_curve)
+{
+    m_rate_curve = rate_curve;
+    m_carry_curve = carry_curve;
+    return *this;
+}
+
+// Function to resolve a configuration into a bitmask of measures
+unsigned int MatrixPricerEuropean::ResolveConfiguration(const std::string& configuration)
+{
+    if (configuration == "price") return EuropeanOption::MEASURE_CONFIG_PRICE;
+    if (configuration == "basic") return EuropeanOption::MEASURE_CONFIG_BASIC;
+    if (configuration == "all") return EuropeanOption::MEASURE_CONFIG_ALL;
+
+    // Custom configuration given as a comma-separated list of measures, output in flag order
+    unsigned int mask = 0;
+    std::istringstream ss(configuration);
+    std::string measure;
+
+    while (std::getline(ss, measure, ','))
     {
-        std::vector<std::string> row = option.ConvertToVectorString();
+        const char* const* name = std::find(MEASURE_NAMES, MEASURE_NAMES + EuropeanOption::MEASURE_COUNT, measure);
 
-        if (m_configuration == "price")
-        {
-            row.push_back(std::to_string(option.Price()));
-        }
-        else if (m_configuration == "basic")
+        if (name == MEASURE_NAMES + EuropeanOption::MEASURE_COUNT)
         {
-            row.push_back(std::to_string(option.Price()));
-            row.push_back(std::to_string(option.PricePutCallParity()));
-            row.push_back(std::to_string(option.Delta()));
-            row.push_back(std::to_string(option.Gamma()));
-            row.push_back(std::to_string(option.Vega()));
-            row.push_back(std::to_string(option.Theta()));
-            row.push_back(std::to_string(option.Rho()));
+            throw std::invalid_argument("Unknown European option measure: " + measure);
         }
-        else if (m_configuration == "all")
+        mask |= 1u << (name - MEASURE_NAMES);
+    }
+
+    if (mask == 0)
+    {
+        throw std::invalid_argument("Empty configuration");
+    }
+
+    return mask;
+}
+
+// Function to list the names of the measures in a bitmask, in output order
+std::vector<std::string> MatrixPricerEuropean::MeasureNames(const unsigned int& mask)
+{
+    std::vector<std::string> names;
+
+    for (unsigned int i = 0; i < EuropeanOption::MEASURE_COUNT; ++i)
+    {
+        if (mask & (1u << i)) names.push_back(MEASURE_NAMES[i]);
+    }
+
+    return names;
+}
+
+// Function to parse a line of the input CSV file into an option
+EuropeanOption MatrixPricerEuropean::ParseRow(const std::string& line)
+{
+    EuropeanOption option("Call", 1, 1, 1, 0, 1);
+
+    if (const char* reason = ValidateRow(line, option))
+    {
+        throw std::invalid_argument("Malformed European option row (" + std::string(reason) + "): " + line);
+    }
+
+    return option;
+}
+
+// Function to parse and validate a line of the input CSV file into an option without throwing
+const char* MatrixPricerEuropean::ValidateRow(const std::string& line, EuropeanOption& option)
+{
+    // The fields are views into the line, so parsing does not allocate
+    std::string_view row[8];
+    int id = 0;
+    double T = 0, K = 0, S = 0, r = 0, sigma = 0, b = 0;
+
+    if (splitFields(line, row, 8) < 8)
+    {
+        return "Missing fields";
+    }
+    if (!parseField(row[0], id) || !parseField(row[2], T) || !parseField(row[3], K) || !parseField(row[4], S) ||
+        !parseField(row[5], r) || !parseField(row[6], sigma) || !parseField(row[7], b))
+    {
+        return "Malformed number";
+    }
+    if (row[1] != "Call" && row[1] != "Put")
+    {
+        return "Unknown option type";
+    }
+
+    // The range checks are written so that a NaN fails them
+    if (!(T > 0) || !(K > 0) || !(S > 0) || !(sigma > 0) || std::isinf(T) || std::isinf(K) || std::isinf(S) || std::isinf(sigma))
+    {
+        return "T/K/S/sigma not positive and finite";
+    }
+    if (!std::isfinite(r) || !std::isfinite(b))
+    {
+        return "r/b not finite";
+    }
+
+    option = EuropeanOption(std::string(row[1]), T, K, S, r, sigma, id, b);
+    return nullptr;
+}
+
+// Function to validate a line of the input CSV file without keeping the option
+const char* MatrixPricerEuropean::ValidateRow(const std::string& line)
+{
+    EuropeanOption option("Call", 1, 1, 1, 0, 1);
+    return ValidateRow(line, option);
+}
+
+// Function to build the output header for the configuration
+std::string MatrixPricerEuropean::Header(const char& delimiter) const
+{
+    std::string header = "Option,Type,T,K,S,r,sigma,b";
+
+    if (delimiter != ',')
+    {
+        for (auto& c : header)
         {
-            row.push_back(std::to_string(option.Price()));
-            row.push_back(std::to_string(option.PricePutCallParity()));
-            row.push_back(std::to_string(option.Delta()));
-            row.push_back(std::to_string(option.Gamma()));
-            row.push_back(std::to_string(option.Vega()));
-            row.push_back(std::to_string(option.Theta()));
-            row.push_back(std::to_string(option.Rho()));
-            row.push_back(std::to_string(option.Vanna()));
-            row.push_back(std::to_string(option.Charm()));
-            row.push_back(std::to_string(option.Speed()));
-            row.push_back(std::to_string(option.Color()));
-            row.push_back(std::to_string(option.DvegaDtime()));
-            row.push_back(std::to_string(option.Vomma()));
-            row.push_back(std::to_string(option.Veta()));
-            row.push_back(std::to_string(option.Zomma()));
-            row.push_back(std::to_string(option.Lambda()));
-            row.push_back(std::to_string(option.Ultima()));
+            if (c == ',') c = delimiter;
         }
+    }
+
+    for (const auto& measure : m_measures)
+    {
+        header += delimiter + measure;
+    }
+
+    return header;
+}
+
+// Function to price a single option into an output row
+std::vector<std::string> MatrixPricerEuropean::PriceRow(const EuropeanOption& option) const
+{
+    EuropeanOption resolved(option);
+    if (HasMarketData()) Resolve(resolved);
+
+    double values[EuropeanOption::MEASURE_COUNT];
+    int n = Evaluate(resolved, values);
+
+    std::vector<std::string> row = resolved.ConvertToVectorString();
+    row.reserve(row.size() + n);
+
+    for (int i = 0; i < n; ++i)
+    {
+        row.push_back(std::to_string(values[i]));
+    }
 
-        output_matrix.push_back(row);
+    return row;
+}
+
+// Function to price a single option and append its output row to an arena
+void MatrixPricerEuropean::PriceRow(const EuropeanOption& option, Arena& arena, const char& delimiter) const
+{
+    EuropeanOption resolved(option);
+    if (HasMarketData()) Resolve(resolved);
+
+    double values[EuropeanOption::MEASURE_COUNT];
+    int n = Evaluate(resolved, values);
+    FormatRow(resolved, values, n, arena, delimiter);
+}
+
+// Function to parse and price the first size input lines, appending the output rows to an arena
+std::size_t MatrixPricerEuropean::PriceLines(const std::vector<std::string>& lines, const std::size_t& size, Arena& arena,
+    const char& delimiter, Arena* rejects) const
+{
+    // Dispatch once per block to the kernel specialized for the configuration
+    switch (m_mask)
+    {
+    case EuropeanOption::MEASURE_CONFIG_PRICE:
+        return PriceLinesKernel<EuropeanOption::MEASURE_CONFIG_PRICE>(lines, size, arena, delimiter, rejects);
+    case EuropeanOption::MEASURE_CONFIG_BASIC:
+        return PriceLinesKernel<EuropeanOption::MEASURE_CONFIG_BASIC>(lines, size, arena, delimiter, rejects);
+    default:
+        return PriceLinesKernel<EuropeanOption::MEASURE_CONFIG_ALL>(lines, size, arena, delimiter, rejects);
+    }
+}
+
+// Function to price the matrix of options
+std::vector<std::vector<std::string>> MatrixPricerEuropean::Price(const std::string& output_path) const
+{
+    std::vector<std::vector<std::string>> output_matrix;
+    output_matrix.reserve(m_matrix.size());
+
+    // With a surface or curves the options are priced with the market data they give them
+    std::vector<EuropeanOption> resolved;
+    if (HasMarketData())
+    {
+        resolved = m_matrix;
+        Resolve(resolved, ThreadScratch());
+    }
+    const std::vector<EuropeanOption>& matrix = HasMarketData() ? resolved : m_matrix;
+
+    // Dispatch once to the kernel specialized for the configuration
+    switch (m_mask)
+    {
+    case EuropeanOption::MEASURE_CONFIG_PRICE:
+        PriceMatrixKernel<EuropeanOption::MEASURE_CONFIG_PRICE>(matrix, output_matrix);
+        break;
+    case EuropeanOption::MEASURE_CONFIG_BASIC:
+        PriceMatrixKernel<EuropeanOption::MEASURE_CONFIG_BASIC>(matrix, output_matrix);
+        break;
+    default:
+        PriceMatrixKernel<EuropeanOption::MEASURE_CONFIG_ALL>(matrix, output_matrix);
+        break;
     }
 
     if (m_print)
@@ -176,42 +663,10 @@ std::vector<std::vector<std::string>> MatrixPricerEuropean::Price(const std::str
             std::cout << "sigma: " << row[6] << ", ";
             std::cout << "b: " << row[7] << "\n";
 
-
-            if (m_configuration == "price")
-            {
-                std::cout << "Price: " << row[8] << "\n";
-            }
-
-            else if (m_configuration == "basic")
-            {
-                std::cout << "Price: " << row[8] << ", ";
-                std::cout << "PricePutCallParity: " << row[9] << ", ";
-                std::cout << "Delta: " << row[10] << ", ";
-                std::cout << "Gamma: " << row[11] << ", ";
-                std::cout << "Vega: " << row[12] << ", ";
-                std::cout << "Theta: " << row[13] << ", ";
-                std::cout << "Rho: " << row[14] << "\n";
-            }
-
-            else if (m_configuration == "all")
+            // Print the calculated measures
+            for (size_t i = 0; i < m_measures.size(); ++i)
             {
-                std::cout << "Price: " << row[8] << ", ";
-                std::cout << "PricePutCallParity: " << row[9] << ", ";
-                std::cout << "Delta: " << row[10] << ", ";
-                std::cout << "Gamma: " << row[11] << ", ";
-                std::cout << "Vega: " << row[12] << ", ";
-                std::cout << "Theta: " << row[13] << ", ";
-                std::cout << "Rho: " << row[14] << ", ";
-                std::cout << "Vanna: " << row[15] << ", ";
-                std::cout << "Charm: " << row[16] << ", ";
-                std::cout << "Speed: " << row[17] << ", ";
-                std::cout << "Color: " << row[18] << ", ";
-                std::cout << "DvegaDtime: " << row[19] << ", ";
-                std::cout << "Vomma: " << row[20] << ", ";
-                std::cout << "Veta: " << row[21] << ", ";
-                std::cout << "Zomma: " << row[22] << ", ";
-                std::cout << "Lambda: " << row[23] << ", ";
-                std::cout << "Ultima: " << row[24] << "\n";
+                std::cout << m_measures[i] << ": " << row[8 + i] << (i < m_measures.size() - 1 ? ", " : "\n");
             }
         }
     }
@@ -10,7 +10,13 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <utility>
 #include "../Options/EuropeanOption.hpp"
+#include "../Arena/Arena.hpp"
+#include "../PricingCache/PricingCache.hpp"
+#include "../VolSurface/VolSurface.hpp"
+#include "../YieldCurve/YieldCurve.hpp"
 
 // Class definition for MatrixPricerEuropean
 class MatrixPricerEuropean
@@ -20,15 +26,92 @@ private:
     // Matrix of European options
     std::vector<EuropeanOption> m_matrix;
     // Configuration setting
-    std::string m_configuration; 
+    std::string m_configuration;
     // Flag to print results
     bool m_print;
+    // Bitmask of the measures computed for each option, resolved from the configuration
+    unsigned int m_mask;
+    // Names of the computed measures in output order
+    std::vector<std::string> m_measures;
+    // Optional cache of results, may be shared with other pricers
+    std::shared_ptr<PricingCache> m_cache;
+    // Optional volatility surface, overrides the volatility of every option when set
+    std::shared_ptr<VolSurface> m_surface;
+    // Optional discount and carry curves, override the rate and the cost of carry of every option when set
+    std::shared_ptr<YieldCurve> m_rate_curve;
+    std::shared_ptr<YieldCurve> m_carry_curve;
+    // Flag to price each batch in (type, T, r, b, S) order and scatter the results back to the input order
+    bool m_reorder;
+    // Rows of the input file that failed validation, each as "reason,line"
+    std::vector<std::string> m_rejects;
 
     // Function to write data to a CSV file
     void WriteCSV(const std::string& output_path, const std::vector<std::vector<std::string>>& output_matrix) const;
 
+    // Function to evaluate the configured measures of an option, returns the number of values written
+    int Evaluate(const EuropeanOption& option, double* values) const;
+
+    // Function to evaluate the measures of an option through the cache when there is one, with the factors of its
+    // T, r and b when they were computed beforehand, in the kernel of the variant of the model it is classified into
+    template <unsigned int Mask>
+    int CachedMeasures(const EuropeanOption& option, double* values, const EuropeanOption::TermFactors* factors = nullptr) const;
+
+    // Function to evaluate the measures of size options in (type, variant of the model, T, r, b, S) order, writing the
+    // values of option k at values + k * m_measures.size() and their number at counts[k]
+    template <unsigned int Mask>
+    void EvaluateInOrder(const EuropeanOption* options, const std::size_t& size, double* values, int* counts) const;
+
+    // Function to append an option and its measure values to an arena
+    void FormatRow(const EuropeanOption& option, const double* values, const int& n, Arena& arena, const char& delimiter) const;
+
+    // Kernel pricing input lines into an arena, specialized on the measure bitmask
+    template <unsigned int Mask>
+    std::size_t PriceLinesKernel(const std::vector<std::string>& lines, const std::size_t& size, Arena& arena, const char& delimiter,
+        Arena* rejects) const;
+
+    // Function to return whether a surface or a curve is attached
+    bool HasMarketData() const { return m_surface || m_rate_curve || m_carry_curve; }
+
+    // Function to look up the volatility, rate and cost of carry of an option on the attached surface and curves
+    void Resolve(EuropeanOption& option) const;
+
+    // Sort key of an option priced in locality order
+    struct OrderEntry
+    {
+        bool call;
+        int model;
+        double T, r, b, S;
+        std::size_t k;
+    };
+
+    // Scratch buffers of a pricing thread, grown to the largest block it has priced and reused for the next ones, so that
+    // steady-state pricing does not allocate
+    struct Scratch
+    {
+        std::vector<EuropeanOption> options; // Valid options of a reordered block, in input order
+        std::vector<double> values; // Measure values of the options of a reordered block
+        std::vector<int> counts; // Number of measure values of each option of a reordered block
+        std::vector<OrderEntry> order; // Options in locality order
+        std::vector<std::pair<double, std::size_t>> expiries; // Expiry and index of the options, in lookup order
+        std::vector<double> T, K, S; // Columns of the options in lookup order
+        std::vector<double> market; // Rates, costs of carry or volatilities returned by the curves and the surface
+    };
+
+    // Function to return the scratch buffers of the calling thread
+    static Scratch& ThreadScratch();
+
+    // Function to look up the market data of options on the surface and curves in expiry order, in place
+    void Resolve(std::vector<EuropeanOption>& options, Scratch& scratch) const;
+
+    // Kernel pricing a matrix of options, specialized on the measure bitmask
+    template <unsigned int Mask>
+    void PriceMatrixKernel(const std::vector<EuropeanOption>& matrix, std::vector<std::vector<std::string>>& output_matrix) const;
+
 public:
 
+    // Option type priced by this class
+    typedef EuropeanOption OptionType;
+
     // Constructor with matrix of options
     MatrixPricerEuropean(const std::vector<EuropeanOption>& matrix, const bool& print = true, const std::string& configuration = "all");
 
@@ -41,7 +124,63 @@ public:
     // Assignment operator
     MatrixPricerEuropean& operator=(const MatrixPricerEuropean& source);
 
-    // Function to price the matrix of options
+    // Function to attach a cache of results, or detach it with a null pointer
+    MatrixPricerEuropean& Cache(const std::shared_ptr<PricingCache>& cache);
+    // Function to return the attached cache
+    const std::shared_ptr<PricingCache>& Cache() const { return m_cache; }
+
+    // Function to attach a volatility surface, or detach it with a null pointer
+    MatrixPricerEuropean& Surface(const std::shared_ptr<VolSurface>& surface);
+    // Function to return the attached volatility surface
+    const std::shared_ptr<VolSurface>& Surface() const { return m_surface; }
+
+    // Function to attach discount and carry curves, or detach either with a null pointer
+    MatrixPricerEuropean& Curves(const std::shared_ptr<YieldCurve>& rate_curve, const std::shared_ptr<YieldCurve>& carry_curve = nullptr);
+    // Functions to return the attached discount and carry curves
+    const std::shared_ptr<YieldCurve>& RateCurve() const { return m_rate_curve; }
+    const std::shared_ptr<YieldCurve>& CarryCurve() const { return m_carry_curve; }
+
+    // Function to set whether each batch is priced in (type, T, r, b, S) order, the output keeps the input order
+    MatrixPricerEuropean& Reorder(const bool& reorder);
+    // Function to return whether each batch is priced in (type, T, r, b, S) order
+    const bool& Reorder() const { return m_reorder; }
+
+    // Function to resolve a configuration ("price", "basic", "all" or a comma-separated list of measures) into a bitmask
+    static unsigned int ResolveConfiguration(const std::string& configuration);
+
+    // Function to list the names of the measures in a bitmask, in output order
+    static std::vector<std::string> MeasureNames(const unsigned int& mask);
+
+    // Function to parse a line of the input CSV file into an option, throws if the row does not pass ValidateRow
+    static EuropeanOption ParseRow(const std::string& line);
+
+    // Function to parse and validate a line of the input CSV file into option without throwing. Returns nullptr for
+    // a valid row, or else the reason it is rejected and leaves option unchanged: a missing or malformed field, a
+    // type other than "Call" or "Put", T, K, S or sigma not positive, or r or b not finite.
+    static const char* ValidateRow(const std::string& line, EuropeanOption& option);
+    // Function to validate a line of the input CSV file without keeping the option
+    static const char* ValidateRow(const std::string& line);
+
+    // Function to return the rows of the input file rejected by the constructor, each as "reason,line"
+    const std::vector<std::string>& Rejects() const { return m_rejects; }
+
+    // Function to build the output header for the configuration
+    std::string Header(const char& delimiter = ',') const;
+
+    // Function to price a single option into an output row
+    std::vector<std::string> PriceRow(const EuropeanOption& option) const;
+
+    // Function to price a single option and append its output row to an arena
+    void PriceRow(const EuropeanOption& option, Arena& arena, const char& delimiter = ',') const;
+
+    // Function to parse and price the first size input lines, appending the output rows to an arena. Rows that fail
+    // validation are not priced, they are appended to rejects as "reason,line" when it is given. Returns the number
+    // of rejected rows.
+    std::size_t PriceLines(const std::vector<std::string>& lines, const std::size_t& size, Arena& arena, const char& delimiter = ',',
+        Arena* rejects = nullptr) const;
+
+    // Function to price the matrix of options. The rows are returned as strings, so every row allocates its vector and
+    // its formatted values; PriceLines is the allocation-free path
     std::vector<std::vector<std::string>> Price(const std::string& output_path = "") const;
 };
 
@@ -0,0 +1,162 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// MixedPrecision.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the PrecisionReport class and the mixed precision put-call parity check
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+
+#include "MixedPrecision.hpp"
+#include "OptionBatch.hpp"
+
+// Function to accumulate the statistics of one measure
+PrecisionReport::MeasureError PrecisionReport::Compare(const std::string& name, const std::vector<float>& single,
+    const std::vector<double>& reference)
+{
+    MeasureError error;
+    error.name = name;
+
+    for (std::size_t i = 0; i < reference.size(); ++i)
+    {
+        double abs_error = std::abs(static_cast<double>(single[i]) - reference[i]);
+        error.max_abs = std::max(error.max_abs, abs_error);
+        error.rms += abs_error * abs_error;
+
+        // Relative errors of values indistinguishable from zero in float are not meaningful
+        if (std::abs(reference[i]) > 1e-6)
+        {
+            error.max_rel = std::max(error.max_rel, abs_error / std::abs(reference[i]));
+        }
+    }
+
+    if (!reference.empty())
+    {
+        error.rms = std::sqrt(error.rms / reference.size());
+    }
+
+    return error;
+}
+
+// Constructor that prices the options in float and double and compares the results
+PrecisionReport::PrecisionReport(const std::vector<EuropeanOption>& options) :
+    m_rows(options.size())
+{
+    OptionBatch<float> single(options);
+    OptionBatch<double> reference(options);
+
+    std::vector<float> single_values;
+    std::vector<double> reference_values;
+
+    single.Price(single_values);
+    reference.Price(reference_values);
+    m_errors.push_back(Compare("Price", single_values, reference_values));
+
+    single.Delta(single_values);
+    reference.Delta(reference_values);
+    m_errors.push_back(Compare("Delta", single_values, reference_values));
+
+    single.Gamma(single_values);
+    reference.Gamma(reference_values);
+    m_errors.push_back(Compare("Gamma", single_values, reference_values));
+
+    single.Vega(single_values);
+    reference.Vega(reference_values);
+    m_errors.push_back(Compare("Vega", single_values, reference_values));
+}
+
+// Copy constructor
+PrecisionReport::PrecisionReport(const PrecisionReport& source) :
+    m_rows(source.m_rows),
+    m_errors(source.m_errors)
+{}
+
+// Assignment operator
+PrecisionReport& PrecisionReport::operator=(const PrecisionReport& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_rows = source.m_rows;
+    m_errors = source.m_errors;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to return the largest relative error over all measures
+double PrecisionReport::MaxRelativeError() const
+{
+    double max_rel = 0;
+    for (const auto& error : m_errors)
+    {
+        max_rel = std::max(max_rel, error.max_rel);
+    }
+    return max_rel;
+}
+
+// Overloaded stream insertion operator
+std::ostream& operator<<(std::ostream& os, const PrecisionReport& report)
+{
+    os << "Single vs double precision over " << report.m_rows << " options" << std::endl;
+    for (const auto& error : report.m_errors)
+    {
+        os << error.name << ": max abs error " << error.max_abs << ", max rel error " << error.max_rel
+            << ", rms error " << error.rms << std::endl;
+    }
+    return os;
+}
+
+// Bound on the rounding of the single precision kernel, in units of FLT_EPSILON of the largest term of the implied
+// price. The normal distribution and the exponentials each contribute a few units, amplified through d1 and d2.
+static const float PARITY_ROUNDING_ULPS = 16;
+
+// Function to check put-call parity for a batch of options in single precision, refining borderline rows in double
+std::size_t CheckPutCallParityMixed(const std::vector<EuropeanOption>& options, const std::vector<double>& market_prices,
+    const double& threshold, std::vector<bool>& satisfied, const double& band)
+{
+    if (market_prices.size() != options.size())
+    {
+        throw std::invalid_argument("The number of market prices must match the number of options");
+    }
+
+    std::vector<float> implied_prices;
+    OptionBatch<float>(options).PricePutCallParity(implied_prices);
+
+    satisfied.assign(options.size(), false);
+    std::size_t refined = 0;
+
+    for (std::size_t i = 0; i < options.size(); ++i)
+    {
+        float implied_price = implied_prices[i];
+        float rel_diff = std::abs(static_cast<float>(market_prices[i]) - implied_price) / implied_price;
+
+        // The implied price is C + K e^(-rT) - S or P + S - K e^(-rT) and carries the float rounding of its terms,
+        // which cancel when it is small against them, as for deep in the money options. The band is widened by that
+        // error relative to the implied price, where |C| or |P| is bounded by the implied price and the other two terms.
+        const EuropeanOption& option = options[i];
+        float terms = static_cast<float>(option.K()) * std::exp(-static_cast<float>(option.r() * option.T())) +
+            static_cast<float>(option.S());
+        float error = PARITY_ROUNDING_ULPS * FLT_EPSILON * (std::abs(implied_price) + 2 * terms) / std::abs(implied_price) *
+            (1 + std::abs(rel_diff));
+
+        // Too close to the threshold for the float result to be trusted, recompute in double
+        if (!std::isfinite(rel_diff) || !std::isfinite(error) || std::abs(rel_diff - threshold) <= band + error)
+        {
+            double implied = options[i].PricePutCallParity();
+            satisfied[i] = std::abs(market_prices[i] - implied) / implied <= threshold;
+            ++refined;
+        }
+        else
+        {
+            satisfied[i] = rel_diff <= threshold;
+        }
+    }
+
+    return refined;
+}
@@ -0,0 +1,66 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// MixedPrecision.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the PrecisionReport class and the mixed precision put-call parity check
+
+// If MIXEDPRECISION_HPP is not defined
+#ifndef MIXEDPRECISION_HPP
+// Define MIXEDPRECISION_HPP
+#define MIXEDPRECISION_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <iostream>
+
+#include "../Options/EuropeanOption.hpp"
+
+// Class definition for PrecisionReport, the error of the single precision batch path measured
+// against the double precision one for Price, Delta, Gamma and Vega over a batch of options
+class PrecisionReport
+{
+private:
+
+    // Error statistics of one measure
+    struct MeasureError
+    {
+        std::string name;
+        double max_abs = 0; // Largest absolute error
+        double max_rel = 0; // Largest error relative to the double value
+        double rms = 0; // Root mean square of the absolute errors
+    };
+
+    std::size_t m_rows; // Number of options compared
+    std::vector<MeasureError> m_errors; // One entry per measure
+
+    // Function to accumulate the statistics of one measure
+    static MeasureError Compare(const std::string& name, const std::vector<float>& single, const std::vector<double>& reference);
+
+public:
+
+    // Constructor that prices the options in float and double and compares the results
+    PrecisionReport(const std::vector<EuropeanOption>& options);
+
+    // Copy constructor
+    PrecisionReport(const PrecisionReport& source);
+
+    // Assignment operator
+    PrecisionReport& operator=(const PrecisionReport& source);
+
+    // Function to return the largest relative error over all measures
+    double MaxRelativeError() const;
+
+    // Overloaded stream insertion operator
+    friend std::ostream& operator<<(std::ostream& os, const PrecisionReport& report);
+};
+
+// Function to check put-call parity for a batch of options against the market prices of their associated options.
+// The check runs in single precision and only the rows whose relative difference lies within band of the threshold,
+// widened by a bound on the float rounding of the row, are recomputed in double. That bound grows as the terms of the
+// implied price cancel, so the rows with a small implied price against K and S are refined. satisfied[i] receives the result of row i
+// and the function returns the number of rows refined in double.
+std::size_t CheckPutCallParityMixed(const std::vector<EuropeanOption>& options, const std::vector<double>& market_prices,
+    const double& threshold, std::vector<bool>& satisfied, const double& band = 1e-4);
+
+// End of the conditional inclusion of the header file
+#endif
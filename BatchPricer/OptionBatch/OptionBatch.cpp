@@ -0,0 +1,139 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// OptionBatch.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the templated OptionBatch class
+
+// If OPTIONBATCH_CPP is not defined
+#ifndef OPTIONBATCH_CPP
+// Define OPTIONBATCH_CPP
+#define OPTIONBATCH_CPP
+
+#include <vector>
+
+#include "OptionBatch.hpp"
+#include "../Options/BlackScholes.hpp"
+
+// Default constructor
+template <typename Real>
+OptionBatch<Real>::OptionBatch()
+{}
+
+// Constructor with a vector of options
+template <typename Real>
+OptionBatch<Real>::OptionBatch(const std::vector<EuropeanOption>& options)
+{
+    m_call.reserve(options.size());
+    m_T.reserve(options.size());
+    m_K.reserve(options.size());
+    m_S.reserve(options.size());
+    m_r.reserve(options.size());
+    m_sigma.reserve(options.size());
+    m_b.reserve(options.size());
+
+    for (const auto& option : options)
+    {
+        Add(option);
+    }
+}
+
+// Copy constructor
+template <typename Real>
+OptionBatch<Real>::OptionBatch(const OptionBatch& source) :
+    m_call(source.m_call),
+    m_T(source.m_T),
+    m_K(source.m_K),
+    m_S(source.m_S),
+    m_r(source.m_r),
+    m_sigma(source.m_sigma),
+    m_b(source.m_b)
+{}
+
+// Assignment operator
+template <typename Real>
+OptionBatch<Real>& OptionBatch<Real>::operator=(const OptionBatch& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_call = source.m_call;
+    m_T = source.m_T;
+    m_K = source.m_K;
+    m_S = source.m_S;
+    m_r = source.m_r;
+    m_sigma = source.m_sigma;
+    m_b = source.m_b;
+
+    return *this;
+}
+
+// Function to append an option to the batch
+template <typename Real>
+void OptionBatch<Real>::Add(const EuropeanOption& option)
+{
+    m_call.push_back(option.type() == "Call");
+    m_T.push_back(static_cast<Real>(option.T()));
+    m_K.push_back(static_cast<Real>(option.K()));
+    m_S.push_back(static_cast<Real>(option.S()));
+    m_r.push_back(static_cast<Real>(option.r()));
+    m_sigma.push_back(static_cast<Real>(option.sigma()));
+    m_b.push_back(static_cast<Real>(option.b()));
+}
+
+// Function to price every option of the batch
+template <typename Real>
+void OptionBatch<Real>::Price(std::vector<Real>& out) const
+{
+    out.resize(Size());
+    for (std::size_t i = 0; i < Size(); ++i)
+    {
+        out[i] = BlackScholesPrice<Real>(m_call[i] != 0, m_T[i], m_K[i], m_S[i], m_r[i], m_sigma[i], m_b[i]);
+    }
+}
+
+// Function to price the associated option of every option of the batch using put-call parity
+template <typename Real>
+void OptionBatch<Real>::PricePutCallParity(std::vector<Real>& out) const
+{
+    out.resize(Size());
+    for (std::size_t i = 0; i < Size(); ++i)
+    {
+        out[i] = BlackScholesPricePutCallParity<Real>(m_call[i] != 0, m_T[i], m_K[i], m_S[i], m_r[i], m_sigma[i], m_b[i]);
+    }
+}
+
+// Function to calculate the Delta of every option of the batch
+template <typename Real>
+void OptionBatch<Real>::Delta(std::vector<Real>& out) const
+{
+    out.resize(Size());
+    for (std::size_t i = 0; i < Size(); ++i)
+    {
+        out[i] = BlackScholesDelta<Real>(m_call[i] != 0, m_T[i], m_K[i], m_S[i], m_r[i], m_sigma[i], m_b[i]);
+    }
+}
+
+// Function to calculate the Gamma of every option of the batch
+template <typename Real>
+void OptionBatch<Real>::Gamma(std::vector<Real>& out) const
+{
+    out.resize(Size());
+    for (std::size_t i = 0; i < Size(); ++i)
+    {
+        out[i] = BlackScholesGamma<Real>(m_T[i], m_K[i], m_S[i], m_r[i], m_sigma[i], m_b[i]);
+    }
+}
+
+// Function to calculate the Vega of every option of the batch
+template <typename Real>
+void OptionBatch<Real>::Vega(std::vector<Real>& out) const
+{
+    out.resize(Size());
+    for (std::size_t i = 0; i < Size(); ++i)
+    {
+        out[i] = BlackScholesVega<Real>(m_T[i], m_K[i], m_S[i], m_r[i], m_sigma[i], m_b[i]);
+    }
+}
+
+// End of the conditional inclusion of the header file
+#endif
@@ -0,0 +1,65 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// OptionBatch.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the templated OptionBatch class
+
+// If OPTIONBATCH_HPP is not defined
+#ifndef OPTIONBATCH_HPP
+// Define OPTIONBATCH_HPP
+#define OPTIONBATCH_HPP
+
+#include <vector>
+#include <cstddef>
+
+#include "../Options/EuropeanOption.hpp"
+
+// Define the OptionBatch class, a structure-of-arrays copy of a batch of European options stored in the
+// scalar type Real. Each parameter lives in its own contiguous array so the pricing loops stream through
+// memory; with Real = float the batch takes half the memory bandwidth and twice the SIMD lanes of double.
+template <typename Real>
+class OptionBatch
+{
+private:
+    std::vector<unsigned char> m_call; // 1 for calls, 0 for puts
+    std::vector<Real> m_T; // Times to expiration
+    std::vector<Real> m_K; // Strike prices
+    std::vector<Real> m_S; // Spot prices
+    std::vector<Real> m_r; // Risk-free interest rates
+    std::vector<Real> m_sigma; // Volatilities
+    std::vector<Real> m_b; // Costs of carry
+
+public:
+    // Default constructor
+    OptionBatch();
+
+    // Constructor with a vector of options
+    OptionBatch(const std::vector<EuropeanOption>& options);
+
+    // Copy constructor
+    OptionBatch(const OptionBatch& source);
+
+    // Assignment operator
+    OptionBatch& operator=(const OptionBatch& source);
+
+    // Function to append an option to the batch
+    void Add(const EuropeanOption& option);
+
+    // Function to return the number of options in the batch
+    std::size_t Size() const { return m_T.size(); }
+
+    // Functions to evaluate a measure for every option of the batch into out
+    void Price(std::vector<Real>& out) const;
+    void PricePutCallParity(std::vector<Real>& out) const;
+    void Delta(std::vector<Real>& out) const;
+    void Gamma(std::vector<Real>& out) const;
+    void Vega(std::vector<Real>& out) const;
+};
+
+// Must be the same name as in source file #define
+#ifndef OPTIONBATCH_CPP
+#include "OptionBatch.cpp"
+#endif
+// It includes the contents of OptionBatch.cpp in the header file of OPTIONBATCH_CPP is not already defined
+
+// End of the conditional inclusion of the header file
+#endif
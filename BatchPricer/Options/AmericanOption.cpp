@@ -96,6 +96,53 @@ double AmericanOption::Price() const
 	}
 }
 
+// Calculate the Delta of the option
+double AmericanOption::Delta() const
+{
+	double value = 0;
+	Measures<MEASURE_DELTA>(MEASURE_DELTA, 0, &value);
+	return value;
+}
+
+// Calculate the Gamma of the option
+double AmericanOption::Gamma() const
+{
+	double value = 0;
+	Measures<MEASURE_GAMMA>(MEASURE_GAMMA, 0, &value);
+	return value;
+}
+
+// Calculate the Vega of the option
+double AmericanOption::Vega() const
+{
+	double value = 0;
+	Measures<MEASURE_VEGA>(MEASURE_VEGA, 0, &value);
+	return value;
+}
+
+// Calculate the Rho of the option, the cost of carry is held fixed
+double AmericanOption::Rho() const
+{
+	double value = 0;
+	Measures<MEASURE_RHO>(MEASURE_RHO, 0, &value);
+	return value;
+}
+
+// Calculate the sensitivity of the option to the cost of carry
+double AmericanOption::CarryRho() const
+{
+	double value = 0;
+	Measures<MEASURE_CARRY_RHO>(MEASURE_CARRY_RHO, 0, &value);
+	return value;
+}
+
+// Calculate the optimal exercise boundary, y / (y - 1) * K with y = Y1 for calls and y = Y2 for puts
+double AmericanOption::ExerciseBoundary() const
+{
+	double y = m_type == "Call" ? Y1() : Y2();
+	return y / (y - 1) * m_K;
+}
+
 // Calculate the AmericanOption Delta of the option
 double AmericanOption::NumericDelta(const double& h) const
 {
@@ -9,6 +9,8 @@
 
 #include <string>
 #include <vector>
+#include <limits>
+#include <cmath>
 #include "Option.hpp"
 
 // Class definition for American perpetual option
@@ -38,6 +40,25 @@ private:
 
 public:
 
+	// Measure flags, combined into a bitmask to select the outputs of the fused Measures() kernel
+	enum MeasureFlag : unsigned int
+	{
+		MEASURE_PRICE = 1u << 0,
+		MEASURE_NUMERIC_DELTA = 1u << 1,
+		MEASURE_NUMERIC_GAMMA = 1u << 2,
+		MEASURE_DELTA = 1u << 3,
+		MEASURE_GAMMA = 1u << 4,
+		MEASURE_VEGA = 1u << 5,
+		MEASURE_RHO = 1u << 6,
+		MEASURE_CARRY_RHO = 1u << 7,
+		// Number of measures
+		MEASURE_COUNT = 8,
+		// Configurations
+		MEASURE_CONFIG_PRICE = MEASURE_PRICE,
+		MEASURE_CONFIG_BASIC = MEASURE_PRICE | MEASURE_DELTA | MEASURE_GAMMA | MEASURE_VEGA | MEASURE_RHO | MEASURE_CARRY_RHO,
+		MEASURE_CONFIG_ALL = (1u << 8) - 1
+	};
+
 	// Standard functions
 	AmericanOption(const std::string& type, const double& K, const double& S, const double& r,
 		const double& sigma, const double& b = std::numeric_limits<double>::quiet_NaN(), const int& id = 1);
@@ -48,10 +69,24 @@ public:
 	// Pricing function
 	double Price() const;
 
+	// Sensitivity functions, closed-form derivatives of the perpetual formula
+	double Delta() const;
+	double Gamma() const;
+	double Vega() const;
+	double Rho() const;
+	double CarryRho() const;
+
 	// Numeric functions
 	double NumericDelta(const double& h) const;
 	double NumericGamma(const double& h) const;
 
+	// Optimal exercise boundary, the spot at or beyond which the holder exercises
+	double ExerciseBoundary() const;
+
+	// Fused kernel, calculates the measures selected by Mask (and by mask at run time), returns the number of values written
+	template <unsigned int Mask>
+	int Measures(const unsigned int& mask, const double& h, double* out) const;
+
 	// Parameter modification functions
 	AmericanOption& type(const std::string& type);
 	AmericanOption& K(const double& K);
@@ -78,5 +113,64 @@ public:
 
 };
 
+// Calculate the measures selected by Mask, and among those by mask at run time, writing them to out in flag order.
+// The base price and the up/down shifted prices are shared, so Price, NumericDelta and NumericGamma together
+// cost three pricings instead of five. The analytic sensitivities reuse the base price: with y = Y1 for calls and
+// y = Y2 for puts, V = K / |y - 1| * x^y where x = (y - 1) / y * S / K, so dV/dS = y * V / S, d2V/dS2 = y * (y - 1) * V / S^2
+// and dV/dy = V * ln(x), which the chain rule through y gives Vega, Rho (b held fixed) and CarryRho.
+// Measures outside Mask are removed at compile time, and the intermediates of measures outside mask are skipped at run time.
+template <unsigned int Mask>
+int AmericanOption::Measures(const unsigned int& mask, const double& h, double* out) const
+{
+	constexpr unsigned int analytic = MEASURE_DELTA | MEASURE_GAMMA | MEASURE_VEGA | MEASURE_RHO | MEASURE_CARRY_RHO;
+	// The work a measure needs is skipped when the measure is outside Mask at compile time or outside mask at run time
+	const unsigned int selected = Mask & mask;
+	const bool need_price = (selected & (MEASURE_PRICE | MEASURE_NUMERIC_GAMMA | analytic)) != 0;
+	const bool need_shift = (selected & (MEASURE_NUMERIC_DELTA | MEASURE_NUMERIC_GAMMA)) != 0;
+	const bool need_y = (selected & analytic) != 0;
+	const bool need_dy = (selected & (MEASURE_VEGA | MEASURE_RHO | MEASURE_CARRY_RHO)) != 0;
+
+	double price = 0, up_price = 0, down_price = 0;
+	if (need_price) price = Price();
+	if (need_shift)
+	{
+		up_price = AmericanOption(m_type, m_K, m_S + h, m_r, m_sigma, m_b, m_id).Price();
+		down_price = AmericanOption(m_type, m_K, m_S - h, m_r, m_sigma, m_b, m_id).Price();
+	}
+
+	// Root of the characteristic equation and its ingredients, Y1 = -a + root and Y2 = -a - root
+	double sigma2 = 0, a = 0, root = 0, sign = 0, y = 0, dprice_dy = 0;
+	if (need_y)
+	{
+		sigma2 = m_sigma * m_sigma;
+		a = m_b / sigma2 - 0.5;
+		root = std::sqrt(a * a + 2 * m_r / sigma2);
+		sign = m_type == "Call" ? 1.0 : -1.0;
+		y = -a + sign * root;
+	}
+	if (need_dy) dprice_dy = price * std::log((y - 1) / y * (m_S / m_K));
+
+	int n = 0;
+
+	if constexpr ((Mask & MEASURE_PRICE) != 0)
+		if (mask & MEASURE_PRICE) out[n++] = price;
+	if constexpr ((Mask & MEASURE_NUMERIC_DELTA) != 0)
+		if (mask & MEASURE_NUMERIC_DELTA) out[n++] = (up_price - down_price) / (2 * h);
+	if constexpr ((Mask & MEASURE_NUMERIC_GAMMA) != 0)
+		if (mask & MEASURE_NUMERIC_GAMMA) out[n++] = (up_price - 2 * price + down_price) / (h * h);
+	if constexpr ((Mask & MEASURE_DELTA) != 0)
+		if (mask & MEASURE_DELTA) out[n++] = y * price / m_S;
+	if constexpr ((Mask & MEASURE_GAMMA) != 0)
+		if (mask & MEASURE_GAMMA) out[n++] = y * (y - 1) * price / (m_S * m_S);
+	if constexpr ((Mask & MEASURE_VEGA) != 0)
+		if (mask & MEASURE_VEGA) out[n++] = dprice_dy * (2 * m_b - sign * 2 * (a * m_b + m_r) / root) / (sigma2 * m_sigma);
+	if constexpr ((Mask & MEASURE_RHO) != 0)
+		if (mask & MEASURE_RHO) out[n++] = dprice_dy * sign / (sigma2 * root);
+	if constexpr ((Mask & MEASURE_CARRY_RHO) != 0)
+		if (mask & MEASURE_CARRY_RHO) out[n++] = dprice_dy * (sign * a / root - 1) / sigma2;
+
+	return n;
+}
+
 // AMERICANOPTION_HPP
 #endif
\ No newline at end of file
@@ -0,0 +1,271 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// BlackScholes.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code of the Black-Scholes kernels templated on the scalar type
+
+// Header guard to avoid multiple inclusions
+#ifndef BLACKSCHOLES_CPP
+#define BLACKSCHOLES_CPP
+
+#include <cmath>
+#include <boost/math/distributions/normal.hpp>
+#include <boost/math/constants/constants.hpp>
+#include "BlackScholes.hpp"
+
+// Cumulative distribution function for the standard normal distribution
+template <typename Real>
+Real NormalCdf(const Real& x)
+{
+	return boost::math::cdf(boost::math::normal_distribution<Real>(), x);
+}
+
+// Probability density function for the standard normal distribution
+template <typename Real>
+Real NormalPdf(const Real& x)
+{
+	return 1 / std::sqrt(2 * boost::math::constants::pi<Real>()) * std::exp(-(x * x / 2));
+}
+
+// Function to calculate d1 in the Black-Scholes formula
+template <typename Real>
+Real BlackScholesD1(const Real& T, const Real& K, const Real& S, const Real& sigma, const Real& b)
+{
+	return BlackScholesD1(T, K, S, sigma, b, std::sqrt(T));
+}
+
+// Function to calculate d1 with the square root of the time to expiration given
+template <typename Real>
+Real BlackScholesD1(const Real& T, const Real& K, const Real& S, const Real& sigma, const Real& b, const Real& sqrtT)
+{
+	return (std::log(S / K) + (b + sigma * sigma / 2) * T) / (sigma * sqrtT);
+}
+
+// Function to evaluate the intermediates of an option
+template <typename Real>
+BlackScholesTerms<Real> BlackScholesEvaluate(const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma,
+	const Real& b, const unsigned int& terms)
+{
+	return BlackScholesEvaluate(T, K, S, r, sigma, b, std::sqrt(T), std::exp((b - r) * T), std::exp(-r * T), terms);
+}
+
+// Function to evaluate the intermediates of an option with the factors of T, r and b given
+template <typename Real>
+BlackScholesTerms<Real> BlackScholesEvaluate(const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma,
+	const Real& b, const Real& sqrtT, const Real& carry, const Real& disc, const unsigned int& terms)
+{
+	BlackScholesTerms<Real> x = { T, K, S, r, sigma, b, sqrtT, 0, 0, 0, 0, 0, carry, disc };
+
+	x.d1 = BlackScholesD1(T, K, S, sigma, b, sqrtT);
+	x.d2 = x.d1 - sigma * sqrtT;
+	if (terms & BLACKSCHOLES_N_D1) x.Nd1 = NormalCdf(x.d1);
+	if (terms & BLACKSCHOLES_N_D2) x.Nd2 = NormalCdf(x.d2);
+	if (terms & BLACKSCHOLES_N_PRIME_D1) x.nd1 = NormalPdf(x.d1);
+
+	return x;
+}
+
+// Calculate the price of the option
+template <typename Real>
+Real BlackScholesPrice(const bool& call, const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma, const Real& b)
+{
+	return BlackScholesPrice(call, BlackScholesEvaluate(T, K, S, r, sigma, b, BLACKSCHOLES_N_D1 | BLACKSCHOLES_N_D2));
+}
+
+// Calculate the price of the associated option using put-call parity
+template <typename Real>
+Real BlackScholesPricePutCallParity(const bool& call, const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma,
+	const Real& b)
+{
+	return BlackScholesPricePutCallParity(call, BlackScholesEvaluate(T, K, S, r, sigma, b, BLACKSCHOLES_N_D1 | BLACKSCHOLES_N_D2));
+}
+
+// Calculate the Delta of the option
+template <typename Real>
+Real BlackScholesDelta(const bool& call, const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma, const Real& b)
+{
+	return BlackScholesDelta(call, BlackScholesEvaluate(T, K, S, r, sigma, b, BLACKSCHOLES_N_D1));
+}
+
+// Calculate the Gamma of the option
+template <typename Real>
+Real BlackScholesGamma(const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma, const Real& b)
+{
+	return BlackScholesGamma(BlackScholesEvaluate(T, K, S, r, sigma, b, BLACKSCHOLES_N_PRIME_D1));
+}
+
+// Calculate the Vega of the option
+template <typename Real>
+Real BlackScholesVega(const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma, const Real& b)
+{
+	return BlackScholesVega(BlackScholesEvaluate(T, K, S, r, sigma, b, BLACKSCHOLES_N_PRIME_D1));
+}
+
+// Calculate the Theta of the option
+template <typename Real>
+Real BlackScholesTheta(const bool& call, const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma, const Real& b)
+{
+	return BlackScholesTheta(call, BlackScholesEvaluate(T, K, S, r, sigma, b, BLACKSCHOLES_ALL_TERMS));
+}
+
+// Calculate the Rho of the option
+template <typename Real>
+Real BlackScholesRho(const bool& call, const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma, const Real& b)
+{
+	return BlackScholesRho(call, BlackScholesEvaluate(T, K, S, r, sigma, b, BLACKSCHOLES_N_D2));
+}
+
+// Calculate the price of the option from its intermediates
+template <typename Real>
+Real BlackScholesPrice(const bool& call, const BlackScholesTerms<Real>& x)
+{
+	if (call)
+	{
+		return x.S * x.carry * x.Nd1 - x.K * x.disc * x.Nd2;
+	}
+
+	return x.K * x.disc * (1 - x.Nd2) - x.S * x.carry * (1 - x.Nd1);
+}
+
+// Calculate the price of the associated option using put-call parity from the intermediates
+template <typename Real>
+Real BlackScholesPricePutCallParity(const bool& call, const BlackScholesTerms<Real>& x)
+{
+	if (call)
+	{
+		return BlackScholesPrice(call, x) + x.K * x.disc - x.S;
+	}
+
+	return BlackScholesPrice(call, x) + x.S - x.K * x.disc;
+}
+
+// Calculate the Delta of the option from its intermediates
+template <typename Real>
+Real BlackScholesDelta(const bool& call, const BlackScholesTerms<Real>& x)
+{
+	if (call)
+	{
+		return x.carry * x.Nd1;
+	}
+
+	return -x.carry * (1 - x.Nd1);
+}
+
+// Calculate the Gamma of the option from its intermediates
+template <typename Real>
+Real BlackScholesGamma(const BlackScholesTerms<Real>& x)
+{
+	return x.nd1 * x.carry / (x.S * x.sigma * x.sqrtT);
+}
+
+// Calculate the Vega of the option from its intermediates
+template <typename Real>
+Real BlackScholesVega(const BlackScholesTerms<Real>& x)
+{
+	return x.S * x.sqrtT * x.carry * x.nd1;
+}
+
+// Calculate the Theta of the option from its intermediates
+template <typename Real>
+Real BlackScholesTheta(const bool& call, const BlackScholesTerms<Real>& x)
+{
+	Real decay = -x.S * x.sigma * x.carry * x.nd1 / (2 * x.sqrtT);
+
+	if (call)
+	{
+		return decay - (x.b - x.r) * x.S * x.carry * x.Nd1 - x.r * x.K * x.disc * x.Nd2;
+	}
+
+	return decay - (x.b - x.r) * x.S * x.carry * (1 - x.Nd1) - x.r * x.K * x.disc * (1 - x.Nd2);
+}
+
+// Calculate the Rho of the option from its intermediates
+template <typename Real>
+Real BlackScholesRho(const bool& call, const BlackScholesTerms<Real>& x)
+{
+	if (call)
+	{
+		return x.K * x.T * x.disc * x.Nd2;
+	}
+
+	return -x.K * x.T * x.disc * (1 - x.Nd2);
+}
+
+// Calculate the Vanna of the option from its intermediates
+template <typename Real>
+Real BlackScholesVanna(const BlackScholesTerms<Real>& x)
+{
+	return x.carry * x.nd1 * (x.d1 / x.sigma - 1) * x.S * x.sqrtT;
+}
+
+// Calculate the Charm of the option from its intermediates
+template <typename Real>
+Real BlackScholesCharm(const bool& call, const BlackScholesTerms<Real>& x)
+{
+	Real term1 = -x.carry * x.nd1 * (2 * (x.r - x.b) * x.T - x.d2 * x.sigma * x.sqrtT) / (2 * x.T * x.sigma * x.sqrtT);
+
+	if (call)
+	{
+		return term1 - (x.r - x.b) * x.carry * x.Nd1;
+	}
+
+	return term1 + (x.r - x.b) * x.carry * (1 - x.Nd1);
+}
+
+// Calculate the Speed of the option from its intermediates
+template <typename Real>
+Real BlackScholesSpeed(const BlackScholesTerms<Real>& x)
+{
+	return -x.nd1 * x.carry * (x.d1 / (x.S * x.S * x.sigma * x.sqrtT));
+}
+
+// Calculate the Color of the option from its intermediates
+template <typename Real>
+Real BlackScholesColor(const BlackScholesTerms<Real>& x)
+{
+	return -x.nd1 * x.carry * (2 * (x.r - x.b) * x.T - x.d1 * x.sigma * x.sqrtT) / (2 * x.T * x.S * x.sigma * x.sqrtT);
+}
+
+// Calculate the DvegaDtime of the option from its intermediates
+template <typename Real>
+Real BlackScholesDvegaDtime(const BlackScholesTerms<Real>& x)
+{
+	return x.S * x.sqrtT * x.carry * x.nd1 * (x.r - x.b - x.d1 * x.sigma / (2 * x.sqrtT));
+}
+
+// Calculate the Vomma of the option from its intermediates
+template <typename Real>
+Real BlackScholesVomma(const BlackScholesTerms<Real>& x)
+{
+	return BlackScholesVega(x) * x.d1 * (x.d1 - 1) / x.sigma;
+}
+
+// Calculate the Veta of the option from its intermediates
+template <typename Real>
+Real BlackScholesVeta(const BlackScholesTerms<Real>& x)
+{
+	return -x.S * x.carry * x.nd1 * x.sqrtT * (x.r - x.b + (x.d1 * x.sigma) / (2 * x.sqrtT));
+}
+
+// Calculate the Zomma of the option from its intermediates
+template <typename Real>
+Real BlackScholesZomma(const BlackScholesTerms<Real>& x)
+{
+	return BlackScholesGamma(x) * (x.d1 * (x.d1 - 1) - 1) / x.sigma;
+}
+
+// Calculate the Lambda of the option from its intermediates
+template <typename Real>
+Real BlackScholesLambda(const bool& call, const BlackScholesTerms<Real>& x)
+{
+	return BlackScholesDelta(call, x) * (x.S / BlackScholesPrice(call, x));
+}
+
+// Calculate the Ultima of the option from its intermediates
+template <typename Real>
+Real BlackScholesUltima(const BlackScholesTerms<Real>& x)
+{
+	return -BlackScholesVega(x) * (x.d1 * (x.d1 - 3) * (x.d1 - 1) - 1) / (x.sigma * x.sigma);
+}
+
+// BLACKSCHOLES_CPP
+#endif
@@ -0,0 +1,167 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// BlackScholes.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code of the Black-Scholes kernels templated on the scalar type
+
+// Header guard to avoid multiple inclusions
+#ifndef BLACKSCHOLES_HPP
+#define BLACKSCHOLES_HPP
+
+// Kernels of the generalized Black-Scholes model (cost of carry b) for a scalar type Real (float or double).
+// EuropeanOption evaluates its measures with them for Real = double; with Real = float every operation,
+// including the normal distribution, is carried out in single precision storage.
+
+// Intermediates evaluated only on request, combined into a bitmask
+enum BlackScholesTerm : unsigned int
+{
+	BLACKSCHOLES_N_D1 = 1u << 0, // N(d1)
+	BLACKSCHOLES_N_D2 = 1u << 1, // N(d2)
+	BLACKSCHOLES_N_PRIME_D1 = 1u << 2, // n(d1)
+	BLACKSCHOLES_ALL_TERMS = (1u << 3) - 1
+};
+
+// Parameters of an option and the intermediates of the formulas, which the measure kernels read instead of
+// evaluating them again
+template <typename Real>
+struct BlackScholesTerms
+{
+	Real T, K, S, r, sigma, b; // Parameters of the option
+	Real sqrtT; // Square root of the time to expiration
+	Real d1, d2;
+	Real Nd1, Nd2, nd1; // N(d1), N(d2) and n(d1), zero when they were not requested
+	Real carry; // Carry factor exp((b - r)T)
+	Real disc; // Discount factor exp(-rT)
+};
+
+// Standard normal cumulative distribution function
+template <typename Real>
+Real NormalCdf(const Real& x);
+
+// Standard normal probability density function
+template <typename Real>
+Real NormalPdf(const Real& x);
+
+// Calculate d1 for Black-Scholes formula
+template <typename Real>
+Real BlackScholesD1(const Real& T, const Real& K, const Real& S, const Real& sigma, const Real& b);
+
+// Calculate d1 with the square root of the time to expiration computed beforehand
+template <typename Real>
+Real BlackScholesD1(const Real& T, const Real& K, const Real& S, const Real& sigma, const Real& b, const Real& sqrtT);
+
+// Evaluate the intermediates of an option, N(d1), N(d2) and n(d1) only when they are selected in terms
+template <typename Real>
+BlackScholesTerms<Real> BlackScholesEvaluate(const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma,
+	const Real& b, const unsigned int& terms = BLACKSCHOLES_ALL_TERMS);
+
+// Evaluate the intermediates of an option with the square root of T and the carry and discount factors computed beforehand
+template <typename Real>
+BlackScholesTerms<Real> BlackScholesEvaluate(const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma,
+	const Real& b, const Real& sqrtT, const Real& carry, const Real& disc, const unsigned int& terms);
+
+// Calculate the option price
+template <typename Real>
+Real BlackScholesPrice(const bool& call, const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma, const Real& b);
+
+// Calculate the price of the associated option using put-call parity
+template <typename Real>
+Real BlackScholesPricePutCallParity(const bool& call, const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma,
+	const Real& b);
+
+// Calculate Delta
+template <typename Real>
+Real BlackScholesDelta(const bool& call, const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma, const Real& b);
+
+// Calculate Gamma
+template <typename Real>
+Real BlackScholesGamma(const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma, const Real& b);
+
+// Calculate Vega
+template <typename Real>
+Real BlackScholesVega(const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma, const Real& b);
+
+// Calculate Theta
+template <typename Real>
+Real BlackScholesTheta(const bool& call, const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma, const Real& b);
+
+// Calculate Rho
+template <typename Real>
+Real BlackScholesRho(const bool& call, const Real& T, const Real& K, const Real& S, const Real& r, const Real& sigma, const Real& b);
+
+// Kernels on the intermediates of an option, each one reads N(d1), N(d2) and n(d1) only if its formula has them
+
+// Calculate the option price
+template <typename Real>
+Real BlackScholesPrice(const bool& call, const BlackScholesTerms<Real>& x);
+
+// Calculate the price of the associated option using put-call parity
+template <typename Real>
+Real BlackScholesPricePutCallParity(const bool& call, const BlackScholesTerms<Real>& x);
+
+// Calculate Delta
+template <typename Real>
+Real BlackScholesDelta(const bool& call, const BlackScholesTerms<Real>& x);
+
+// Calculate Gamma
+template <typename Real>
+Real BlackScholesGamma(const BlackScholesTerms<Real>& x);
+
+// Calculate Vega
+template <typename Real>
+Real BlackScholesVega(const BlackScholesTerms<Real>& x);
+
+// Calculate Theta
+template <typename Real>
+Real BlackScholesTheta(const bool& call, const BlackScholesTerms<Real>& x);
+
+// Calculate Rho
+template <typename Real>
+Real BlackScholesRho(const bool& call, const BlackScholesTerms<Real>& x);
+
+// Calculate Vanna
+template <typename Real>
+Real BlackScholesVanna(const BlackScholesTerms<Real>& x);
+
+// Calculate Charm
+template <typename Real>
+Real BlackScholesCharm(const bool& call, const BlackScholesTerms<Real>& x);
+
+// Calculate Speed
+template <typename Real>
+Real BlackScholesSpeed(const BlackScholesTerms<Real>& x);
+
+// Calculate Color
+template <typename Real>
+Real BlackScholesColor(const BlackScholesTerms<Real>& x);
+
+// Calculate DvegaDtime
+template <typename Real>
+Real BlackScholesDvegaDtime(const BlackScholesTerms<Real>& x);
+
+// Calculate Vomma
+template <typename Real>
+Real BlackScholesVomma(const BlackScholesTerms<Real>& x);
+
+// Calculate Veta
+template <typename Real>
+Real BlackScholesVeta(const BlackScholesTerms<Real>& x);
+
+// Calculate Zomma
+template <typename Real>
+Real BlackScholesZomma(const BlackScholesTerms<Real>& x);
+
+// Calculate Lambda
+template <typename Real>
+Real BlackScholesLambda(const bool& call, const BlackScholesTerms<Real>& x);
+
+// Calculate Ultima
+template <typename Real>
+Real BlackScholesUltima(const BlackScholesTerms<Real>& x);
+
+// Must be the same name as in source file #define
+#ifndef BLACKSCHOLES_CPP
+#include "BlackScholes.cpp"
+#endif
+
+// BLACKSCHOLES_HPP
+#endif
@@ -6,45 +6,167 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <stdexcept>
 #include <boost/math/distributions/normal.hpp>
 #include <boost/math/constants/constants.hpp>
 #include "EuropeanOption.hpp"
+#include "BlackScholes.hpp"
 
-// Function to calculate d1 in the Black-Scholes formula
-double EuropeanOption::D1() const
+// Function to check that an option type is "Call" or "Put", the Greeks price any other type as a put
+const std::string& EuropeanOption::ValidType(const std::string& type)
 {
-	return (log(m_S / m_K) + (m_b + m_sigma * m_sigma / 2) * m_T) / (m_sigma * std::sqrt(m_T));
+	if (type != "Call" && type != "Put")
+	{
+		throw std::invalid_argument("Unknown option type: " + type);
+	}
+
+	return type;
+}
+
+// Square root of the time to expiration, cached
+double EuropeanOption::CachedSqrtT() const
+{
+	if (!(m_cached & CACHE_SQRT_T))
+	{
+		m_sqrtT = std::sqrt(m_T);
+		m_cached |= CACHE_SQRT_T;
+	}
+	return m_sqrtT;
+}
+
+// d1, cached
+double EuropeanOption::CachedD1() const
+{
+	if (!(m_cached & CACHE_D1))
+	{
+		m_d1 = BlackScholesD1(m_T, m_K, m_S, m_sigma, m_b, CachedSqrtT());
+		m_cached |= CACHE_D1;
+	}
+	return m_d1;
 }
 
-// Function to calculate d2 in the Black-Scholes formula
-double EuropeanOption::D2(const double& d1) const
+// d2, cached
+double EuropeanOption::CachedD2() const
 {
-	return d1 - m_sigma * std::sqrt(m_T);
+	if (!(m_cached & CACHE_D2))
+	{
+		m_d2 = CachedD1() - m_sigma * CachedSqrtT();
+		m_cached |= CACHE_D2;
+	}
+	return m_d2;
 }
 
-// Cumulative distribution function for the standard normal distribution
-double EuropeanOption::N(double x) const
+// N(d1), cached
+double EuropeanOption::CachedN_d1() const
 {
-	return boost::math::cdf(boost::math::normal(), x);
+	if (!(m_cached & CACHE_N_D1))
+	{
+		m_Nd1 = NormalCdf(CachedD1());
+		m_cached |= CACHE_N_D1;
+	}
+	return m_Nd1;
 }
 
-// Probability density function for the standard normal distribution
-double EuropeanOption::N_prime(double x) const
+// N(d2), cached
+double EuropeanOption::CachedN_d2() const
 {
-	return 1 / sqrt(2 * boost::math::constants::pi<double>()) * exp(-(x * x / 2));
+	if (!(m_cached & CACHE_N_D2))
+	{
+		m_Nd2 = NormalCdf(CachedD2());
+		m_cached |= CACHE_N_D2;
+	}
+	return m_Nd2;
+}
+
+// n(d1), cached
+double EuropeanOption::CachedN_prime_d1() const
+{
+	if (!(m_cached & CACHE_N_PRIME_D1))
+	{
+		m_nd1 = NormalPdf(CachedD1());
+		m_cached |= CACHE_N_PRIME_D1;
+	}
+	return m_nd1;
+}
+
+// Carry factor exp((b - r)T), cached
+double EuropeanOption::CachedCarry() const
+{
+	if (!(m_cached & CACHE_CARRY))
+	{
+		m_carry = std::exp((m_b - m_r) * m_T);
+		m_cached |= CACHE_CARRY;
+	}
+	return m_carry;
+}
+
+// Discount factor exp(-rT), cached
+double EuropeanOption::CachedDisc() const
+{
+	if (!(m_cached & CACHE_DISC))
+	{
+		m_disc = std::exp(-m_r * m_T);
+		m_cached |= CACHE_DISC;
+	}
+	return m_disc;
+}
+
+// Intermediates of the formulas for the current parameters, from the cache when the option memoizes
+BlackScholesTerms<double> EuropeanOption::Terms(const unsigned int& terms) const
+{
+	if (!m_memoize)
+	{
+		return BlackScholesEvaluate(m_T, m_K, m_S, m_r, m_sigma, m_b, terms);
+	}
+
+	BlackScholesTerms<double> x = { m_T, m_K, m_S, m_r, m_sigma, m_b, CachedSqrtT(), CachedD1(), CachedD2(), 0, 0, 0,
+		CachedCarry(), CachedDisc() };
+
+	if (terms & BLACKSCHOLES_N_D1) x.Nd1 = CachedN_d1();
+	if (terms & BLACKSCHOLES_N_D2) x.Nd2 = CachedN_d2();
+	if (terms & BLACKSCHOLES_N_PRIME_D1) x.nd1 = CachedN_prime_d1();
+
+	return x;
+}
+
+// Factors of the time to expiration, risk-free rate and cost of carry used by the fused kernel
+EuropeanOption::TermFactors EuropeanOption::Factors() const
+{
+	const double disc = std::exp(-m_r * m_T);
+
+	// exp((b - r)T) is exactly 1 when b = r and exactly exp(-rT) when b = 0, only the general model needs it
+	switch (Model())
+	{
+	case CARRY_STOCK:
+		return TermFactors{ std::sqrt(m_T), 1.0, disc };
+	case CARRY_FUTURES:
+		return TermFactors{ std::sqrt(m_T), disc, disc };
+	default:
+		return TermFactors{ std::sqrt(m_T), std::exp((m_b - m_r) * m_T), disc };
+	}
 }
 
 // Constructor for EuropeanOption class
 EuropeanOption::EuropeanOption(const std::string& type, const double& T, const double& K, const double& S, const double& r,
 	const double& sigma, const int& id, const double& b) :
-	m_type(type),
+	m_type(ValidType(type)),
 	m_T(T),
 	m_K(K),
 	m_S(S),
 	m_r(r),
 	m_sigma(sigma),
 	m_id(id),
-	m_b(std::isnan(b) ? r : b)
+	m_b(std::isnan(b) ? r : b),
+	m_memoize(false),
+	m_cached(0),
+	m_sqrtT(0),
+	m_d1(0),
+	m_d2(0),
+	m_Nd1(0),
+	m_Nd2(0),
+	m_nd1(0),
+	m_carry(0),
+	m_disc(0)
 
 {}
 
@@ -57,7 +179,17 @@ EuropeanOption::EuropeanOption(const EuropeanOption& source) :
 	m_r(source.m_r),
 	m_sigma(source.m_sigma),
 	m_id(source.m_id),
-	m_b(source.m_b)
+	m_b(source.m_b),
+	m_memoize(source.m_memoize),
+	m_cached(source.m_cached),
+	m_sqrtT(source.m_sqrtT),
+	m_d1(source.m_d1),
+	m_d2(source.m_d2),
+	m_Nd1(source.m_Nd1),
+	m_Nd2(source.m_Nd2),
+	m_nd1(source.m_nd1),
+	m_carry(source.m_carry),
+	m_disc(source.m_disc)
 
 {}
 
@@ -78,6 +210,16 @@ EuropeanOption& EuropeanOption::operator=(const EuropeanOption& source)
 	m_sigma = source.m_sigma;
 	m_id = source.m_id;
 	m_b = source.m_b;
+	m_memoize = source.m_memoize;
+	m_cached = source.m_cached;
+	m_sqrtT = source.m_sqrtT;
+	m_d1 = source.m_d1;
+	m_d2 = source.m_d2;
+	m_Nd1 = source.m_Nd1;
+	m_Nd2 = source.m_Nd2;
+	m_nd1 = source.m_nd1;
+	m_carry = source.m_carry;
+	m_disc = source.m_disc;
 
 	// Return the current object (the object pointed by this)
 	return *this;
@@ -102,180 +244,103 @@ std::vector<std::string> EuropeanOption::ConvertToVectorString() const
 // Calculate the price of the European option
 double EuropeanOption::Price() const
 {
-	double d1 = D1();
-	double d2 = D2(d1);
-
-	if (m_type == "Call")
-	{
-		return m_S * std::exp((m_b - m_r) * m_T) * N(d1) - m_K * std::exp(-m_r * m_T) * N(d2);
-	}
-
-	if (m_type == "Put")
-	{
-		return m_K * std::exp(-m_r * m_T) * (1 - N(d2)) - m_S * std::exp((m_b - m_r) * m_T) * (1 - N(d1));
-	}
+	return BlackScholesPrice(m_type == "Call", Terms(BLACKSCHOLES_N_D1 | BLACKSCHOLES_N_D2));
 }
 
 // Calculate the price using put-call parity
 double EuropeanOption::PricePutCallParity() const
 {
-	if (m_type == "Call")
-	{
-		return Price() + m_K * std::exp(-m_r * m_T) - m_S;
-	}
-
-	if (m_type == "Put")
-	{
-		return Price() + m_S - m_K * std::exp(-m_r * m_T);
-	}
+	return BlackScholesPricePutCallParity(m_type == "Call", Terms(BLACKSCHOLES_N_D1 | BLACKSCHOLES_N_D2));
 }
 
 // Calculate the Delta of the option
 double EuropeanOption::Delta() const
 {
-	if (m_type == "Call")
-	{
-		return exp((m_b - m_r) * m_T) * N(D1());
-	}
-
-	if (m_type == "Put")
-	{
-		return -exp((m_b - m_r) * m_T) * (1 - N(D1()));
-	}
+	return BlackScholesDelta(m_type == "Call", Terms(BLACKSCHOLES_N_D1));
 }
 
 // Calculate the Gamma of the option
 double EuropeanOption::Gamma() const
 {
-	return N_prime(D1()) * exp((m_b - m_r) * m_T) / (m_S * m_sigma * sqrt(m_T));
+	return BlackScholesGamma(Terms(BLACKSCHOLES_N_PRIME_D1));
 }
 
 // Calculate the Vega of the option
 double EuropeanOption::Vega() const
 {
-	return m_S * sqrt(m_T) * exp((m_b - m_r) * m_T) * N_prime(D1());
+	return BlackScholesVega(Terms(BLACKSCHOLES_N_PRIME_D1));
 }
 
 // Calculate the Theta of the option
 double EuropeanOption::Theta() const
 {
-	double d1 = D1();
-	double d2 = D2(d1);
-
-	if (m_type == "Call")
-	{
-		return (-(m_S)*m_sigma * exp((m_b - m_r) * m_T) * N_prime(d1) / (2 * sqrt(m_T))) - ((m_b - m_r) * m_S * exp((m_b - m_r) * m_T) * N(d1)) - (m_r * m_K * exp(-m_r * m_T) * N(d2));
-	}
-
-	if (m_type == "Put")
-	{
-		return (-(m_S)*m_sigma * exp((m_b - m_r) * m_T) * N_prime(d1) / (2 * sqrt(m_T))) - ((m_b - m_r) * m_S * exp((m_b - m_r) * m_T) * (1 - N(d1))) - (m_r * m_K * exp(-m_r * m_T) * (1 - N(d2)));
-	}
+	return BlackScholesTheta(m_type == "Call", Terms(BLACKSCHOLES_ALL_TERMS));
 }
 
 // Calculate the Rho of the option
 double EuropeanOption::Rho() const
 {
-	double d1 = D1();
-	double d2 = D2(d1);
-
-	if (m_type == "Call")
-	{
-		return m_K * m_T * exp(-m_r * m_T) * N(d2);
-	}
-
-	if (m_type == "Put")
-	{
-		return -m_K * m_T * exp(-m_r * m_T) * (1 - N(d2));
-	}
+	return BlackScholesRho(m_type == "Call", Terms(BLACKSCHOLES_N_D2));
 }
 
 // Calculate the Vanna of the option
 double EuropeanOption::Vanna() const
 {
-	double d1 = D1();
-
-	return exp((m_b - m_r) * m_T) * N_prime(d1) * (d1 / m_sigma - 1) * m_S * sqrt(m_T);
+	return BlackScholesVanna(Terms(BLACKSCHOLES_N_PRIME_D1));
 }
 
 // Calculate the Charm of the option
 double EuropeanOption::Charm() const
 {
-	double d1 = D1();
-	double d2 = D2(d1);
-	double term1 = -exp((m_b - m_r) * m_T) * N_prime(d1) * (2 * (m_r - m_b) * m_T - d2 * m_sigma * sqrt(m_T)) / (2 * m_T * m_sigma * sqrt(m_T));
-
-	if (m_type == "Call")
-	{
-		return term1 - (m_r - m_b) * exp((m_b - m_r) * m_T) * N(d1);
-	}
-	if (m_type == "Put")
-	{
-		return term1 + (m_r - m_b) * exp((m_b - m_r) * m_T) * (1 - N(d1));
-	}
+	return BlackScholesCharm(m_type == "Call", Terms(BLACKSCHOLES_N_D1 | BLACKSCHOLES_N_PRIME_D1));
 }
 
 // Calculate the Speed of the option
 double EuropeanOption::Speed() const
 {
-	double d1 = D1();
-
-	return -N_prime(d1) * exp((m_b - m_r) * m_T) * (d1 / (m_S * m_S * m_sigma * sqrt(m_T)));
+	return BlackScholesSpeed(Terms(BLACKSCHOLES_N_PRIME_D1));
 }
 
 // Calculate the Color of the option
 double EuropeanOption::Color() const
 {
-	double d1 = D1();
-
-	return -N_prime(d1) * exp((m_b - m_r) * m_T) * (2 * (m_r - m_b) * m_T - d1 * m_sigma * sqrt(m_T)) / (2 * m_T * m_S * m_sigma * sqrt(m_T));
+	return BlackScholesColor(Terms(BLACKSCHOLES_N_PRIME_D1));
 }
 
 // Calculate the DvegaDtime of the option
 double EuropeanOption::DvegaDtime() const
 {
-	double d1 = D1();
-
-	return m_S * sqrt(m_T) * exp((m_b - m_r) * m_T) * N_prime(d1) * (m_r - m_b - d1 * m_sigma / (2 * sqrt(m_T)));
+	return BlackScholesDvegaDtime(Terms(BLACKSCHOLES_N_PRIME_D1));
 }
 
 // Calculate the Vomma of the option
 double EuropeanOption::Vomma() const
 {
-	double d1 = D1();
-
-	return Vega() * d1 * (d1 - 1) / m_sigma;
+	return BlackScholesVomma(Terms(BLACKSCHOLES_N_PRIME_D1));
 }
 
 // Calculate the Veta of the option
 double EuropeanOption::Veta() const
 {
-	double d1 = D1();
-
-	return -m_S * exp((m_b - m_r) * m_T) * N_prime(d1) * sqrt(m_T) * (m_r - m_b + (d1 * m_sigma) / (2 * sqrt(m_T)));
+	return BlackScholesVeta(Terms(BLACKSCHOLES_N_PRIME_D1));
 }
 
 // Calculate the Zomma of the option
 double EuropeanOption::Zomma() const
 {
-	double d1 = D1();
-
-	return Gamma() * (d1 * (d1 - 1) - 1) / m_sigma;
+	return BlackScholesZomma(Terms(BLACKSCHOLES_N_PRIME_D1));
 }
 
 // Calculate the Lambda of the option
 double EuropeanOption::Lambda() const
 {
-	return Delta() * (m_S / Price());
+	return BlackScholesLambda(m_type == "Call", Terms(BLACKSCHOLES_N_D1 | BLACKSCHOLES_N_D2));
 }
 
 // Calculate the Ultima of the option
 double EuropeanOption::Ultima() const
 {
-	double d1 = D1();
-	double d2 = D2(d1);
-
-	return -Vega() * (d1 * (d1 - 3) * (d1 - 1) - 1) / (m_sigma * m_sigma);
+	return BlackScholesUltima(Terms(BLACKSCHOLES_N_PRIME_D1));
 }
 
 // Calculate the numeric Delta of the option
@@ -315,10 +380,18 @@ void EuropeanOption::CheckPutCallParity(const double& market_price, const double
 	}
 }
 
+// Set whether the Greek functions keep their intermediates between calls, starting from an empty cache
+EuropeanOption& EuropeanOption::Memoize(const bool& memoize)
+{
+	m_memoize = memoize;
+	m_cached = 0;
+	return *this;
+}
+
 // Set the option type
 EuropeanOption& EuropeanOption::type(const std::string& type)
 {
-	m_type = type;
+	m_type = ValidType(type);
 	return *this;
 }
 
@@ -326,6 +399,7 @@ EuropeanOption& EuropeanOption::type(const std::string& type)
 EuropeanOption& EuropeanOption::T(const double& T)
 {
 	m_T = T;
+	m_cached &= ~CACHE_T;
 	return *this;
 }
 
@@ -333,6 +407,7 @@ EuropeanOption& EuropeanOption::T(const double& T)
 EuropeanOption& EuropeanOption::K(const double& K)
 {
 	m_K = K;
+	m_cached &= ~CACHE_K_S_SIGMA;
 	return *this;
 }
 
@@ -340,6 +415,7 @@ EuropeanOption& EuropeanOption::K(const double& K)
 EuropeanOption& EuropeanOption::S(const double& S)
 {
 	m_S = S;
+	m_cached &= ~CACHE_K_S_SIGMA;
 	return *this;
 }
 
@@ -347,6 +423,7 @@ EuropeanOption& EuropeanOption::S(const double& S)
 EuropeanOption& EuropeanOption::r(const double& r)
 {
 	m_r = r;
+	m_cached &= ~CACHE_R;
 	return *this;
 }
 
@@ -354,6 +431,7 @@ EuropeanOption& EuropeanOption::r(const double& r)
 EuropeanOption& EuropeanOption::sigma(const double& sigma)
 {
 	m_sigma = sigma;
+	m_cached &= ~CACHE_K_S_SIGMA;
 	return *this;
 }
 
@@ -361,6 +439,23 @@ EuropeanOption& EuropeanOption::sigma(const double& sigma)
 EuropeanOption& EuropeanOption::b(const double& b)
 {
 	m_b = b;
+	m_cached &= ~CACHE_B;
+	return *this;
+}
+
+// Set the risk-free interest rate from a discount curve
+EuropeanOption& EuropeanOption::r(const YieldCurve& curve)
+{
+	m_r = curve.ZeroRate(m_T);
+	m_cached &= ~CACHE_R;
+	return *this;
+}
+
+// Set the cost of carry from a carry curve
+EuropeanOption& EuropeanOption::b(const YieldCurve& curve)
+{
+	m_b = curve.ZeroRate(m_T);
+	m_cached &= ~CACHE_B;
 	return *this;
 }
 
@@ -8,10 +8,16 @@
 #define EUROPEANOPTION_HPP
 
 #include <string>
+#include <vector>
+#include <limits>
 #include <ostream>
+#include <cmath>
 #include "Option.hpp"
+#include "BlackScholes.hpp"
+#include "../YieldCurve/YieldCurve.hpp"
 
-// Class definition for EuropeanOption
+// Class definition for EuropeanOption. The pricing and Greek functions evaluate the Black-Scholes kernels and can be
+// called concurrently on the same object, unless Memoize(true) makes them keep their intermediates in the option.
 class EuropeanOption: public Option
 {
 private:
@@ -32,20 +38,101 @@ private:
 	double m_b;
 	// Option ID
 	int m_id;
+	// Whether the Greek functions keep their intermediates between calls
+	bool m_memoize;
 
-	// Calculate d1 for Black-Scholes formula
-	double D1() const;
-	// Calculate d2 for Black-Scholes formula
-	double D2(const double& d1) const;
+	// Intermediates of the Greek functions of a memoizing option, computed on first use and kept until a setter changes
+	// a parameter they depend on. Each one is valid while its flag is set in m_cached.
+	enum CacheFlag : unsigned int
+	{
+		CACHE_SQRT_T = 1u << 0, // sqrt(T)
+		CACHE_D1 = 1u << 1, // d1
+		CACHE_D2 = 1u << 2, // d2
+		CACHE_N_D1 = 1u << 3, // N(d1)
+		CACHE_N_D2 = 1u << 4, // N(d2)
+		CACHE_N_PRIME_D1 = 1u << 5, // n(d1)
+		CACHE_CARRY = 1u << 6, // Carry factor exp((b - r)T)
+		CACHE_DISC = 1u << 7, // Discount factor exp(-rT)
+		// Intermediates that depend on each parameter, cleared by its setter
+		CACHE_T = (1u << 8) - 1,
+		CACHE_K_S_SIGMA = CACHE_D1 | CACHE_D2 | CACHE_N_D1 | CACHE_N_D2 | CACHE_N_PRIME_D1,
+		CACHE_R = CACHE_CARRY | CACHE_DISC,
+		CACHE_B = CACHE_K_S_SIGMA | CACHE_CARRY
+	};
+	mutable unsigned int m_cached;
+	mutable double m_sqrtT;
+	mutable double m_d1;
+	mutable double m_d2;
+	mutable double m_Nd1;
+	mutable double m_Nd2;
+	mutable double m_nd1;
+	mutable double m_carry;
+	mutable double m_disc;
 
-	// Standard normal cumulative distribution function
-	double N(double x) const;
-	// Standard normal probability density function
-	double N_prime(double x) const;
+	// Check that an option type is "Call" or "Put", throws std::invalid_argument otherwise
+	static const std::string& ValidType(const std::string& type);
+
+	// Cached intermediates of the Greek functions
+	double CachedSqrtT() const;
+	double CachedD1() const;
+	double CachedD2() const;
+	double CachedN_d1() const;
+	double CachedN_d2() const;
+	double CachedN_prime_d1() const;
+	double CachedCarry() const;
+	double CachedDisc() const;
+	// Intermediates of the formulas for the current parameters, N(d1), N(d2) and n(d1) only when they are selected in
+	// terms, taken from the cache when the option memoizes
+	BlackScholesTerms<double> Terms(const unsigned int& terms) const;
 
 public:
 
-	// Constructor
+	// Measure flags, combined into a bitmask to select the outputs of the fused Measures() kernel
+	enum MeasureFlag : unsigned int
+	{
+		MEASURE_PRICE = 1u << 0,
+		MEASURE_PRICE_PUT_CALL_PARITY = 1u << 1,
+		MEASURE_DELTA = 1u << 2,
+		MEASURE_GAMMA = 1u << 3,
+		MEASURE_VEGA = 1u << 4,
+		MEASURE_THETA = 1u << 5,
+		MEASURE_RHO = 1u << 6,
+		MEASURE_VANNA = 1u << 7,
+		MEASURE_CHARM = 1u << 8,
+		MEASURE_SPEED = 1u << 9,
+		MEASURE_COLOR = 1u << 10,
+		MEASURE_DVEGADTIME = 1u << 11,
+		MEASURE_VOMMA = 1u << 12,
+		MEASURE_VETA = 1u << 13,
+		MEASURE_ZOMMA = 1u << 14,
+		MEASURE_LAMBDA = 1u << 15,
+		MEASURE_ULTIMA = 1u << 16,
+		// Number of measures
+		MEASURE_COUNT = 17,
+		// Configurations
+		MEASURE_CONFIG_PRICE = MEASURE_PRICE,
+		MEASURE_CONFIG_BASIC = MEASURE_PRICE | MEASURE_PRICE_PUT_CALL_PARITY | MEASURE_DELTA | MEASURE_GAMMA | MEASURE_VEGA |
+			MEASURE_THETA | MEASURE_RHO,
+		MEASURE_CONFIG_ALL = (1u << 17) - 1
+	};
+
+	// Factors of the time to expiration, risk-free rate and cost of carry, shared by the options with the same T, r and b
+	struct TermFactors
+	{
+		double sqrtT; // Square root of the time to expiration
+		double carry; // Carry factor exp((b - r)T)
+		double disc; // Discount factor exp(-rT)
+	};
+
+	// Variants of the generalized model, told apart by the cost of carry
+	enum CarryModel : int
+	{
+		CARRY_GENERAL = 0, // Any cost of carry
+		CARRY_STOCK = 1, // b = r, Black-Scholes on a stock without dividends: the carry factor is 1
+		CARRY_FUTURES = 2 // b = 0, Black-76 on a futures contract: the carry factor is the discount factor
+	};
+
+	// Constructor, throws std::invalid_argument for a type other than "Call" or "Put"
 	EuropeanOption(const std::string& type, const double& T, const double& K, const double& S, const double& r,
 		const double& sigma, const int& id = 1, const double& b = std::numeric_limits<double>::quiet_NaN());
 	// Copy constructor
@@ -99,11 +186,31 @@ public:
 	// Calculate Numeric Gamma
 	double NumericGamma(const double& h) const;
 
+	// Fused kernel
+	// Calculate the measures selected by Mask (and by mask at run time) in one pass, returns the number of values written
+	template <unsigned int Mask>
+	int Measures(const unsigned int& mask, double* out) const;
+	// Calculate the same measures with the factors of T, r and b given, so that runs of options sharing them compute them once,
+	// with the kernel of the variant of the model when Variant is the one of the option
+	template <unsigned int Mask, CarryModel Variant = CARRY_GENERAL>
+	int Measures(const unsigned int& mask, double* out, const TermFactors& factors) const;
+	// Calculate the factors of the option's time to expiration, risk-free rate and cost of carry
+	TermFactors Factors() const;
+	// Classify the option into the variant of the model selected by its cost of carry
+	CarryModel Model() const { return m_b == m_r ? CARRY_STOCK : m_b == 0 ? CARRY_FUTURES : CARRY_GENERAL; }
+
 	// Check Put-Call Parity
 	void CheckPutCallParity(const double& market_price, const double& threshold = 0.05) const;
 
+	// Memoization functions
+	// Set whether the Greek functions keep their intermediates between calls, for sweeps that evaluate many measures per
+	// state. A memoizing option writes its cache from const functions, so it must not be shared between threads
+	EuropeanOption& Memoize(const bool& memoize);
+	// Get whether the Greek functions keep their intermediates between calls
+	const bool& Memoize() const { return m_memoize; }
+
 	// Parameter modification functions
-	// Set option type
+	// Set option type, throws std::invalid_argument for a type other than "Call" or "Put"
 	EuropeanOption& type(const std::string& type);
 	// Set time to expiration
 	EuropeanOption& T(const double& T);
@@ -117,6 +224,10 @@ public:
 	EuropeanOption& sigma(const double& sigma);
 	// Set cost of carry
 	EuropeanOption& b(const double& b);
+	// Set risk-free interest rate to the zero rate of a discount curve at the time to expiration
+	EuropeanOption& r(const YieldCurve& curve);
+	// Set cost of carry to the zero rate of a carry curve at the time to expiration
+	EuropeanOption& b(const YieldCurve& curve);
 
 	// Get inline functions
 	// Get option type
@@ -142,5 +253,77 @@ public:
 
 };
 
+// Calculate the measures selected by Mask, and among those by mask at run time, writing them to out in flag order.
+// The intermediates (d1, d2, N(d1), N(d2), n(d1) and the discount factors) are evaluated once per call and only when
+// a selected measure needs them, and measures outside Mask are removed at compile time. Each measure is evaluated by
+// the Black-Scholes kernel of its individual Greek function.
+template <unsigned int Mask>
+int EuropeanOption::Measures(const unsigned int& mask, double* out) const
+{
+	return Measures<Mask>(mask, out, Factors());
+}
+
+// Calculate the measures selected by Mask with the factors of T, r and b computed beforehand by Factors(), d1 and d2
+// taking the square root of T from them. The CARRY_STOCK kernel takes the carry factor as the constant 1, which makes
+// the (b - r) term of Theta exactly zero, and the CARRY_FUTURES kernel reuses the discount factor as the carry
+// factor, so that both give the same values as the general kernel for the options of their variant.
+template <unsigned int Mask, EuropeanOption::CarryModel Variant>
+int EuropeanOption::Measures(const unsigned int& mask, double* out, const TermFactors& factors) const
+{
+	// The work a measure needs is skipped when the measure is outside Mask at compile time or outside mask at run time
+	const unsigned int selected = Mask & mask;
+	const bool need_nd1 = (selected & (MEASURE_GAMMA | MEASURE_VEGA | MEASURE_THETA | MEASURE_VANNA | MEASURE_CHARM |
+		MEASURE_SPEED | MEASURE_COLOR | MEASURE_DVEGADTIME | MEASURE_VOMMA | MEASURE_VETA | MEASURE_ZOMMA | MEASURE_ULTIMA)) != 0;
+	const bool need_Nd1 = (selected & (MEASURE_PRICE | MEASURE_PRICE_PUT_CALL_PARITY | MEASURE_DELTA | MEASURE_THETA |
+		MEASURE_CHARM | MEASURE_LAMBDA)) != 0;
+	const bool need_Nd2 = (selected & (MEASURE_PRICE | MEASURE_PRICE_PUT_CALL_PARITY | MEASURE_THETA | MEASURE_RHO |
+		MEASURE_LAMBDA)) != 0;
+
+	const bool call = m_type == "Call";
+	const double carry = Variant == CARRY_STOCK ? 1.0 : Variant == CARRY_FUTURES ? factors.disc : factors.carry;
+	const unsigned int terms = (need_Nd1 ? BLACKSCHOLES_N_D1 : 0u) | (need_Nd2 ? BLACKSCHOLES_N_D2 : 0u) |
+		(need_nd1 ? BLACKSCHOLES_N_PRIME_D1 : 0u);
+	const BlackScholesTerms<double> x = BlackScholesEvaluate(m_T, m_K, m_S, m_r, m_sigma, m_b, factors.sqrtT, carry, factors.disc, terms);
+
+	int n = 0;
+
+	if constexpr ((Mask & MEASURE_PRICE) != 0)
+		if (mask & MEASURE_PRICE) out[n++] = BlackScholesPrice(call, x);
+	if constexpr ((Mask & MEASURE_PRICE_PUT_CALL_PARITY) != 0)
+		if (mask & MEASURE_PRICE_PUT_CALL_PARITY) out[n++] = BlackScholesPricePutCallParity(call, x);
+	if constexpr ((Mask & MEASURE_DELTA) != 0)
+		if (mask & MEASURE_DELTA) out[n++] = BlackScholesDelta(call, x);
+	if constexpr ((Mask & MEASURE_GAMMA) != 0)
+		if (mask & MEASURE_GAMMA) out[n++] = BlackScholesGamma(x);
+	if constexpr ((Mask & MEASURE_VEGA) != 0)
+		if (mask & MEASURE_VEGA) out[n++] = BlackScholesVega(x);
+	if constexpr ((Mask & MEASURE_THETA) != 0)
+		if (mask & MEASURE_THETA) out[n++] = BlackScholesTheta(call, x);
+	if constexpr ((Mask & MEASURE_RHO) != 0)
+		if (mask & MEASURE_RHO) out[n++] = BlackScholesRho(call, x);
+	if constexpr ((Mask & MEASURE_VANNA) != 0)
+		if (mask & MEASURE_VANNA) out[n++] = BlackScholesVanna(x);
+	if constexpr ((Mask & MEASURE_CHARM) != 0)
+		if (mask & MEASURE_CHARM) out[n++] = BlackScholesCharm(call, x);
+	if constexpr ((Mask & MEASURE_SPEED) != 0)
+		if (mask & MEASURE_SPEED) out[n++] = BlackScholesSpeed(x);
+	if constexpr ((Mask & MEASURE_COLOR) != 0)
+		if (mask & MEASURE_COLOR) out[n++] = BlackScholesColor(x);
+	if constexpr ((Mask & MEASURE_DVEGADTIME) != 0)
+		if (mask & MEASURE_DVEGADTIME) out[n++] = BlackScholesDvegaDtime(x);
+	if constexpr ((Mask & MEASURE_VOMMA) != 0)
+		if (mask & MEASURE_VOMMA) out[n++] = BlackScholesVomma(x);
+	if constexpr ((Mask & MEASURE_VETA) != 0)
+		if (mask & MEASURE_VETA) out[n++] = BlackScholesVeta(x);
+	if constexpr ((Mask & MEASURE_ZOMMA) != 0)
+		if (mask & MEASURE_ZOMMA) out[n++] = BlackScholesZomma(x);
+	if constexpr ((Mask & MEASURE_LAMBDA) != 0)
+		if (mask & MEASURE_LAMBDA) out[n++] = BlackScholesLambda(call, x);
+	if constexpr ((Mask & MEASURE_ULTIMA) != 0)
+		if (mask & MEASURE_ULTIMA) out[n++] = BlackScholesUltima(x);
+
+	return n;
+}
+
 // EUROPEANOPTION_HPP
 #endif
@@ -0,0 +1,189 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// HestonEngine.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code for the HestonEngine class
+
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/math/constants/constants.hpp>
+#include "HestonEngine.hpp"
+
+// Function to return the characteristic function of ln(S_T / S) at frequency u, in the form of Albrecher et al.
+// that keeps the complex logarithm on its principal branch for long expiries
+std::complex<double> HestonEngine::CharacteristicFunction(const HestonOption& model, const double& u)
+{
+	const std::complex<double> i(0, 1);
+	const double xi2 = model.xi() * model.xi();
+
+	std::complex<double> beta = model.kappa() - model.rho() * model.xi() * i * u;
+	std::complex<double> d = std::sqrt(beta * beta + xi2 * (i * u + u * u));
+	std::complex<double> g = (beta - d) / (beta + d);
+	std::complex<double> edT = std::exp(-d * model.T());
+
+	std::complex<double> C = model.kappa() * model.theta() / xi2 *
+		((beta - d) * model.T() - 2.0 * std::log((1.0 - g * edT) / (1.0 - g)));
+	std::complex<double> D = (beta - d) / xi2 * (1.0 - edT) / (1.0 - g * edT);
+
+	return std::exp(i * u * model.b() * model.T() + C + D * model.v0());
+}
+
+// Constructor with a model option, the range of strikes of the chain, the number of terms and the truncation width
+HestonEngine::HestonEngine(const HestonOption& model, const double& K_min, const double& K_max, const std::size_t& terms,
+	const double& L) :
+	m_S(model.S()),
+	m_discount(std::exp(-model.r() * model.T())),
+	m_forward_discount(std::exp((model.b() - model.r()) * model.T()))
+{
+	if (!(model.T() > 0) || !(model.S() > 0) || !(K_min > 0) || !(K_max >= K_min))
+	{
+		throw std::invalid_argument("The Heston engine needs a positive expiry, spot and strike range");
+	}
+	if (!(model.v0() >= 0) || !(model.kappa() > 0) || !(model.theta() >= 0) || !(model.xi() > 0) || !(std::abs(model.rho()) <= 1))
+	{
+		throw std::invalid_argument("Invalid Heston variance parameters");
+	}
+	if (terms == 0 || !(L > 0))
+	{
+		throw std::invalid_argument("The Heston engine needs a positive number of terms and truncation width");
+	}
+
+	const double pi = boost::math::constants::pi<double>();
+	const double T = model.T(), kappa = model.kappa(), theta = model.theta(), xi = model.xi(), rho = model.rho(), v0 = model.v0();
+	const double ekT = std::exp(-kappa * T);
+
+	// First two cumulants of ln(S_T / S) (Fang and Oosterlee)
+	double c1 = model.b() * T + (1 - ekT) * (theta - v0) / (2 * kappa) - theta * T / 2;
+	double c2 = std::abs(1 / (8 * kappa * kappa * kappa) * (xi * T * kappa * ekT * (v0 - theta) * (8 * kappa * rho - 4 * xi) +
+		kappa * rho * xi * (1 - ekT) * (16 * theta - 8 * v0) + 2 * theta * kappa * T * (-4 * kappa * rho * xi + xi * xi + 4 * kappa * kappa) +
+		xi * xi * ((theta - 2 * v0) * ekT * ekT + theta * (6 * ekT - 7) + 2 * v0) + 8 * kappa * kappa * (v0 - theta) * (1 - ekT)));
+	double spread = L * std::sqrt(c2);
+
+	// Range of ln(S_T / K) covering every strike of the chain, it must contain the kink of the put payoff at 0
+	m_a = std::min(std::log(m_S / K_max) + c1 - spread, 0.0);
+	double b = std::max(std::log(m_S / K_min) + c1 + spread, 0.0);
+	m_width = b - m_a;
+
+	// Number of terms grown with the range, so that a wide chain keeps the resolution of a single strike
+	std::size_t n = static_cast<std::size_t>(std::ceil(terms * m_width / (2 * spread)));
+	n = std::max(terms, std::min<std::size_t>(n, 64 * terms));
+
+	m_weights.resize(n);
+	for (std::size_t k = 0; k < n; ++k)
+	{
+		double w = k * pi / m_width;
+
+		// Cosine coefficients of the put payoff (1 - e^y)^+ on [a, 0]
+		double chi = (std::cos(w * m_a) - std::exp(m_a) - w * std::sin(w * m_a)) / (1 + w * w);
+		double psi = k == 0 ? -m_a : -std::sin(w * m_a) / w;
+		double U = 2 / m_width * (psi - chi);
+
+		std::complex<double> phase(std::cos(w * m_a), -std::sin(w * m_a));
+		m_weights[k] = CharacteristicFunction(model, w) * phase * U;
+	}
+	m_weights[0] *= 0.5;
+}
+
+// Copy constructor
+HestonEngine::HestonEngine(const HestonEngine& source) :
+	m_S(source.m_S),
+	m_discount(source.m_discount),
+	m_forward_discount(source.m_forward_discount),
+	m_a(source.m_a),
+	m_width(source.m_width),
+	m_weights(source.m_weights)
+{}
+
+// Assignment operator
+HestonEngine& HestonEngine::operator=(const HestonEngine& source)
+{
+	// Check for self assignment
+	if (this == &source)
+		return *this;
+
+	m_S = source.m_S;
+	m_discount = source.m_discount;
+	m_forward_discount = source.m_forward_discount;
+	m_a = source.m_a;
+	m_width = source.m_width;
+	m_weights = source.m_weights;
+
+	// Return the current object (the object pointed by this)
+	return *this;
+}
+
+// Function to return the price of a put of strike K
+double HestonEngine::Put(const double& K) const
+{
+	const double pi = boost::math::constants::pi<double>();
+	const double x = std::log(m_S / K);
+
+	// Powers of z = exp(i pi x / (b - a)) by recurrence
+	const std::complex<double> z(std::cos(pi * x / m_width), std::sin(pi * x / m_width));
+	std::complex<double> zk(1, 0);
+	double sum = 0;
+
+	for (const auto& weight : m_weights)
+	{
+		sum += weight.real() * zk.real() - weight.imag() * zk.imag();
+		zk *= z;
+	}
+
+	// The truncated series can dip below the no-arbitrage bound for far out-of-the-money strikes
+	return std::max(K * m_discount * sum, 0.0);
+}
+
+// Function to return the price of a call or a put of strike K
+double HestonEngine::Price(const bool& call, const double& K) const
+{
+	double put = Put(K);
+
+	return call ? std::max(put + m_S * m_forward_discount - K * m_discount, 0.0) : put;
+}
+
+// Function to price a chain of n strikes
+void HestonEngine::Price(const char* call, const double* K, double* out, const std::size_t& n) const
+{
+	const double pi = boost::math::constants::pi<double>();
+	constexpr std::size_t TILE = 16;
+
+	// Strikes are summed a tile at a time with the terms in the outer loop, so every weight is loaded once per tile
+	// and the inner loop over the strikes of the tile is a straight run of independent multiply-adds
+	for (std::size_t start = 0; start < n; start += TILE)
+	{
+		const std::size_t m = std::min(TILE, n - start);
+		double zr[TILE], zi[TILE], re[TILE], im[TILE], sum[TILE];
+
+		for (std::size_t j = 0; j < m; ++j)
+		{
+			double angle = pi * std::log(m_S / K[start + j]) / m_width;
+			zr[j] = std::cos(angle);
+			zi[j] = std::sin(angle);
+			re[j] = 1;
+			im[j] = 0;
+			sum[j] = 0;
+		}
+
+		for (const auto& weight : m_weights)
+		{
+			const double wr = weight.real(), wi = weight.imag();
+
+			for (std::size_t j = 0; j < m; ++j)
+			{
+				sum[j] += wr * re[j] - wi * im[j];
+				double next = re[j] * zr[j] - im[j] * zi[j];
+				im[j] = re[j] * zi[j] + im[j] * zr[j];
+				re[j] = next;
+			}
+		}
+
+		for (std::size_t j = 0; j < m; ++j)
+		{
+			const double strike = K[start + j];
+			double put = std::max(strike * m_discount * sum[j], 0.0);
+			out[start + j] = call[start + j] != 0 ? std::max(put + m_S * m_forward_discount - strike * m_discount, 0.0) : put;
+		}
+	}
+}
@@ -0,0 +1,61 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// HestonEngine.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code for the HestonEngine class
+
+// Header guard to avoid multiple inclusions
+#ifndef HESTONENGINE_HPP
+#define HESTONENGINE_HPP
+
+#include <vector>
+#include <complex>
+#include <cstddef>
+#include "HestonOption.hpp"
+
+// Class definition for HestonEngine, the COS method (Fang and Oosterlee) for one expiry of the Heston model. The density
+// of ln(S_T / K) is expanded in a cosine series on a truncation range [a, b] set from the first two cumulants of the log
+// return, widened to cover the strikes of the chain. The characteristic function at the series frequencies, the payoff
+// coefficients and the phase shift are combined on construction into one complex weight per term, so that the price of
+// any strike of the expiry reduces to a sum of weight * z^k, z = exp(i pi ln(S / K) / (b - a)), evaluated by recurrence
+// without any further special function calls.
+class HestonEngine
+{
+private:
+
+	double m_S; // Spot price
+	double m_discount; // Discount factor exp(-r T)
+	double m_forward_discount; // Discounted forward factor exp((b - r) T)
+	double m_a; // Lower end of the truncation range of ln(S_T / K)
+	double m_width; // Width of the truncation range
+	std::vector<std::complex<double>> m_weights; // Weight of each term of the put series
+
+	// Function to return the characteristic function of ln(S_T / S) at frequency u
+	static std::complex<double> CharacteristicFunction(const HestonOption& model, const double& u);
+
+public:
+
+	// Constructor with a model option (everything but strike and type), the range of strikes of the chain,
+	// the number of series terms for a single strike and the width of the truncation range in standard deviations of the
+	// log return, wider than the usual 10 to 12 because the tails of the Heston density are heavy when xi is large
+	HestonEngine(const HestonOption& model, const double& K_min, const double& K_max, const std::size_t& terms = 256,
+		const double& L = 20);
+	// Copy constructor
+	HestonEngine(const HestonEngine& source);
+	// Assignment operator
+	HestonEngine& operator=(const HestonEngine& source);
+
+	// Function to return the number of series terms
+	std::size_t Terms() const { return m_weights.size(); }
+
+	// Function to return the price of a put of strike K
+	double Put(const double& K) const;
+
+	// Function to return the price of a call or a put of strike K, calls by put-call parity
+	double Price(const bool& call, const double& K) const;
+
+	// Function to price a chain of n strikes, a nonzero flag in call selects a call
+	void Price(const char* call, const double* K, double* out, const std::size_t& n) const;
+};
+
+// HESTONENGINE_HPP
+#endif
@@ -0,0 +1,252 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// HestonOption.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code for the HestonOption class
+
+#include <string>
+#include <vector>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+#include <algorithm>
+#include "HestonOption.hpp"
+#include "HestonEngine.hpp"
+
+// Constructor for HestonOption class
+HestonOption::HestonOption(const std::string& type, const double& T, const double& K, const double& S, const double& r,
+	const double& v0, const double& kappa, const double& theta, const double& xi, const double& rho, const int& id,
+	const double& b) :
+	m_type(type),
+	m_T(T),
+	m_K(K),
+	m_S(S),
+	m_r(r),
+	m_v0(v0),
+	m_kappa(kappa),
+	m_theta(theta),
+	m_xi(xi),
+	m_rho(rho),
+	m_b(std::isnan(b) ? r : b),
+	m_id(id)
+{}
+
+// Copy constructor for HestonOption class
+HestonOption::HestonOption(const HestonOption& source) :
+	m_type(source.m_type),
+	m_T(source.m_T),
+	m_K(source.m_K),
+	m_S(source.m_S),
+	m_r(source.m_r),
+	m_v0(source.m_v0),
+	m_kappa(source.m_kappa),
+	m_theta(source.m_theta),
+	m_xi(source.m_xi),
+	m_rho(source.m_rho),
+	m_b(source.m_b),
+	m_id(source.m_id)
+{}
+
+// Assignment operator for HestonOption class
+HestonOption& HestonOption::operator=(const HestonOption& source)
+{
+	// Check for self assignment
+	if (this == &source)
+		return *this;
+
+	m_type = source.m_type;
+	m_T = source.m_T;
+	m_K = source.m_K;
+	m_S = source.m_S;
+	m_r = source.m_r;
+	m_v0 = source.m_v0;
+	m_kappa = source.m_kappa;
+	m_theta = source.m_theta;
+	m_xi = source.m_xi;
+	m_rho = source.m_rho;
+	m_b = source.m_b;
+	m_id = source.m_id;
+
+	// Return the current object (the object pointed by this)
+	return *this;
+}
+
+// Convert option parameters to a vector of strings
+std::vector<std::string> HestonOption::ConvertToVectorString() const
+{
+	return
+	{
+		std::to_string(m_id),
+		m_type,
+		std::to_string(m_T),
+		std::to_string(m_K),
+		std::to_string(m_S),
+		std::to_string(m_r),
+		std::to_string(m_v0),
+		std::to_string(m_kappa),
+		std::to_string(m_theta),
+		std::to_string(m_xi),
+		std::to_string(m_rho),
+		std::to_string(m_b)
+	};
+}
+
+// Calculate the price of the option
+double HestonOption::Price() const
+{
+	return HestonEngine(*this, m_K, m_K).Price(m_type == "Call", m_K);
+}
+
+// Calculate the prices of many options, one engine per group of options that differ only in strike and type
+std::vector<double> HestonOption::PriceChain(const std::vector<HestonOption>& options)
+{
+	// Order the options by the parameters of the transform, so that every chain is a run of consecutive options
+	auto model = [](const HestonOption& o)
+	{
+		return std::make_tuple(o.m_T, o.m_S, o.m_r, o.m_b, o.m_v0, o.m_kappa, o.m_theta, o.m_xi, o.m_rho);
+	};
+	std::vector<std::size_t> order(options.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](const std::size_t& i, const std::size_t& j)
+		{
+			return model(options[i]) < model(options[j]);
+		});
+
+	std::vector<double> prices(options.size());
+	std::vector<char> call;
+	std::vector<double> strikes, chain_prices;
+
+	for (std::size_t start = 0; start < order.size();)
+	{
+		const HestonOption& first = options[order[start]];
+		std::size_t end = start + 1;
+		while (end < order.size() && first.SameChain(options[order[end]])) ++end;
+
+		call.clear();
+		strikes.clear();
+		for (std::size_t k = start; k < end; ++k)
+		{
+			call.push_back(options[order[k]].m_type == "Call");
+			strikes.push_back(options[order[k]].m_K);
+		}
+
+		// One engine covering the whole strike range of the chain
+		auto range = std::minmax_element(strikes.begin(), strikes.end());
+		HestonEngine engine(first, *range.first, *range.second);
+
+		chain_prices.resize(strikes.size());
+		engine.Price(call.data(), strikes.data(), chain_prices.data(), strikes.size());
+
+		for (std::size_t k = start; k < end; ++k)
+		{
+			prices[order[k]] = chain_prices[k - start];
+		}
+		start = end;
+	}
+
+	return prices;
+}
+
+// Calculate the numeric Delta of the option
+double HestonOption::NumericDelta(const double& h) const
+{
+	double up_price = HestonOption(*this).S(m_S + h).Price();
+
+	double down_price = HestonOption(*this).S(m_S - h).Price();
+
+	return (up_price - down_price) / (2 * h);
+}
+
+// Calculate the numeric Gamma of the option
+double HestonOption::NumericGamma(const double& h) const
+{
+	double up_price = HestonOption(*this).S(m_S + h).Price();
+
+	double down_price = HestonOption(*this).S(m_S - h).Price();
+
+	return (up_price - 2 * Price() + down_price) / (h * h);
+}
+
+// Check whether two options can be priced by the same transform
+bool HestonOption::SameChain(const HestonOption& other) const
+{
+	return m_T == other.m_T && m_S == other.m_S && m_r == other.m_r && m_b == other.m_b && m_v0 == other.m_v0 &&
+		m_kappa == other.m_kappa && m_theta == other.m_theta && m_xi == other.m_xi && m_rho == other.m_rho;
+}
+
+// Set the option type
+HestonOption& HestonOption::type(const std::string& type)
+{
+	m_type = type;
+	return *this;
+}
+
+// Set the option maturity time
+HestonOption& HestonOption::T(const double& T)
+{
+	m_T = T;
+	return *this;
+}
+
+// Set the option strike price
+HestonOption& HestonOption::K(const double& K)
+{
+	m_K = K;
+	return *this;
+}
+
+// Set the option spot price
+HestonOption& HestonOption::S(const double& S)
+{
+	m_S = S;
+	return *this;
+}
+
+// Set the risk-free interest rate
+HestonOption& HestonOption::r(const double& r)
+{
+	m_r = r;
+	return *this;
+}
+
+// Set the initial volatility, the long-run variance and the other parameters of the variance process are kept
+HestonOption& HestonOption::sigma(const double& sigma)
+{
+	m_v0 = sigma * sigma;
+	return *this;
+}
+
+// Set the cost of carry
+HestonOption& HestonOption::b(const double& b)
+{
+	m_b = b;
+	return *this;
+}
+
+// Set the parameters of the variance process
+HestonOption& HestonOption::Variance(const double& v0, const double& kappa, const double& theta, const double& xi, const double& rho)
+{
+	m_v0 = v0;
+	m_kappa = kappa;
+	m_theta = theta;
+	m_xi = xi;
+	m_rho = rho;
+	return *this;
+}
+
+// Get the initial volatility
+double HestonOption::sigma() const
+{
+	return std::sqrt(m_v0);
+}
+
+// Define << ostream operator function
+std::ostream& operator << (std::ostream& os, const HestonOption& source)
+{
+	// Sends description to output stream
+	os << "Option " << source.m_id << ": " << source.m_type << ", T: " << source.m_T << ", K: " << source.m_K << ", S: "
+		<< source.m_S << ", r: " << source.m_r << ", v0: " << source.m_v0 << ", kappa: " << source.m_kappa << ", theta: "
+		<< source.m_theta << ", xi: " << source.m_xi << ", rho: " << source.m_rho << ", b: " << source.m_b;
+
+	// Returns the output stream
+	return os;
+}
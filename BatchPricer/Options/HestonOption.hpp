@@ -0,0 +1,125 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// HestonOption.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code for the HestonOption class
+
+// Header guard to avoid multiple inclusions
+#ifndef HESTONOPTION_HPP
+#define HESTONOPTION_HPP
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <ostream>
+#include "Option.hpp"
+
+// Class definition for a European option under the Heston stochastic volatility model, in which the variance follows
+// dv = kappa (theta - v) dt + xi sqrt(v) dW with correlation rho to the spot. The option is priced by the COS method
+// through HestonEngine; options that share everything but the strike and type should be priced together with
+// PriceChain(), which evaluates the characteristic function once for the whole strike chain.
+class HestonOption : public Option
+{
+private:
+
+	// Option type (call or put)
+	std::string m_type;
+	// Time to expiration
+	double m_T;
+	// Strike price
+	double m_K;
+	// Spot price
+	double m_S;
+	// Risk-free interest rate
+	double m_r;
+	// Initial variance
+	double m_v0;
+	// Speed of mean reversion of the variance
+	double m_kappa;
+	// Long-run variance
+	double m_theta;
+	// Volatility of the variance
+	double m_xi;
+	// Correlation between the spot and the variance
+	double m_rho;
+	// Cost of carry
+	double m_b;
+	// Option ID
+	int m_id;
+
+public:
+
+	// Constructor
+	HestonOption(const std::string& type, const double& T, const double& K, const double& S, const double& r, const double& v0,
+		const double& kappa, const double& theta, const double& xi, const double& rho, const int& id = 1,
+		const double& b = std::numeric_limits<double>::quiet_NaN());
+	// Copy constructor
+	HestonOption(const HestonOption& source);
+	// Assignment operator
+	HestonOption& operator=(const HestonOption& source);
+	// Convert option parameters to vector of strings
+	std::vector<std::string> ConvertToVectorString() const;
+
+	// Pricing functions
+	// Calculate option price
+	double Price() const;
+	// Calculate the prices of many options, one transform for each group of options that differ only in strike and type
+	static std::vector<double> PriceChain(const std::vector<HestonOption>& options);
+
+	// Numeric functions
+	// Calculate Numeric Delta
+	double NumericDelta(const double& h) const;
+	// Calculate Numeric Gamma
+	double NumericGamma(const double& h) const;
+
+	// Function to return whether two options differ only in strike, type and id, and so can share a transform
+	bool SameChain(const HestonOption& other) const;
+
+	// Parameter modification functions
+	// Set option type
+	HestonOption& type(const std::string& type);
+	// Set time to expiration
+	HestonOption& T(const double& T);
+	// Set strike price
+	HestonOption& K(const double& K);
+	// Set spot price
+	HestonOption& S(const double& S);
+	// Set risk-free interest rate
+	HestonOption& r(const double& r);
+	// Set initial volatility, the square root of the initial variance
+	HestonOption& sigma(const double& sigma);
+	// Set cost of carry
+	HestonOption& b(const double& b);
+	// Set the parameters of the variance process
+	HestonOption& Variance(const double& v0, const double& kappa, const double& theta, const double& xi, const double& rho);
+
+	// Get inline functions
+	// Get option type
+	const std::string& type() const { return m_type; }
+	// Get time to expiration
+	const double& T() const { return m_T; }
+	// Get strike price
+	const double& K() const { return m_K; }
+	// Get spot price
+	const double& S() const { return m_S; }
+	// Get risk-free interest rate
+	const double& r() const { return m_r; }
+	// Get initial volatility
+	double sigma() const;
+	// Get cost of carry
+	const double& b() const { return m_b; }
+	// Get parameters of the variance process
+	const double& v0() const { return m_v0; }
+	const double& kappa() const { return m_kappa; }
+	const double& theta() const { return m_theta; }
+	const double& xi() const { return m_xi; }
+	const double& rho() const { return m_rho; }
+	// Get option ID
+	const int& id() const { return m_id; }
+
+	// Friend functions
+	// Define << ostream operator function
+	friend std::ostream& operator << (std::ostream& os, const HestonOption& source);
+};
+
+// HESTONOPTION_HPP
+#endif
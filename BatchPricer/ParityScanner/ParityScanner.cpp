@@ -0,0 +1,170 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// ParityScanner.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the ParityScanner class
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "ParityScanner.hpp"
+#include "../Functions/Functions.hpp"
+
+// Default constructor
+ParityScanner::ParityScanner()
+{}
+
+// Constructor with quote file path
+ParityScanner::ParityScanner(const std::string& input_path)
+{
+    std::ifstream file(input_path);
+    if (!file)
+    {
+        throw std::invalid_argument("Unable to open quote file: " + input_path);
+    }
+
+    std::string line;
+    bool header = true;
+
+    while (std::getline(file, line))
+    {
+        if (header)
+        {
+            header = false;
+            continue;
+        }
+
+        if (line.empty() || line == "\r")
+        {
+            continue;
+        }
+
+        int id = 0;
+        double T = 0, K = 0, S = 0, r = 0, b = 0, call_price = 0, put_price = 0;
+        ParseRow(line, id, T, K, S, r, b, call_price, put_price);
+        Add(id, T, K, S, r, b, call_price, put_price);
+    }
+}
+
+// Copy constructor
+ParityScanner::ParityScanner(const ParityScanner& source) :
+    m_id(source.m_id),
+    m_K(source.m_K),
+    m_S(source.m_S),
+    m_carry(source.m_carry),
+    m_discount(source.m_discount),
+    m_call(source.m_call),
+    m_put(source.m_put),
+    m_violation(source.m_violation),
+    m_offenders(source.m_offenders)
+{}
+
+// Assignment operator
+ParityScanner& ParityScanner::operator=(const ParityScanner& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_id = source.m_id;
+    m_K = source.m_K;
+    m_S = source.m_S;
+    m_carry = source.m_carry;
+    m_discount = source.m_discount;
+    m_call = source.m_call;
+    m_put = source.m_put;
+    m_violation = source.m_violation;
+    m_offenders = source.m_offenders;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to add a matched call/put pair
+void ParityScanner::Add(const int& id, const double& T, const double& K, const double& S, const double& r, const double& b,
+    const double& call_price, const double& put_price)
+{
+    m_id.push_back(id);
+    m_K.push_back(K);
+    m_S.push_back(S);
+    m_carry.push_back(std::exp((b - r) * T));
+    m_discount.push_back(std::exp(-r * T));
+    m_call.push_back(call_price);
+    m_put.push_back(put_price);
+}
+
+// Function to update the quotes of pair i for a new snapshot
+void ParityScanner::Quote(const std::size_t& i, const double& S, const double& call_price, const double& put_price)
+{
+    m_S.at(i) = S;
+    m_call[i] = call_price;
+    m_put[i] = put_price;
+}
+
+// Function to compute the violations and rank the offending pairs
+const std::vector<ParityScanner::Violation>& ParityScanner::Scan(const double& threshold, const std::size_t& top)
+{
+    const std::size_t n = Size();
+    m_violation.resize(n);
+
+    // Branch-free pass over the columns, which the compiler can vectorize
+    const double* K = m_K.data();
+    const double* S = m_S.data();
+    const double* carry = m_carry.data();
+    const double* discount = m_discount.data();
+    const double* call = m_call.data();
+    const double* put = m_put.data();
+    double* violation = m_violation.data();
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        violation[i] = (call[i] - put[i]) - (S[i] * carry[i] - K[i] * discount[i]);
+    }
+
+    // Collect the offenders, usually a small fraction of the chain
+    m_offenders.clear();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        double excess = std::abs(violation[i]) - threshold;
+        if (excess > 0)
+        {
+            m_offenders.push_back({ m_id[i], violation[i], excess });
+        }
+    }
+
+    // Rank by decreasing excess, ties broken by pair number so the order is deterministic
+    auto larger = [](const Violation& a, const Violation& b)
+    {
+        return a.excess > b.excess || (a.excess == b.excess && a.id < b.id);
+    };
+
+    if (top != 0 && top < m_offenders.size())
+    {
+        std::partial_sort(m_offenders.begin(), m_offenders.begin() + top, m_offenders.end(), larger);
+        m_offenders.resize(top);
+    }
+    else
+    {
+        std::sort(m_offenders.begin(), m_offenders.end(), larger);
+    }
+
+    return m_offenders;
+}
+
+// Function to parse a row of the quote file
+void ParityScanner::ParseRow(const std::string& line, int& id, double& T, double& K, double& S, double& r, double& b,
+    double& call_price, double& put_price)
+{
+    std::string_view row[8];
+
+    if (splitFields(line, row, 8) < 8 || !parseField(row[0], id) || !parseField(row[1], T) || !parseField(row[2], K) ||
+        !parseField(row[3], S) || !parseField(row[4], r) || !parseField(row[5], b) || !parseField(row[6], call_price) ||
+        !parseField(row[7], put_price))
+    {
+        throw std::invalid_argument("Malformed parity quote row: " + line);
+    }
+}
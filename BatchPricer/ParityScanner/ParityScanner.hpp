@@ -0,0 +1,81 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// ParityScanner.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the ParityScanner class
+
+// If PARITYSCANNER_HPP is not defined
+#ifndef PARITYSCANNER_HPP
+// Define PARITYSCANNER_HPP
+#define PARITYSCANNER_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// Class definition for ParityScanner, which checks put-call parity for a whole chain of matched call/put quotes.
+// The quotes are stored column by column and the discount and carry factors of every pair are computed once when
+// it is loaded, so a scan is a single branch-free pass over contiguous arrays followed by a ranking of the pairs
+// that break parity. Nothing is printed and the result buffers are reused between scans.
+class ParityScanner
+{
+public:
+
+    // A pair that violates put-call parity by more than the threshold
+    struct Violation
+    {
+        int id; // Pair number
+        double violation; // (C - P) - (S * exp((b - r) * T) - K * exp(-r * T)), positive when the call is rich
+        double excess; // |violation| net of the threshold
+    };
+
+private:
+
+    std::vector<int> m_id; // Pair numbers
+    std::vector<double> m_K; // Strike prices
+    std::vector<double> m_S; // Underlying prices
+    std::vector<double> m_carry; // Carry factors exp((b - r) * T)
+    std::vector<double> m_discount; // Discount factors exp(-r * T)
+    std::vector<double> m_call; // Call prices
+    std::vector<double> m_put; // Put prices
+
+    std::vector<double> m_violation; // Signed violation of every pair, filled by Scan
+    std::vector<Violation> m_offenders; // Ranked offenders, filled by Scan
+
+public:
+
+    // Default constructor
+    ParityScanner();
+
+    // Constructor with quote file path
+    ParityScanner(const std::string& input_path);
+
+    // Copy constructor
+    ParityScanner(const ParityScanner& source);
+
+    // Assignment operator
+    ParityScanner& operator=(const ParityScanner& source);
+
+    // Function to add a matched call/put pair
+    void Add(const int& id, const double& T, const double& K, const double& S, const double& r, const double& b,
+        const double& call_price, const double& put_price);
+
+    // Function to update the quotes of pair i for a new snapshot
+    void Quote(const std::size_t& i, const double& S, const double& call_price, const double& put_price);
+
+    // Function to return the number of pairs
+    std::size_t Size() const { return m_id.size(); }
+
+    // Function to return the signed violations computed by the last scan, in input order
+    const std::vector<double>& Violations() const { return m_violation; }
+
+    // Function to compute the violation of every pair and return the pairs whose violation exceeds the threshold,
+    // ranked by decreasing excess. When top is non-zero only the top largest offenders are ranked and returned.
+    const std::vector<Violation>& Scan(const double& threshold, const std::size_t& top = 0);
+
+    // Function to parse a row of the quote file
+    static void ParseRow(const std::string& line, int& id, double& T, double& K, double& S, double& r, double& b,
+        double& call_price, double& put_price);
+};
+
+// End of the conditional inclusion of the header file
+#endif
@@ -0,0 +1,307 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// PricingCache.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the PricingCache class
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include "PricingCache.hpp"
+
+// Function to compare two keys
+bool PricingCache::Key::operator==(const Key& other) const
+{
+    return model == other.model && call == other.call && tag == other.tag &&
+        std::equal(fields, fields + 7, other.fields);
+}
+
+// Hash function of the keys
+std::size_t PricingCache::KeyHash::operator()(const Key& key) const
+{
+    // Each field is folded in through the splitmix64 finalizer, quantized parameters have many trailing zero bits
+    unsigned long long hash = 0x9e3779b97f4a7c15ull;
+    auto mix = [&hash](const unsigned long long& value)
+    {
+        unsigned long long z = hash ^ value;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        hash = z ^ (z >> 31);
+    };
+
+    mix(key.model | (static_cast<unsigned long long>(key.call) << 8) | (static_cast<unsigned long long>(key.tag) << 16));
+    for (const auto& field : key.fields)
+    {
+        mix(static_cast<unsigned long long>(field));
+    }
+
+    return static_cast<std::size_t>(hash);
+}
+
+// Function to quantize a parameter
+bool PricingCache::Quantize(const double& x, long long& q) const
+{
+    if (!std::isfinite(x))
+    {
+        return false;
+    }
+
+    // Exact matching compares the bit patterns, with -0 folded into 0
+    if (m_quantum == 0)
+    {
+        double value = x == 0 ? 0.0 : x;
+        std::memcpy(&q, &value, sizeof(q));
+        return true;
+    }
+
+    double scaled = std::round(x / m_quantum);
+    if (std::abs(scaled) >= 9.0e18)
+    {
+        return false;
+    }
+
+    q = static_cast<long long>(scaled);
+    return true;
+}
+
+// Function to return the shard that owns a key
+PricingCache::Shard& PricingCache::ShardOf(const Key& key, std::size_t& hash) const
+{
+    hash = KeyHash()(key);
+    return m_shards[(hash >> 7) % m_shard_count];
+}
+
+// Constructor with capacity in entries, quantum of the parameter grid and number of shards
+PricingCache::PricingCache(const std::size_t& capacity, const double& quantum, const std::size_t& shards) :
+    m_capacity(0),
+    m_quantum(quantum),
+    m_shard_count(shards),
+    m_hits(0),
+    m_misses(0),
+    m_evictions(0)
+{
+    if (capacity == 0 || shards == 0)
+    {
+        throw std::invalid_argument("The cache capacity and the number of shards must be positive");
+    }
+    if (quantum < 0)
+    {
+        throw std::invalid_argument("The cache quantum must not be negative");
+    }
+
+    m_capacity = std::max<std::size_t>(1, capacity / shards);
+    m_shards.reset(new Shard[shards]);
+
+    // Size the indexes up front so that filling the cache does not rehash
+    for (std::size_t i = 0; i < shards; ++i)
+    {
+        m_shards[i].index.reserve(m_capacity);
+    }
+}
+
+// Function to build the key of a European option
+bool PricingCache::MakeKey(const EuropeanOption& option, const unsigned int& tag, const double& h, Key& key) const
+{
+    key.model = 0;
+    key.call = option.type() == "Call";
+    key.tag = tag;
+
+    return Quantize(option.T(), key.fields[0]) && Quantize(option.K(), key.fields[1]) && Quantize(option.S(), key.fields[2]) &&
+        Quantize(option.r(), key.fields[3]) && Quantize(option.sigma(), key.fields[4]) && Quantize(option.b(), key.fields[5]) &&
+        Quantize(h, key.fields[6]);
+}
+
+// Function to build the key of an American perpetual option
+bool PricingCache::MakeKey(const AmericanOption& option, const unsigned int& tag, const double& h, Key& key) const
+{
+    key.model = 1;
+    key.call = option.type() == "Call";
+    key.tag = tag;
+    key.fields[0] = 0;
+
+    return Quantize(option.K(), key.fields[1]) && Quantize(option.S(), key.fields[2]) && Quantize(option.r(), key.fields[3]) &&
+        Quantize(option.sigma(), key.fields[4]) && Quantize(option.b(), key.fields[5]) && Quantize(h, key.fields[6]);
+}
+
+// Function to build the key of a Heston option
+bool PricingCache::MakeKey(const HestonOption&, const unsigned int&, const double&, Key&) const
+{
+    // The ten parameters of the model do not fit in the key, Heston options are not cached
+    return false;
+}
+
+// Function to look up a key
+bool PricingCache::Find(const Key& key, double* values, int& count)
+{
+    std::size_t hash = 0;
+    Shard& shard = ShardOf(key, hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if (it == shard.index.end())
+    {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Move the entry to the front of the recency list
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+
+    const Entry& entry = it->second->second;
+    count = entry.count;
+    std::copy(entry.values, entry.values + entry.count, values);
+
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// Function to store the values computed for a key
+void PricingCache::Insert(const Key& key, const double* values, const int& count)
+{
+    if (count < 0 || count > MAX_VALUES)
+    {
+        throw std::invalid_argument("Too many values for a cache entry");
+    }
+
+    std::size_t hash = 0;
+    Shard& shard = ShardOf(key, hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if (it != shard.index.end())
+    {
+        // Another thread priced the same key first, refresh its values
+        Entry& entry = it->second->second;
+        entry.count = count;
+        std::copy(values, values + count, entry.values);
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return;
+    }
+
+    if (shard.entries.size() >= m_capacity)
+    {
+        // Reuse the node of the least recently used entry
+        auto last = std::prev(shard.entries.end());
+        shard.index.erase(last->first);
+        shard.entries.splice(shard.entries.begin(), shard.entries, last);
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        shard.entries.emplace_front();
+    }
+
+    auto& front = shard.entries.front();
+    front.first = key;
+    front.second.count = count;
+    std::copy(values, values + count, front.second.values);
+    shard.index[key] = shard.entries.begin();
+}
+
+// Function to remove every entry and reset the counters
+void PricingCache::Clear()
+{
+    for (std::size_t i = 0; i < m_shard_count; ++i)
+    {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        m_shards[i].entries.clear();
+        m_shards[i].index.clear();
+    }
+
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+}
+
+// Function to return the number of cached entries
+std::size_t PricingCache::Size() const
+{
+    std::size_t size = 0;
+
+    for (std::size_t i = 0; i < m_shard_count; ++i)
+    {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        size += m_shards[i].entries.size();
+    }
+
+    return size;
+}
+
+// Function to return the tag of a European option measure
+unsigned int PricingCache::MeasureTag(double (EuropeanOption::* func)(void) const)
+{
+    // Same order as the measure flags, so that a single measure shares its entries with the matrix pricers
+    static double (EuropeanOption::* const measures[EuropeanOption::MEASURE_COUNT])(void) const =
+    {
+        &EuropeanOption::Price, &EuropeanOption::PricePutCallParity, &EuropeanOption::Delta, &EuropeanOption::Gamma,
+        &EuropeanOption::Vega, &EuropeanOption::Theta, &EuropeanOption::Rho, &EuropeanOption::Vanna, &EuropeanOption::Charm,
+        &EuropeanOption::Speed, &EuropeanOption::Color, &EuropeanOption::DvegaDtime, &EuropeanOption::Vomma,
+        &EuropeanOption::Veta, &EuropeanOption::Zomma, &EuropeanOption::Lambda, &EuropeanOption::Ultima
+    };
+
+    for (unsigned int i = 0; i < EuropeanOption::MEASURE_COUNT; ++i)
+    {
+        if (measures[i] == func) return 1u << i;
+    }
+
+    return 0;
+}
+
+// Function to return the tag of a European option numeric sensitivity
+unsigned int PricingCache::MeasureTag(double (EuropeanOption::* func)(const double&) const)
+{
+    if (func == &EuropeanOption::NumericDelta) return TAG_NUMERIC_DELTA;
+    if (func == &EuropeanOption::NumericGamma) return TAG_NUMERIC_GAMMA;
+
+    return 0;
+}
+
+// Function to return the tag of an American perpetual option measure
+unsigned int PricingCache::MeasureTag(double (AmericanOption::* func)(void) const)
+{
+    if (func == &AmericanOption::Price) return AmericanOption::MEASURE_PRICE;
+    if (func == &AmericanOption::Delta) return AmericanOption::MEASURE_DELTA;
+    if (func == &AmericanOption::Gamma) return AmericanOption::MEASURE_GAMMA;
+    if (func == &AmericanOption::Vega) return AmericanOption::MEASURE_VEGA;
+    if (func == &AmericanOption::Rho) return AmericanOption::MEASURE_RHO;
+    if (func == &AmericanOption::CarryRho) return AmericanOption::MEASURE_CARRY_RHO;
+
+    return 0;
+}
+
+// Function to return the tag of an American perpetual option numeric sensitivity
+unsigned int PricingCache::MeasureTag(double (AmericanOption::* func)(const double&) const)
+{
+    if (func == &AmericanOption::NumericDelta) return AmericanOption::MEASURE_NUMERIC_DELTA;
+    if (func == &AmericanOption::NumericGamma) return AmericanOption::MEASURE_NUMERIC_GAMMA;
+
+    return 0;
+}
+
+// Function to return the tag of a Heston option measure, the Heston options are not cached
+unsigned int PricingCache::MeasureTag(double (HestonOption::*)(void) const)
+{
+    return 0;
+}
+
+// Function to return the tag of a Heston option numeric sensitivity, the Heston options are not cached
+unsigned int PricingCache::MeasureTag(double (HestonOption::*)(const double&) const)
+{
+    return 0;
+}
+
+// Overloaded stream insertion operator
+std::ostream& operator<<(std::ostream& os, const PricingCache& cache)
+{
+    unsigned long long lookups = cache.Hits() + cache.Misses();
+
+    os << "Pricing cache: " << cache.Size() << " entries, " << cache.Hits() << " hits, " << cache.Misses() << " misses";
+    if (lookups != 0)
+    {
+        os << " (" << 100.0 * cache.Hits() / lookups << "% hit rate)";
+    }
+    os << ", " << cache.Evictions() << " evictions";
+
+    return os;
+}
@@ -0,0 +1,131 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// PricingCache.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the PricingCache class
+
+// If PRICINGCACHE_HPP is not defined
+#ifndef PRICINGCACHE_HPP
+// Define PRICINGCACHE_HPP
+#define PRICINGCACHE_HPP
+
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <iostream>
+#include <unordered_map>
+
+#include "../Options/EuropeanOption.hpp"
+#include "../Options/AmericanOption.hpp"
+#include "../Options/HestonOption.hpp"
+
+// Class definition for PricingCache, a thread-safe memo of pricing results shared by the pricers.
+// An entry maps an option (model, type and parameters quantized to a grid) together with a tag naming what was
+// computed (a measure bitmask or a single measure) and the shock size to the values the pricer produced. The
+// cache is split into shards, each with its own lock and least recently used list, so concurrent pricer threads
+// rarely contend; the capacity is divided evenly among the shards.
+class PricingCache
+{
+public:
+
+    // Maximum number of values stored per entry
+    static const int MAX_VALUES = EuropeanOption::MEASURE_COUNT;
+
+    // Tags of the numeric sensitivities of EuropeanOption, outside the range of the measure bitmasks
+    static const unsigned int TAG_NUMERIC_DELTA = 1u << 30;
+    static const unsigned int TAG_NUMERIC_GAMMA = 1u << 31;
+
+    // Quantized lookup key
+    struct Key
+    {
+        unsigned char model = 0; // 0 for European, 1 for American
+        unsigned char call = 0; // 1 for calls, 0 for puts
+        unsigned int tag = 0; // What was computed
+        long long fields[7] = {}; // Quantized T, K, S, r, sigma, b and h
+
+        bool operator==(const Key& other) const;
+    };
+
+    // Hash function of the keys
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const;
+    };
+
+private:
+
+    // Cached values of an entry
+    struct Entry
+    {
+        int count = 0;
+        double values[MAX_VALUES];
+    };
+
+    // Shard of the cache, entries ordered from most to least recently used
+    struct Shard
+    {
+        std::mutex mutex;
+        std::list<std::pair<Key, Entry>> entries;
+        std::unordered_map<Key, std::list<std::pair<Key, Entry>>::iterator, KeyHash> index;
+    };
+
+    std::size_t m_capacity; // Maximum number of entries per shard
+    double m_quantum; // Grid spacing of the quantized parameters, 0 for exact matching
+    std::unique_ptr<Shard[]> m_shards;
+    std::size_t m_shard_count;
+
+    std::atomic<unsigned long long> m_hits;
+    std::atomic<unsigned long long> m_misses;
+    std::atomic<unsigned long long> m_evictions;
+
+    // Function to quantize a parameter, returns false when it cannot be represented on the grid
+    bool Quantize(const double& x, long long& q) const;
+
+    // Function to return the shard that owns a key
+    Shard& ShardOf(const Key& key, std::size_t& hash) const;
+
+public:
+
+    // Constructor with capacity in entries, quantum of the parameter grid and number of shards
+    PricingCache(const std::size_t& capacity = 1 << 16, const double& quantum = 1e-12, const std::size_t& shards = 16);
+
+    // The cache owns locks and is shared through pointers, so it is not copyable
+    PricingCache(const PricingCache& source) = delete;
+    PricingCache& operator=(const PricingCache& source) = delete;
+
+    // Functions to build the key of an option, return false when the option cannot be cached (e.g. NaN parameters)
+    bool MakeKey(const EuropeanOption& option, const unsigned int& tag, const double& h, Key& key) const;
+    bool MakeKey(const AmericanOption& option, const unsigned int& tag, const double& h, Key& key) const;
+    bool MakeKey(const HestonOption& option, const unsigned int& tag, const double& h, Key& key) const;
+
+    // Function to look up a key, copies the cached values and returns true on a hit
+    bool Find(const Key& key, double* values, int& count);
+
+    // Function to store the values computed for a key, evicting the least recently used entry of a full shard
+    void Insert(const Key& key, const double* values, const int& count);
+
+    // Function to remove every entry and reset the counters
+    void Clear();
+
+    // Functions to return the statistics of the cache
+    unsigned long long Hits() const { return m_hits.load(); }
+    unsigned long long Misses() const { return m_misses.load(); }
+    unsigned long long Evictions() const { return m_evictions.load(); }
+    std::size_t Size() const;
+
+    // Functions to return the tag of a single measure member function, 0 when the function has no tag
+    static unsigned int MeasureTag(double (EuropeanOption::* func)(void) const);
+    static unsigned int MeasureTag(double (EuropeanOption::* func)(const double&) const);
+    static unsigned int MeasureTag(double (AmericanOption::* func)(void) const);
+    static unsigned int MeasureTag(double (AmericanOption::* func)(const double&) const);
+    static unsigned int MeasureTag(double (HestonOption::* func)(void) const);
+    static unsigned int MeasureTag(double (HestonOption::* func)(const double&) const);
+
+    // Overloaded stream insertion operator
+    friend std::ostream& operator<<(std::ostream& os, const PricingCache& cache);
+};
+
+// End of the conditional inclusion of the header file
+#endif
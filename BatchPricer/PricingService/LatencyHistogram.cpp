@@ -0,0 +1,124 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// LatencyHistogram.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the LatencyHistogram class
+
+#include <cmath>
+#include <algorithm>
+
+#include "LatencyHistogram.hpp"
+
+// Function to map a duration to its bucket
+std::size_t LatencyHistogram::Bucket(const std::uint64_t& nanoseconds)
+{
+    if (nanoseconds < SUB_BUCKETS)
+    {
+        return static_cast<std::size_t>(nanoseconds);
+    }
+
+    // Position of the highest set bit, then the next four bits select the bucket within the power of two
+    int exponent = 63;
+    while ((nanoseconds >> exponent) == 0) --exponent;
+
+    return (exponent - 3) * SUB_BUCKETS + static_cast<std::size_t>((nanoseconds >> (exponent - 4)) & (SUB_BUCKETS - 1));
+}
+
+// Function to return the midpoint of the range of a bucket
+double LatencyHistogram::Midpoint(const std::size_t& bucket)
+{
+    if (bucket < SUB_BUCKETS)
+    {
+        return static_cast<double>(bucket);
+    }
+
+    int exponent = static_cast<int>(bucket / SUB_BUCKETS) + 3;
+    double width = std::ldexp(1.0, exponent - 4);
+
+    return std::ldexp(1.0, exponent) + (bucket % SUB_BUCKETS + 0.5) * width;
+}
+
+// Default constructor
+LatencyHistogram::LatencyHistogram() :
+    m_counts(61 * SUB_BUCKETS, 0),
+    m_count(0),
+    m_sum(0)
+{}
+
+// Copy constructor
+LatencyHistogram::LatencyHistogram(const LatencyHistogram& source) :
+    m_counts(source.m_counts),
+    m_count(source.m_count),
+    m_sum(source.m_sum)
+{}
+
+// Assignment operator
+LatencyHistogram& LatencyHistogram::operator=(const LatencyHistogram& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_counts = source.m_counts;
+    m_count = source.m_count;
+    m_sum = source.m_sum;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to record a duration in nanoseconds
+void LatencyHistogram::Add(const std::uint64_t& nanoseconds)
+{
+    ++m_counts[Bucket(nanoseconds)];
+    ++m_count;
+    m_sum += static_cast<double>(nanoseconds);
+}
+
+// Function to add the samples of another histogram
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+    for (std::size_t k = 0; k < m_counts.size(); ++k)
+    {
+        m_counts[k] += other.m_counts[k];
+    }
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+}
+
+// Function to remove every sample
+void LatencyHistogram::Clear()
+{
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_count = 0;
+    m_sum = 0;
+}
+
+// Function to return the mean duration in seconds
+double LatencyHistogram::Mean() const
+{
+    return m_count == 0 ? 0 : m_sum / m_count * 1e-9;
+}
+
+// Function to return the duration in seconds below which a fraction p of the samples lie
+double LatencyHistogram::Percentile(const double& p) const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+
+    // Rank of the sample, counted from 1
+    std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(p * m_count)));
+    std::uint64_t seen = 0;
+
+    for (std::size_t k = 0; k < m_counts.size(); ++k)
+    {
+        seen += m_counts[k];
+        if (seen >= rank)
+        {
+            return Midpoint(k) * 1e-9;
+        }
+    }
+
+    return Midpoint(m_counts.size() - 1) * 1e-9;
+}
@@ -0,0 +1,215 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// LoadGenerator.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the LoadGenerator class
+
+#include <cstring>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+
+#include "LoadGenerator.hpp"
+
+// Function run by each connection thread
+std::size_t LoadGenerator::Connection(const std::size_t& index, LatencyHistogram& latency, std::size_t& errors) const
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, m_path.c_str(), sizeof(address.sun_path) - 1);
+
+    SocketHandle socket_handle = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket_handle == INVALID_SOCKET_HANDLE ||
+        connect(socket_handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        if (socket_handle != INVALID_SOCKET_HANDLE) CloseSocket(socket_handle);
+        return 0;
+    }
+
+    // Options drawn around the money, the same sequence for every run
+    std::mt19937_64 generator(index + 1);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    std::vector<std::chrono::steady_clock::time_point> sent(m_requests);
+    std::vector<char> buffer(1 << 16);
+    std::size_t filled = 0, next = 0, done = 0;
+
+    while (done < m_requests)
+    {
+        // Top up the window, one request per send as a single-option caller would
+        while (next < m_requests && next - done < m_window)
+        {
+            PricingRequest request = {};
+            request.id = next;
+            request.mask = m_mask;
+            request.model = m_model;
+            request.call = next % 2 == 0;
+            request.T = 0.1 + 2 * uniform(generator);
+            request.S = 100;
+            request.K = 70 + 60 * uniform(generator);
+            request.r = 0.01 + 0.05 * uniform(generator);
+            request.sigma = 0.1 + 0.4 * uniform(generator);
+            request.b = request.r;
+
+            sent[next] = std::chrono::steady_clock::now();
+            if (send(socket_handle, reinterpret_cast<const char*>(&request), sizeof(request), SOCKET_SEND_FLAGS) != sizeof(request))
+            {
+                CloseSocket(socket_handle);
+                return done;
+            }
+            ++next;
+        }
+
+        int received = recv(socket_handle, buffer.data() + filled, static_cast<int>(buffer.size() - filled), 0);
+        if (received <= 0)
+        {
+            break;
+        }
+        filled += received;
+        auto now = std::chrono::steady_clock::now();
+
+        // Consume every complete response of the buffer
+        std::size_t used = 0;
+        while (filled - used >= sizeof(PricingResponse))
+        {
+            PricingResponse response;
+            std::memcpy(&response, buffer.data() + used, sizeof(response));
+            std::size_t size = sizeof(response) + response.count * sizeof(double);
+            if (filled - used < size)
+            {
+                break;
+            }
+
+            if (response.status != PRICING_STATUS_OK || response.id >= next)
+            {
+                ++errors;
+            }
+            else
+            {
+                latency.Add(std::chrono::duration_cast<std::chrono::nanoseconds>(now - sent[response.id]).count());
+            }
+            ++done;
+            used += size;
+        }
+
+        std::memmove(buffer.data(), buffer.data() + used, filled - used);
+        filled -= used;
+    }
+
+    CloseSocket(socket_handle);
+    return done;
+}
+
+// Constructor with the socket path, the number of connections, the requests per connection, the window, the measures and the model
+LoadGenerator::LoadGenerator(const std::string& socket_path, const std::size_t& connections, const std::size_t& requests,
+    const std::size_t& window, const std::uint32_t& mask, const std::uint8_t& model) :
+    m_path(socket_path),
+    m_connections(connections),
+    m_requests(requests),
+    m_window(window),
+    m_mask(mask),
+    m_model(model),
+    m_seconds(0),
+    m_errors(0)
+{
+    if (connections == 0 || window == 0)
+    {
+        throw std::invalid_argument("The load generator needs at least one connection and a positive window");
+    }
+    if (socket_path.empty() || socket_path.size() >= sizeof(sockaddr_un().sun_path))
+    {
+        throw std::invalid_argument("Invalid socket path: " + socket_path);
+    }
+}
+
+// Copy constructor
+LoadGenerator::LoadGenerator(const LoadGenerator& source) :
+    m_path(source.m_path),
+    m_connections(source.m_connections),
+    m_requests(source.m_requests),
+    m_window(source.m_window),
+    m_mask(source.m_mask),
+    m_model(source.m_model),
+    m_latency(source.m_latency),
+    m_seconds(source.m_seconds),
+    m_errors(source.m_errors)
+{}
+
+// Assignment operator
+LoadGenerator& LoadGenerator::operator=(const LoadGenerator& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_path = source.m_path;
+    m_connections = source.m_connections;
+    m_requests = source.m_requests;
+    m_window = source.m_window;
+    m_mask = source.m_mask;
+    m_model = source.m_model;
+    m_latency = source.m_latency;
+    m_seconds = source.m_seconds;
+    m_errors = source.m_errors;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to run the load
+std::size_t LoadGenerator::Run()
+{
+#ifdef _WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+
+    std::vector<LatencyHistogram> latencies(m_connections);
+    std::vector<std::size_t> errors(m_connections, 0), completed(m_connections, 0);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t k = 0; k < m_connections; ++k)
+    {
+        threads.emplace_back([this, k, &latencies, &errors, &completed]
+            {
+                completed[k] = Connection(k, latencies[k], errors[k]);
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    m_latency.Clear();
+    m_errors = 0;
+    std::size_t total = 0;
+    for (std::size_t k = 0; k < m_connections; ++k)
+    {
+        m_latency.Merge(latencies[k]);
+        m_errors += errors[k];
+        total += completed[k];
+    }
+
+    if (total == 0)
+    {
+        throw std::runtime_error("Unable to reach the pricing server on socket: " + m_path);
+    }
+
+    return total;
+}
+
+// Overloaded stream insertion operator
+std::ostream& operator<<(std::ostream& os, const LoadGenerator& generator)
+{
+    os << "Load generator: " << generator.m_latency.Count() << " requests on " << generator.m_connections
+        << " connections with a window of " << generator.m_window << ", p50: " << generator.m_latency.Percentile(0.5) * 1e6
+        << " us, p99: " << generator.m_latency.Percentile(0.99) * 1e6 << " us, " << generator.Throughput() << " requests/s";
+    if (generator.m_errors != 0)
+    {
+        os << ", " << generator.m_errors << " errors";
+    }
+
+    return os;
+}
@@ -0,0 +1,68 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// LoadGenerator.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the LoadGenerator class
+
+// If LOADGENERATOR_HPP is not defined
+#ifndef LOADGENERATOR_HPP
+// Define LOADGENERATOR_HPP
+#define LOADGENERATOR_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+#include "PricingProtocol.hpp"
+#include "LatencyHistogram.hpp"
+
+// Class definition for LoadGenerator, a client of the pricing service that opens a number of connections and sends
+// single-option requests on each, keeping up to a window of requests in flight per connection. With a window of 1
+// every connection behaves like a process repricing one option at a time; larger windows pipeline the requests.
+// The round-trip time of every request is recorded, and the run reports the latency percentiles and the throughput.
+class LoadGenerator
+{
+private:
+
+    std::string m_path; // Path of the server socket
+    std::size_t m_connections; // Number of concurrent connections
+    std::size_t m_requests; // Number of requests per connection
+    std::size_t m_window; // Largest number of requests in flight per connection
+    std::uint32_t m_mask; // Measure flags of the requests
+    std::uint8_t m_model; // PricingModel of the requests
+
+    LatencyHistogram m_latency; // Round-trip times of the last run
+    double m_seconds; // Duration of the last run
+    std::size_t m_errors; // Number of responses with an error status or a mismatched id
+
+    // Function run by each connection thread, returns the number of requests completed
+    std::size_t Connection(const std::size_t& index, LatencyHistogram& latency, std::size_t& errors) const;
+
+public:
+
+    // Constructor with the socket path, the number of connections, the requests per connection, the window, the measures
+    // and the model of the requests
+    LoadGenerator(const std::string& socket_path, const std::size_t& connections = 4, const std::size_t& requests = 10000,
+        const std::size_t& window = 1, const std::uint32_t& mask = 1, const std::uint8_t& model = PRICING_MODEL_EUROPEAN);
+
+    // Copy constructor
+    LoadGenerator(const LoadGenerator& source);
+
+    // Assignment operator
+    LoadGenerator& operator=(const LoadGenerator& source);
+
+    // Function to run the load, returns the number of requests completed
+    std::size_t Run();
+
+    // Functions to return the results of the last run
+    const LatencyHistogram& Latency() const { return m_latency; }
+    double Throughput() const { return m_seconds > 0 ? m_latency.Count() / m_seconds : 0; }
+    std::size_t Errors() const { return m_errors; }
+
+    // Overloaded stream insertion operator
+    friend std::ostream& operator<<(std::ostream& os, const LoadGenerator& generator);
+};
+
+// End of the conditional inclusion of the header file
+#endif
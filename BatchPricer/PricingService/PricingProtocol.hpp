@@ -0,0 +1,80 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// PricingProtocol.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code of the binary protocol of the pricing service
+
+// If PRICINGPROTOCOL_HPP is not defined
+#ifndef PRICINGPROTOCOL_HPP
+// Define PRICINGPROTOCOL_HPP
+#define PRICINGPROTOCOL_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+// Sockets of the local pricing service, Unix-domain sockets are available on Windows 10 and later through afunix.h
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#pragma comment(lib, "Ws2_32.lib")
+typedef SOCKET SocketHandle;
+const SocketHandle INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+const int SOCKET_SEND_FLAGS = 0;
+inline void CloseSocket(const SocketHandle& socket) { closesocket(socket); }
+inline void ShutdownSocket(const SocketHandle& socket) { shutdown(socket, SD_BOTH); }
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+typedef int SocketHandle;
+const SocketHandle INVALID_SOCKET_HANDLE = -1;
+const int SOCKET_SEND_FLAGS = MSG_NOSIGNAL;
+inline void CloseSocket(const SocketHandle& socket) { close(socket); }
+inline void ShutdownSocket(const SocketHandle& socket) { shutdown(socket, SHUT_RDWR); }
+#endif
+
+// Requests and responses are fixed-layout records in the native byte order of the machine, the service only listens
+// on a local socket. A client may pipeline any number of requests on one connection; every request is answered with
+// exactly one response carrying the same id, in the order the requests were received.
+
+// Option models of a request
+enum PricingModel : std::uint8_t
+{
+    PRICING_MODEL_EUROPEAN = 0,
+    PRICING_MODEL_AMERICAN = 1
+};
+
+// Status codes of a response
+enum PricingStatus : std::int32_t
+{
+    PRICING_STATUS_OK = 0,
+    PRICING_STATUS_UNKNOWN_MODEL = 1,
+    PRICING_STATUS_EMPTY_MASK = 2
+};
+
+// Request to price one option, 64 bytes
+struct PricingRequest
+{
+    std::uint64_t id; // Client identifier echoed in the response
+    std::uint32_t mask; // Measure flags of the model (EuropeanOption or AmericanOption MeasureFlag)
+    std::uint8_t model; // PricingModel
+    std::uint8_t call; // 1 for a call, 0 for a put
+    std::uint16_t reserved; // Must be 0
+    double T, K, S, r, sigma, b; // Option parameters, T is ignored by the American perpetual model
+};
+
+// Header of the response to a request, followed by count doubles in the flag order of the measures
+struct PricingResponse
+{
+    std::uint64_t id; // Identifier of the request
+    std::int32_t status; // PricingStatus
+    std::uint32_t count; // Number of values that follow
+};
+
+// Largest number of values of a response
+const std::size_t PRICING_MAX_VALUES = 17;
+
+static_assert(sizeof(PricingRequest) == 64, "PricingRequest must be 64 bytes");
+static_assert(sizeof(PricingResponse) == 16, "PricingResponse must be 16 bytes");
+
+// End of the conditional inclusion of the header file
+#endif
@@ -0,0 +1,389 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// PricingServer.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the PricingServer class
+
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <stdexcept>
+
+#include "PricingServer.hpp"
+#include "../Options/EuropeanOption.hpp"
+#include "../Options/AmericanOption.hpp"
+
+// Function run by the acceptor thread
+void PricingServer::AcceptLoop()
+{
+    while (m_running)
+    {
+        SocketHandle socket = accept(m_listener, nullptr, nullptr);
+        if (socket == INVALID_SOCKET_HANDLE)
+        {
+            // The listener is shut down on stop, other failures (e.g. an aborted connection) are skipped
+            if (!m_running) break;
+            continue;
+        }
+
+        std::shared_ptr<Connection> connection = std::make_shared<Connection>(socket);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+        {
+            break;
+        }
+
+        // Join the readers of the connections that were closed since the last accept
+        for (std::size_t k = 0; k < m_readers.size();)
+        {
+            std::shared_ptr<Connection> open = m_readers[k].second.lock();
+            if (open && !open->closed)
+            {
+                ++k;
+                continue;
+            }
+            m_readers[k].first.join();
+            std::swap(m_readers[k], m_readers.back());
+            m_readers.pop_back();
+        }
+
+        m_readers.emplace_back(std::thread(&PricingServer::ReadLoop, this, connection), connection);
+    }
+}
+
+// Function run by the reader thread of a connection
+void PricingServer::ReadLoop(std::shared_ptr<Connection> connection)
+{
+    std::vector<char> buffer(1 << 16);
+    std::size_t filled = 0;
+
+    while (m_running)
+    {
+        int received = recv(connection->socket, buffer.data() + filled, static_cast<int>(buffer.size() - filled), 0);
+        if (received <= 0)
+        {
+            break;
+        }
+        filled += received;
+
+        // Queue every complete request of the buffer under one lock and keep the partial one
+        std::size_t count = filled / sizeof(PricingRequest);
+        if (count == 0)
+        {
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                Pending pending;
+                std::memcpy(&pending.request, buffer.data() + k * sizeof(PricingRequest), sizeof(PricingRequest));
+                pending.connection = connection;
+                pending.arrival = now;
+                m_queue.push_back(std::move(pending));
+            }
+
+            // Requests received together count as arriving one gap apart over the time since the last read
+            double gap = std::chrono::duration<double>(now - m_last_arrival).count() / count;
+            m_gap = 0.9 * m_gap + 0.1 * std::min(gap, m_budget.count());
+            m_last_arrival = now;
+        }
+        m_ready.notify_one();
+
+        std::size_t used = count * sizeof(PricingRequest);
+        std::memmove(buffer.data(), buffer.data() + used, filled - used);
+        filled -= used;
+    }
+
+    connection->closed = true;
+}
+
+// Function to wait for and take the next batch from the queue
+bool PricingServer::NextBatch(std::vector<Pending>& batch)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_ready.wait(lock, [this] { return !m_queue.empty() || !m_running; });
+
+    if (!m_running)
+    {
+        return false;
+    }
+
+    // Keep collecting while the next request is expected before the deadline of the oldest one. Waiting only pays when
+    // other clients are active, so it is skipped while recent waits gained nothing, except for a periodic probe.
+    const std::size_t initial = m_queue.size();
+    const bool wait = m_gain >= 0.5 || ++m_probe % 32 == 0;
+    bool waited = false;
+
+    while (wait)
+    {
+        std::size_t queued = m_queue.size();
+        if (queued >= m_max_batch)
+        {
+            break;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        auto deadline = m_queue.front().arrival + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            m_budget - std::chrono::duration<double>(m_cost * (queued + 1)));
+        auto gap = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(m_gap));
+
+        if (now + gap >= deadline)
+        {
+            break;
+        }
+
+        // Give up on the next request when it is late by more than one expected gap
+        waited = true;
+        m_ready.wait_until(lock, std::min(deadline, now + 2 * gap));
+        if (!m_running || m_queue.size() == queued)
+        {
+            break;
+        }
+    }
+
+    if (waited)
+    {
+        m_gain = 0.8 * m_gain + 0.2 * static_cast<double>(m_queue.size() - initial);
+    }
+
+    std::size_t size = std::min(m_queue.size(), m_max_batch);
+    batch.assign(std::make_move_iterator(m_queue.begin()), std::make_move_iterator(m_queue.begin() + size));
+    m_queue.erase(m_queue.begin(), m_queue.begin() + size);
+
+    return true;
+}
+
+// Function to price one request
+PricingStatus PricingServer::PriceRequest(const PricingRequest& request, double* values, std::uint32_t& count) const
+{
+    const std::string type = request.call ? "Call" : "Put";
+    count = 0;
+
+    if (request.model == PRICING_MODEL_EUROPEAN)
+    {
+        unsigned int mask = request.mask & EuropeanOption::MEASURE_CONFIG_ALL;
+        if (mask == 0) return PRICING_STATUS_EMPTY_MASK;
+
+        EuropeanOption option(type, request.T, request.K, request.S, request.r, request.sigma, 1, request.b);
+
+        // Smallest specialization of the kernel that covers the requested measures
+        if ((mask & ~EuropeanOption::MEASURE_CONFIG_PRICE) == 0)
+            count = option.Measures<EuropeanOption::MEASURE_CONFIG_PRICE>(mask, values);
+        else if ((mask & ~EuropeanOption::MEASURE_CONFIG_BASIC) == 0)
+            count = option.Measures<EuropeanOption::MEASURE_CONFIG_BASIC>(mask, values);
+        else
+            count = option.Measures<EuropeanOption::MEASURE_CONFIG_ALL>(mask, values);
+
+        return PRICING_STATUS_OK;
+    }
+
+    if (request.model == PRICING_MODEL_AMERICAN)
+    {
+        unsigned int mask = request.mask & AmericanOption::MEASURE_CONFIG_ALL;
+        if (mask == 0) return PRICING_STATUS_EMPTY_MASK;
+
+        AmericanOption option(type, request.K, request.S, request.r, request.sigma, request.b);
+
+        if ((mask & ~AmericanOption::MEASURE_CONFIG_PRICE) == 0)
+            count = option.Measures<AmericanOption::MEASURE_CONFIG_PRICE>(mask, m_h, values);
+        else if ((mask & ~AmericanOption::MEASURE_CONFIG_BASIC) == 0)
+            count = option.Measures<AmericanOption::MEASURE_CONFIG_BASIC>(mask, m_h, values);
+        else
+            count = option.Measures<AmericanOption::MEASURE_CONFIG_ALL>(mask, m_h, values);
+
+        return PRICING_STATUS_OK;
+    }
+
+    return PRICING_STATUS_UNKNOWN_MODEL;
+}
+
+// Function run by the batcher thread
+void PricingServer::BatchLoop()
+{
+    std::vector<Pending> batch;
+    std::vector<Connection*> touched;
+    batch.reserve(m_max_batch);
+
+    while (NextBatch(batch))
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        // Price the batch, appending each response to the output of its connection
+        touched.clear();
+        for (const auto& pending : batch)
+        {
+            Connection& connection = *pending.connection;
+            if (connection.output.empty())
+            {
+                touched.push_back(&connection);
+            }
+
+            double values[PRICING_MAX_VALUES];
+            PricingResponse response;
+            response.id = pending.request.id;
+            response.status = PriceRequest(pending.request, values, response.count);
+
+            const char* header = reinterpret_cast<const char*>(&response);
+            const char* body = reinterpret_cast<const char*>(values);
+            connection.output.insert(connection.output.end(), header, header + sizeof(response));
+            connection.output.insert(connection.output.end(), body, body + response.count * sizeof(double));
+        }
+
+        // One send per connection for the whole batch
+        for (auto connection : touched)
+        {
+            std::size_t sent = 0;
+            while (!connection->failed && sent < connection->output.size())
+            {
+                int n = send(connection->socket, connection->output.data() + sent,
+                    static_cast<int>(connection->output.size() - sent), SOCKET_SEND_FLAGS);
+                if (n <= 0) connection->failed = true;
+                else sent += n;
+            }
+            connection->output.clear();
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(m_statistics_mutex);
+            for (const auto& pending : batch)
+            {
+                m_latency.Add(std::chrono::duration_cast<std::chrono::nanoseconds>(end - pending.arrival).count());
+            }
+            ++m_batches;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_cost = 0.9 * m_cost + 0.1 * std::chrono::duration<double>(end - start).count() / batch.size();
+        }
+
+        // Release the connections held by the batch
+        batch.clear();
+    }
+}
+
+// Constructor with the socket path, the latency budget, the largest batch and the shock size
+PricingServer::PricingServer(const std::string& socket_path, const double& budget_us, const std::size_t& max_batch, const double& h) :
+    m_path(socket_path),
+    m_budget(budget_us * 1e-6),
+    m_max_batch(max_batch),
+    m_h(h),
+    m_listener(INVALID_SOCKET_HANDLE),
+    m_running(false),
+    m_gap(0),
+    m_cost(0),
+    m_gain(1),
+    m_probe(0),
+    m_batches(0)
+{
+    if (!(budget_us >= 0) || max_batch == 0)
+    {
+        throw std::invalid_argument("The latency budget must not be negative and the batch size must be positive");
+    }
+    if (socket_path.empty() || socket_path.size() >= sizeof(sockaddr_un().sun_path))
+    {
+        throw std::invalid_argument("Invalid socket path: " + socket_path);
+    }
+}
+
+// Destructor
+PricingServer::~PricingServer()
+{
+    Stop();
+}
+
+// Function to bind the socket and start serving
+void PricingServer::Start()
+{
+    if (m_running)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, m_path.c_str(), sizeof(address.sun_path) - 1);
+
+    // A socket file left behind by a previous server would make the bind fail
+    std::remove(m_path.c_str());
+
+    m_listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listener == INVALID_SOCKET_HANDLE ||
+        bind(m_listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(m_listener, 64) != 0)
+    {
+        if (m_listener != INVALID_SOCKET_HANDLE) CloseSocket(m_listener);
+        m_listener = INVALID_SOCKET_HANDLE;
+        throw std::runtime_error("Unable to listen on socket: " + m_path);
+    }
+
+    m_start = std::chrono::steady_clock::now();
+    m_last_arrival = m_start;
+    m_running = true;
+    m_acceptor = std::thread(&PricingServer::AcceptLoop, this);
+    m_batcher = std::thread(&PricingServer::BatchLoop, this);
+}
+
+// Function to stop serving
+void PricingServer::Stop()
+{
+    if (!m_running.exchange(false))
+    {
+        return;
+    }
+
+    // Wake the acceptor and the readers blocked on their sockets, then the batcher
+    ShutdownSocket(m_listener);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& reader : m_readers)
+        {
+            if (auto connection = reader.second.lock()) ShutdownSocket(connection->socket);
+        }
+    }
+    m_ready.notify_all();
+
+    m_acceptor.join();
+    m_batcher.join();
+    for (auto& reader : m_readers)
+    {
+        reader.first.join();
+    }
+
+    m_readers.clear();
+    m_queue.clear();
+    CloseSocket(m_listener);
+    m_listener = INVALID_SOCKET_HANDLE;
+    std::remove(m_path.c_str());
+}
+
+// Function to return the statistics of the requests served so far
+PricingServer::Statistics PricingServer::Stats() const
+{
+    std::lock_guard<std::mutex> lock(m_statistics_mutex);
+
+    return Statistics{ m_latency.Count(), m_batches, std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count(),
+        m_latency.Percentile(0.5), m_latency.Percentile(0.99) };
+}
+
+// Overloaded stream insertion operator
+std::ostream& operator<<(std::ostream& os, const PricingServer& server)
+{
+    PricingServer::Statistics stats = server.Stats();
+
+    os << "Pricing server: " << stats.requests << " requests in " << stats.batches << " batches";
+    if (stats.batches != 0)
+    {
+        os << " (" << static_cast<double>(stats.requests) / stats.batches << " per batch)";
+    }
+    os << ", p50: " << stats.p50 * 1e6 << " us, p99: " << stats.p99 * 1e6 << " us, "
+        << (stats.seconds > 0 ? stats.requests / stats.seconds : 0) << " requests/s";
+
+    return os;
+}
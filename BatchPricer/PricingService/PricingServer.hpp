@@ -0,0 +1,137 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// PricingServer.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the PricingServer class
+
+// If PRICINGSERVER_HPP is not defined
+#ifndef PRICINGSERVER_HPP
+// Define PRICINGSERVER_HPP
+#define PRICINGSERVER_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <cstddef>
+#include <utility>
+
+#include "PricingProtocol.hpp"
+#include "LatencyHistogram.hpp"
+
+// Class definition for PricingServer, a local pricing service on a Unix-domain socket. Each connection has a reader
+// thread that pushes the requests it receives onto one queue, and a single batcher thread drains the queue in
+// micro-batches, prices every request of a batch with the fused Measures() kernel of its model and writes all the
+// responses of a batch to each connection with one send. The batching window adapts to the load: the batcher keeps
+// collecting while the next request is expected (from the smoothed gap between arrivals) before the deadline of the
+// oldest queued request, the latency budget less the smoothed pricing time of the batch, and otherwise flushes at
+// once. It stops waiting altogether while the recent waits gained no requests, as with a single client that sends
+// one request at a time, so a lone client is answered without delay and many clients share batches within the budget.
+class PricingServer
+{
+public:
+
+    // Counters and latency percentiles of the requests served so far
+    struct Statistics
+    {
+        unsigned long long requests; // Number of requests answered
+        unsigned long long batches; // Number of batches priced
+        double seconds; // Time since the server started
+        double p50; // Median time from the arrival of a request to the send of its response, in seconds
+        double p99; // 99th percentile of the same time, in seconds
+    };
+
+private:
+
+    // Connection of a client, closed when the reader and every batch holding its requests are done with it
+    struct Connection
+    {
+        SocketHandle socket;
+        std::vector<char> output; // Responses of the current batch
+        bool failed; // Set when a send fails, later responses are dropped
+        std::atomic<bool> closed; // Set when the reader thread is done with the connection
+        Connection(const SocketHandle& handle) : socket(handle), failed(false), closed(false) {}
+        ~Connection() { CloseSocket(socket); }
+    };
+
+    // Request waiting in the queue
+    struct Pending
+    {
+        PricingRequest request;
+        std::shared_ptr<Connection> connection;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    std::string m_path; // Path of the socket
+    std::chrono::duration<double> m_budget; // Latency budget of a request
+    std::size_t m_max_batch; // Largest number of requests per batch
+    double m_h; // Shock size of the numeric sensitivities of the American model
+
+    SocketHandle m_listener; // Listening socket
+    std::atomic<bool> m_running; // Cleared to stop the threads
+    std::thread m_acceptor; // Thread accepting connections
+    std::thread m_batcher; // Thread pricing the batches
+    std::vector<std::pair<std::thread, std::weak_ptr<Connection>>> m_readers; // Reader thread of each open connection
+
+    std::mutex m_mutex; // Protects the queue, the readers and the arrival estimates
+    std::condition_variable m_ready; // Signalled when requests arrive or the server stops
+    std::deque<Pending> m_queue; // Requests waiting to be priced
+    std::chrono::steady_clock::time_point m_last_arrival; // Arrival of the latest request
+    double m_gap; // Smoothed gap between arrivals, in seconds
+    double m_cost; // Smoothed pricing and sending time per request, in seconds
+    double m_gain; // Smoothed number of requests gained by waiting for more
+    std::size_t m_probe; // Number of batches taken without waiting, to wait again now and then
+
+    mutable std::mutex m_statistics_mutex; // Protects the statistics
+    std::chrono::steady_clock::time_point m_start; // Start time of the server
+    LatencyHistogram m_latency; // Arrival-to-send times
+    unsigned long long m_batches; // Number of batches priced
+
+    // Function run by the acceptor thread
+    void AcceptLoop();
+
+    // Function run by the reader thread of a connection
+    void ReadLoop(std::shared_ptr<Connection> connection);
+
+    // Function run by the batcher thread
+    void BatchLoop();
+
+    // Function to wait for and take the next batch from the queue, returns false when the server stops
+    bool NextBatch(std::vector<Pending>& batch);
+
+    // Function to price one request into values, returns the status and sets count
+    PricingStatus PriceRequest(const PricingRequest& request, double* values, std::uint32_t& count) const;
+
+public:
+
+    // Constructor with the socket path, the latency budget in microseconds, the largest batch and the shock size
+    PricingServer(const std::string& socket_path, const double& budget_us = 500, const std::size_t& max_batch = 256,
+        const double& h = 1);
+
+    // The server owns threads and sockets, so it is not copyable
+    PricingServer(const PricingServer& source) = delete;
+    PricingServer& operator=(const PricingServer& source) = delete;
+
+    // Destructor, stops the server
+    ~PricingServer();
+
+    // Function to bind the socket and start serving in background threads
+    void Start();
+
+    // Function to stop serving, close every connection and remove the socket file
+    void Stop();
+
+    // Function to return the statistics of the requests served so far
+    Statistics Stats() const;
+
+    // Overloaded stream insertion operator
+    friend std::ostream& operator<<(std::ostream& os, const PricingServer& server);
+};
+
+// End of the conditional inclusion of the header file
+#endif
@@ -0,0 +1,303 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// ReorderPricer.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the templated ReorderPricer class
+
+// If REORDERPRICER_CPP is not defined
+#ifndef REORDERPRICER_CPP
+// Define REORDERPRICER_CPP
+#define REORDERPRICER_CPP
+
+#include <string>
+#include <iostream>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <queue>
+#include <tuple>
+#include <cstdio>
+#include <cstdint>
+#include <stdexcept>
+
+#include "ReorderPricer.hpp"
+
+// Function to compare two keys
+template <typename PricerType>
+bool ReorderPricer<PricerType>::Key::operator<(const Key& other) const
+{
+    return std::tie(call, T, r, b, S, row) < std::tie(other.call, other.T, other.r, other.b, other.S, other.row);
+}
+
+// Function to build the sort key of an input line
+template <typename PricerType>
+typename ReorderPricer<PricerType>::Key ReorderPricer<PricerType>::MakeKey(const std::string& line, const unsigned long long& row)
+{
+    Key key;
+
+    // Rows that fail validation sort after every valid row, in input order, and are rejected when they are priced
+    if (PricerType::ValidateRow(line) != nullptr)
+    {
+        key = { 2, 0, 0, 0, 0, row };
+        return key;
+    }
+
+    typename PricerType::OptionType option = PricerType::ParseRow(line);
+
+    key.call = option.type() == "Call" ? 1 : 0;
+    key.T = 0;
+    if constexpr (HasMaturity<typename PricerType::OptionType>::value)
+    {
+        key.T = option.T();
+    }
+    key.r = option.r();
+    key.b = option.b();
+    key.S = option.S();
+    key.row = row;
+
+    return key;
+}
+
+// Function to sort records and write them to a run file
+template <typename PricerType>
+void ReorderPricer<PricerType>::WriteRun(std::vector<Record>& records, const std::string& path)
+{
+    std::sort(records.begin(), records.end(), [](const Record& x, const Record& y) { return x.first < y.first; });
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Unable to open temporary file: " + path);
+    }
+
+    // Each record is its key followed by the length and the characters of its line
+    for (const auto& record : records)
+    {
+        std::uint32_t length = static_cast<std::uint32_t>(record.second.size());
+        file.write(reinterpret_cast<const char*>(&record.first), sizeof(Key));
+        file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        file.write(record.second.data(), length);
+    }
+
+    if (!file)
+    {
+        throw std::runtime_error("Unable to write temporary file: " + path);
+    }
+}
+
+// Function to read the next record of a run file
+template <typename PricerType>
+bool ReorderPricer<PricerType>::ReadRecord(std::ifstream& file, Record& record)
+{
+    std::uint32_t length = 0;
+    if (!file.read(reinterpret_cast<char*>(&record.first), sizeof(Key)) ||
+        !file.read(reinterpret_cast<char*>(&length), sizeof(length)))
+    {
+        return false;
+    }
+
+    record.second.resize(length);
+    return static_cast<bool>(file.read(&record.second[0], length));
+}
+
+// Function to merge run files in key order, calling emit on every record, and remove them
+template <typename PricerType>
+template <typename Function>
+void ReorderPricer<PricerType>::MergeRuns(const std::vector<std::string>& paths, Function emit)
+{
+    std::vector<std::ifstream> files(paths.size());
+    std::vector<Record> heads(paths.size());
+
+    // Min-heap of the runs on the key of their next record
+    auto greater = [&heads](const std::size_t& x, const std::size_t& y) { return heads[y].first < heads[x].first; };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(greater)> queue(greater);
+
+    for (std::size_t k = 0; k < paths.size(); ++k)
+    {
+        files[k].open(paths[k], std::ios::binary);
+        if (!files[k].is_open())
+        {
+            throw std::runtime_error("Unable to open temporary file: " + paths[k]);
+        }
+        if (ReadRecord(files[k], heads[k])) queue.push(k);
+    }
+
+    while (!queue.empty())
+    {
+        std::size_t k = queue.top();
+        queue.pop();
+
+        emit(heads[k]);
+        if (ReadRecord(files[k], heads[k])) queue.push(k);
+    }
+
+    for (std::size_t k = 0; k < paths.size(); ++k)
+    {
+        files[k].close();
+        std::remove(paths[k].c_str());
+    }
+}
+
+// Constructor with a configured pricer, execution settings and the number of rows sorted in memory per run
+template <typename PricerType>
+ReorderPricer<PricerType>::ReorderPricer(const PricerType& pricer, const int& threads, const std::size_t& chunk_size,
+    const char& delimiter, const std::size_t& run_rows) :
+    m_stream(pricer, threads, chunk_size, delimiter),
+    m_run_rows(run_rows)
+{
+    if (run_rows < 1)
+    {
+        throw std::invalid_argument("The number of rows per sorted run must be positive");
+    }
+}
+
+// Copy constructor
+template <typename PricerType>
+ReorderPricer<PricerType>::ReorderPricer(const ReorderPricer& source) :
+    m_stream(source.m_stream),
+    m_run_rows(source.m_run_rows),
+    m_temp_prefix(source.m_temp_prefix)
+{}
+
+// Assignment operator
+template <typename PricerType>
+ReorderPricer<PricerType>& ReorderPricer<PricerType>::operator=(const ReorderPricer& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_stream = source.m_stream;
+    m_run_rows = source.m_run_rows;
+    m_temp_prefix = source.m_temp_prefix;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to set the path prefix of the temporary files
+template <typename PricerType>
+ReorderPricer<PricerType>& ReorderPricer<PricerType>::TempPrefix(const std::string& prefix)
+{
+    m_temp_prefix = prefix;
+    return *this;
+}
+
+// Function to write the rows that fail validation to a reject file
+template <typename PricerType>
+ReorderPricer<PricerType>& ReorderPricer<PricerType>::Rejects(const std::string& reject_path)
+{
+    m_stream.Rejects(reject_path);
+    return *this;
+}
+
+// Function to price every option of the input file in sort order and write the results in input order
+template <typename PricerType>
+std::size_t ReorderPricer<PricerType>::Run(const std::string& input_path, const std::string& output_path) const
+{
+    std::ifstream input(input_path);
+    if (!input.is_open())
+    {
+        std::cerr << "Unable to open file: " << input_path << std::endl;
+        return 0;
+    }
+
+    const std::string prefix = m_temp_prefix.empty() ? output_path : m_temp_prefix;
+    const std::string sorted_path = prefix + ".sorted";
+    const std::string positions_path = prefix + ".positions";
+    const std::string priced_path = prefix + ".priced";
+
+    // Sorts the records of full runs into run files, then passes every record to emit in key order. An input that
+    // fits in a single run is sorted in memory and never spilled.
+    std::vector<Record> records;
+    std::vector<std::string> runs;
+    auto spill = [&](const std::string& name)
+    {
+        runs.push_back(prefix + name + std::to_string(runs.size()));
+        WriteRun(records, runs.back());
+        records.clear();
+    };
+    auto drain = [&](const std::string& name, auto emit)
+    {
+        if (runs.empty())
+        {
+            std::sort(records.begin(), records.end(), [](const Record& x, const Record& y) { return x.first < y.first; });
+            for (const auto& record : records) emit(record);
+            records.clear();
+            return;
+        }
+
+        if (!records.empty()) spill(name);
+        MergeRuns(runs, emit);
+        runs.clear();
+    };
+
+    // Sort the input rows by key in runs of m_run_rows rows, skipping the header and the empty lines
+    std::string header, line;
+    std::getline(input, header);
+    unsigned long long row = 0;
+
+    while (std::getline(input, line))
+    {
+        if (line.empty()) continue;
+
+        records.emplace_back(MakeKey(line, row++), std::move(line));
+        if (records.size() == m_run_rows) spill(".sort");
+    }
+    input.close();
+
+    // Write the rows in key order behind the header, and the input position of each of them
+    {
+        std::ofstream sorted(sorted_path, std::ios::binary);
+        std::ofstream positions(positions_path, std::ios::binary);
+        if (!sorted.is_open() || !positions.is_open())
+        {
+            std::cerr << "Unable to open file: " << sorted_path << std::endl;
+            return 0;
+        }
+
+        sorted << header << '\n';
+        drain(".sort", [&](const Record& record)
+        {
+            sorted << record.second << '\n';
+            positions.write(reinterpret_cast<const char*>(&record.first.row), sizeof(record.first.row));
+        });
+    }
+
+    // Price the sorted rows, the pipeline keeps their order
+    std::size_t rows = m_stream.Run(sorted_path, priced_path);
+    std::remove(sorted_path.c_str());
+
+    // Sort the priced rows back on their input positions, the other fields of the keys are left at zero. The rejected
+    // rows were sorted last and have no priced row, their positions are left over at the end of the file.
+    std::string output_header;
+    {
+        std::ifstream priced(priced_path);
+        std::ifstream positions(positions_path, std::ios::binary);
+        std::getline(priced, output_header);
+
+        Key key = { 0, 0, 0, 0, 0, 0 };
+        while (std::getline(priced, line) &&
+            positions.read(reinterpret_cast<char*>(&key.row), sizeof(key.row)))
+        {
+            records.emplace_back(key, std::move(line));
+            if (records.size() == m_run_rows) spill(".restore");
+        }
+    }
+    std::remove(priced_path.c_str());
+    std::remove(positions_path.c_str());
+
+    std::ofstream output(output_path);
+    if (!output.is_open())
+    {
+        std::cerr << "Unable to open file: " << output_path << std::endl;
+        return 0;
+    }
+
+    output << output_header << '\n';
+    drain(".restore", [&](const Record& record) { output << record.second << '\n'; });
+
+    return rows;
+}
+
+// End of the conditional inclusion of the header file
+#endif
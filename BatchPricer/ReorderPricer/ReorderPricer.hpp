@@ -0,0 +1,101 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// ReorderPricer.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the templated ReorderPricer class
+
+// If REORDERPRICER_HPP is not defined
+#ifndef REORDERPRICER_HPP
+// Define REORDERPRICER_HPP
+#define REORDERPRICER_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <fstream>
+
+#include "../StreamPricer/StreamPricer.hpp"
+
+// Define the ReorderPricer class, the out-of-core variant of pricing a file in (type, T, r, b, S) order. The rows of
+// the input are sorted by an external merge sort: runs of a bounded number of rows are sorted in memory and spilled
+// to temporary files, then merged into a sorted copy of the input and a file of the input position of every sorted
+// row. The sorted copy is priced by a StreamPricer, so the options of a type and the runs of equal T, r and b are
+// adjacent across the whole file and not only within a block, and the priced rows are put back in input order by a
+// second external sort on their positions. Memory use is bounded by the run size whatever the size of the input,
+// at the cost of writing the rows to disk three more times.
+template <typename PricerType>
+class ReorderPricer
+{
+private:
+    // Sort key of a row: option type, time to expiration, risk-free rate, cost of carry, spot and input position
+    struct Key
+    {
+        unsigned long long call; // 1 for a call, 0 for a put, 2 for a row that fails validation
+        double T; // Time to expiration, 0 for options without one
+        double r; // Risk-free interest rate
+        double b; // Cost of carry
+        double S; // Spot price
+        unsigned long long row; // Position of the row in the input
+
+        // Function to compare two keys, the position breaks the ties so that the order is total
+        bool operator<(const Key& other) const;
+    };
+
+    typedef std::pair<Key, std::string> Record;
+
+    // Detects whether an option type has a time to expiration that can be read
+    template <typename T, typename = void>
+    struct HasMaturity : std::false_type {};
+    template <typename T>
+    struct HasMaturity<T, std::void_t<decltype(std::declval<const T&>().T())>> : std::true_type {};
+
+    StreamPricer<PricerType> m_stream; // Pipeline pricing the sorted rows
+    std::size_t m_run_rows; // Number of rows sorted in memory per run
+    std::string m_temp_prefix; // Path prefix of the temporary files, empty to use the output path
+
+    // Function to build the sort key of an input line
+    static Key MakeKey(const std::string& line, const unsigned long long& row);
+
+    // Function to sort records and write them to a run file
+    static void WriteRun(std::vector<Record>& records, const std::string& path);
+
+    // Function to read the next record of a run file, returns false at its end
+    static bool ReadRecord(std::ifstream& file, Record& record);
+
+    // Function to merge run files in key order, calling emit on every record, and remove them
+    template <typename Function>
+    static void MergeRuns(const std::vector<std::string>& paths, Function emit);
+
+public:
+    // Constructor with a configured pricer, execution settings and the number of rows sorted in memory per run
+    ReorderPricer(const PricerType& pricer, const int& threads = 1, const std::size_t& chunk_size = 10000,
+        const char& delimiter = ',', const std::size_t& run_rows = 1000000);
+
+    // Copy constructor
+    ReorderPricer(const ReorderPricer& source);
+
+    // Assignment operator
+    ReorderPricer& operator=(const ReorderPricer& source);
+
+    // Function to set the path prefix of the temporary files, empty to place them next to the output
+    ReorderPricer& TempPrefix(const std::string& prefix);
+
+    // Function to write the rows that fail validation to a reject file, in input order, or only to count them
+    ReorderPricer& Rejects(const std::string& reject_path);
+
+    // Function to return the number of rows rejected by the last run
+    std::size_t Rejected() const { return m_stream.Rejected(); }
+
+    // Function to price every option of the input file in sort order and write the results in input order,
+    // returns the number of rows in the output
+    std::size_t Run(const std::string& input_path, const std::string& output_path) const;
+};
+
+// Must be the same name as in source file #define
+#ifndef REORDERPRICER_CPP
+#include "ReorderPricer.cpp"
+#endif
+// It includes the contents of ReorderPricer.cpp in the header file of REORDERPRICER_CPP is not already defined
+
+// End of the conditional inclusion of the header file
+#endif
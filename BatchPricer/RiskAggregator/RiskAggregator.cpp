@@ -0,0 +1,377 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// RiskAggregator.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the RiskAggregator class
+
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+#include "RiskAggregator.hpp"
+#include "../Functions/Functions.hpp"
+#include "../MatrixPricer/MatrixPricerEuropean.hpp"
+
+// Function to add a value to a compensated sum
+void RiskAggregator::CompensatedSum::Add(const double& x)
+{
+    double t = sum + x;
+
+    // Recover the low-order bits lost by the addition from the larger operand
+    if (std::abs(sum) >= std::abs(x))
+    {
+        compensation += (sum - t) + x;
+    }
+    else
+    {
+        compensation += (x - t) + sum;
+    }
+
+    sum = t;
+}
+
+// Function to add the exposure of a position
+void RiskAggregator::Exposure::Add(const double& quantity, const double* measures)
+{
+    ++positions;
+    value.Add(quantity * measures[0]);
+    delta.Add(quantity * measures[1]);
+    gamma.Add(quantity * measures[2]);
+    vega.Add(quantity * measures[3]);
+}
+
+// Function to merge another exposure
+void RiskAggregator::Exposure::Add(const Exposure& other)
+{
+    positions += other.positions;
+
+    for (auto [sum, part] : { std::make_pair(&value, &other.value), std::make_pair(&delta, &other.delta),
+        std::make_pair(&gamma, &other.gamma), std::make_pair(&vega, &other.vega) })
+    {
+        sum->Add(part->sum);
+        sum->Add(part->compensation);
+    }
+}
+
+// Function run by the reader thread: fills free blocks with input lines
+void RiskAggregator::ReadStage(std::ifstream& file, BlockQueue& free_blocks, BlockQueue& work) const
+{
+    std::size_t sequence = 0;
+    bool eof = false;
+
+    while (!eof)
+    {
+        Block* block = free_blocks.Pop();
+        block->size = 0;
+
+        if (block->lines.size() < m_chunk_size)
+        {
+            block->lines.resize(m_chunk_size);
+        }
+
+        while (block->size < m_chunk_size)
+        {
+            if (!std::getline(file, block->lines[block->size]))
+            {
+                eof = true;
+                break;
+            }
+            if (!block->lines[block->size].empty() && block->lines[block->size] != "\r") ++block->size;
+        }
+
+        if (block->size == 0)
+        {
+            free_blocks.Push(block);
+            break;
+        }
+
+        block->sequence = sequence++;
+        work.Push(block);
+    }
+
+    // One end marker per pricing thread
+    for (int t = 0; t < m_threads; ++t)
+    {
+        work.Push(nullptr);
+    }
+}
+
+// Function run by each pricing thread: prices the positions of each block into its partial sums
+void RiskAggregator::AggregateStage(BlockQueue& work, BlockQueue& done, std::exception_ptr& failure,
+    std::mutex& failure_mutex) const
+{
+    constexpr unsigned int mask = EuropeanOption::MEASURE_PRICE | EuropeanOption::MEASURE_DELTA |
+        EuropeanOption::MEASURE_GAMMA | EuropeanOption::MEASURE_VEGA;
+    double measures[EuropeanOption::MEASURE_COUNT];
+
+    // The group key is reused from row to row, so only new groups allocate
+    Group group;
+    double quantity = 0;
+
+    for (;;)
+    {
+        Block* block = work.Pop();
+
+        if (block == nullptr)
+        {
+            done.Push(nullptr);
+            return;
+        }
+
+        block->partial.clear();
+
+        // The first exception, such as a malformed row, is kept for Run to rethrow. The blocks still go through the
+        // reduction empty so that the reader and the reduction finish, and the remaining ones are not priced.
+        try
+        {
+            bool failed = false;
+            {
+                std::lock_guard<std::mutex> lock(failure_mutex);
+                failed = static_cast<bool>(failure);
+            }
+
+            for (std::size_t i = 0; i < block->size && !failed; ++i)
+            {
+                EuropeanOption option = ParsePosition(block->lines[i], quantity, group.first);
+                option.Measures<mask>(mask, measures);
+
+                group.second = Bucket(option.T());
+                block->partial[group].Add(quantity, measures);
+                group.second = -1;
+                block->partial[group].Add(quantity, measures);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(failure_mutex);
+            if (!failure) failure = std::current_exception();
+            block->partial.clear();
+        }
+
+        done.Push(block);
+    }
+}
+
+// Function run by the reduction thread: merges the partial sums in input order and recycles the blocks
+void RiskAggregator::ReduceStage(BlockQueue& done, BlockQueue& free_blocks, const std::size_t& blocks, std::size_t& total)
+{
+    // Blocks finished out of order wait here, merging in input order makes the sums independent of the threads
+    std::vector<Block*> pending(blocks, nullptr);
+    std::size_t next = 0;
+    int finished = 0;
+
+    while (finished < m_threads)
+    {
+        Block* block = done.Pop();
+
+        if (block == nullptr)
+        {
+            ++finished;
+            continue;
+        }
+
+        pending[block->sequence % blocks] = block;
+
+        while (pending[next % blocks] != nullptr && pending[next % blocks]->sequence == next)
+        {
+            Block* ready = pending[next % blocks];
+            pending[next % blocks] = nullptr;
+
+            for (const auto& [group, exposure] : ready->partial)
+            {
+                m_report[group].Add(exposure);
+            }
+
+            total += ready->size;
+            ++next;
+            free_blocks.Push(ready);
+        }
+    }
+}
+
+// Constructor with the upper edges of the expiry buckets and execution settings
+RiskAggregator::RiskAggregator(const std::vector<double>& buckets, const int& threads, const std::size_t& chunk_size) :
+    m_buckets(buckets),
+    m_threads(std::max(threads, 1)),
+    m_chunk_size(std::max<std::size_t>(chunk_size, 1))
+{
+    if (!std::is_sorted(m_buckets.begin(), m_buckets.end(), std::less_equal<double>()))
+    {
+        throw std::invalid_argument("Expiry bucket edges must be strictly increasing");
+    }
+}
+
+// Copy constructor
+RiskAggregator::RiskAggregator(const RiskAggregator& source) :
+    m_buckets(source.m_buckets),
+    m_threads(source.m_threads),
+    m_chunk_size(source.m_chunk_size),
+    m_report(source.m_report)
+{}
+
+// Assignment operator
+RiskAggregator& RiskAggregator::operator=(const RiskAggregator& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_buckets = source.m_buckets;
+    m_threads = source.m_threads;
+    m_chunk_size = source.m_chunk_size;
+    m_report = source.m_report;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to parse a line of the positions file into an option, its quantity and its underlying
+EuropeanOption RiskAggregator::ParsePosition(const std::string& line, double& quantity, std::string& underlying)
+{
+    // The first eight fields are an option row and pass the same checks as the rows of a batch file
+    EuropeanOption option("Call", 1, 1, 1, 0, 1);
+    const char* reason = MatrixPricerEuropean::ValidateRow(line, option);
+
+    std::string_view row[10];
+    if (reason == nullptr && splitFields(line, row, 10) < 10) reason = "Missing fields";
+    if (reason == nullptr && (!parseField(row[8], quantity) || !std::isfinite(quantity))) reason = "Malformed quantity";
+    if (reason != nullptr)
+    {
+        throw std::invalid_argument("Malformed position row (" + std::string(reason) + "): " + line);
+    }
+
+    // Drop the carriage return of files written on Windows
+    std::string_view name = row[9];
+    if (!name.empty() && name.back() == '\r') name.remove_suffix(1);
+    underlying.assign(name.data(), name.size());
+
+    return option;
+}
+
+// Function to return the expiry bucket of a time to expiration
+int RiskAggregator::Bucket(const double& T) const
+{
+    return static_cast<int>(std::lower_bound(m_buckets.begin(), m_buckets.end(), T) - m_buckets.begin());
+}
+
+// Function to return the label of an expiry bucket
+std::string RiskAggregator::BucketName(const int& bucket) const
+{
+    if (bucket < 0)
+    {
+        return "All";
+    }
+
+    std::ostringstream name;
+    name << (bucket == 0 ? 0 : m_buckets[bucket - 1]);
+    if (bucket < static_cast<int>(m_buckets.size()))
+    {
+        name << "-" << m_buckets[bucket];
+    }
+    else
+    {
+        name << "+";
+    }
+
+    return name.str();
+}
+
+// Function to aggregate every position of the input file
+std::size_t RiskAggregator::Run(const std::string& input_path)
+{
+    m_report.clear();
+
+    std::ifstream input(input_path);
+    if (!input.is_open())
+    {
+        std::cerr << "Unable to open file: " << input_path << std::endl;
+        return 0;
+    }
+
+    // Skip the input header
+    std::string line;
+    std::getline(input, line);
+
+    // Enough blocks for every pricing thread to hold one while the reader fills and the reduction drains others
+    const std::size_t blocks = 2 * static_cast<std::size_t>(m_threads) + 2;
+    std::vector<Block> storage(blocks);
+    BlockQueue free_blocks(blocks);
+    BlockQueue work(blocks + m_threads);
+    BlockQueue done(blocks + m_threads);
+
+    for (auto& block : storage)
+    {
+        free_blocks.Push(&block);
+    }
+
+    std::size_t total = 0;
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+
+    std::thread reader(&RiskAggregator::ReadStage, this, std::ref(input), std::ref(free_blocks), std::ref(work));
+    std::vector<std::thread> pricers;
+    for (int t = 0; t < m_threads; ++t)
+    {
+        pricers.emplace_back(&RiskAggregator::AggregateStage, this, std::ref(work), std::ref(done), std::ref(failure),
+            std::ref(failure_mutex));
+    }
+    std::thread reducer(&RiskAggregator::ReduceStage, this, std::ref(done), std::ref(free_blocks), std::cref(blocks),
+        std::ref(total));
+
+    reader.join();
+    for (auto& pricer : pricers)
+    {
+        pricer.join();
+    }
+    reducer.join();
+
+    if (failure)
+    {
+        m_report.clear();
+        std::rethrow_exception(failure);
+    }
+
+    return total;
+}
+
+// Function to write the net exposures of the last run to a CSV file
+void RiskAggregator::WriteCSV(const std::string& output_path) const
+{
+    std::ofstream file(output_path);
+    if (!file.is_open())
+    {
+        std::cerr << "Unable to open file: " << output_path << std::endl;
+        return;
+    }
+
+    file << "Underlying,Expiry Bucket,Positions,Value,Delta,Gamma,Vega\n";
+    for (const auto& [group, exposure] : m_report)
+    {
+        file << group.first << "," << BucketName(group.second) << "," << exposure.positions << ","
+            << std::to_string(exposure.value.Value()) << "," << std::to_string(exposure.delta.Value()) << ","
+            << std::to_string(exposure.gamma.Value()) << "," << std::to_string(exposure.vega.Value()) << "\n";
+    }
+
+    file.close();
+}
+
+// Overloaded stream insertion operator
+std::ostream& operator<<(std::ostream& os, const RiskAggregator& aggregator)
+{
+    for (const auto& [group, exposure] : aggregator.m_report)
+    {
+        os << group.first << ", " << aggregator.BucketName(group.second) << ": " << exposure.positions << " positions, Value: "
+            << exposure.value.Value() << ", Delta: " << exposure.delta.Value() << ", Gamma: " << exposure.gamma.Value()
+            << ", Vega: " << exposure.vega.Value() << std::endl;
+    }
+
+    return os;
+}
@@ -0,0 +1,126 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// RiskAggregator.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the RiskAggregator class
+
+// If RISKAGGREGATOR_HPP is not defined
+#ifndef RISKAGGREGATOR_HPP
+// Define RISKAGGREGATOR_HPP
+#define RISKAGGREGATOR_HPP
+
+#include <vector>
+#include <string>
+#include <map>
+#include <utility>
+#include <fstream>
+#include <ostream>
+#include <mutex>
+#include <exception>
+
+#include "../Options/EuropeanOption.hpp"
+#include "../StreamPricer/BoundedQueue.hpp"
+
+// Class definition for RiskAggregator, which nets the quantity-weighted value, Delta, Gamma and Vega of a file of
+// European option positions per underlying and per expiry bucket in a single pass, without writing the priced rows.
+// Positions use the European batch schema extended with two columns, "Quantity (q)" and "Underlying (u)". A reader
+// thread fills blocks of lines, a pool of threads prices each block into partial sums of its own, and a reduction
+// thread merges the partial sums block by block in input order with compensated (Neumaier) summation, so the report
+// is accurate and identical for any number of threads.
+class RiskAggregator
+{
+public:
+
+    // Running sum with Neumaier compensation of the rounding error
+    struct CompensatedSum
+    {
+        double sum = 0;
+        double compensation = 0;
+
+        // Function to add a value
+        void Add(const double& x);
+        // Function to return the compensated sum
+        double Value() const { return sum + compensation; }
+    };
+
+    // Net exposure of a group of positions
+    struct Exposure
+    {
+        std::size_t positions = 0;
+        CompensatedSum value; // Sum of quantity * price
+        CompensatedSum delta; // Sum of quantity * Delta
+        CompensatedSum gamma; // Sum of quantity * Gamma
+        CompensatedSum vega; // Sum of quantity * Vega
+
+        // Function to add the exposure of a position
+        void Add(const double& quantity, const double* measures);
+        // Function to merge another exposure
+        void Add(const Exposure& other);
+    };
+
+    // Group of positions: underlying and expiry bucket, bucket -1 being all expiries of the underlying
+    typedef std::pair<std::string, int> Group;
+    typedef std::map<Group, Exposure> Report;
+
+private:
+
+    // Chunk of input lines and the partial sums of their positions
+    struct Block
+    {
+        std::size_t sequence = 0;
+        std::size_t size = 0;
+        std::vector<std::string> lines;
+        Report partial;
+    };
+    typedef BoundedQueue<Block*> BlockQueue;
+
+    std::vector<double> m_buckets; // Upper edges of the expiry buckets, increasing
+    int m_threads; // Number of pricing threads
+    std::size_t m_chunk_size; // Number of positions per block
+    Report m_report; // Net exposures of the last run
+
+    // Function run by the reader thread: fills free blocks with input lines
+    void ReadStage(std::ifstream& file, BlockQueue& free_blocks, BlockQueue& work) const;
+    // Function run by each pricing thread: prices the positions of each block into its partial sums, keeping the first
+    // exception thrown in failure
+    void AggregateStage(BlockQueue& work, BlockQueue& done, std::exception_ptr& failure, std::mutex& failure_mutex) const;
+    // Function run by the reduction thread: merges the partial sums in input order and recycles the blocks
+    void ReduceStage(BlockQueue& done, BlockQueue& free_blocks, const std::size_t& blocks, std::size_t& total);
+
+public:
+
+    // Constructor with the upper edges of the expiry buckets and execution settings
+    RiskAggregator(const std::vector<double>& buckets = { 0.25, 0.5, 1, 2, 5 }, const int& threads = 1,
+        const std::size_t& chunk_size = 10000);
+
+    // Copy constructor
+    RiskAggregator(const RiskAggregator& source);
+
+    // Assignment operator
+    RiskAggregator& operator=(const RiskAggregator& source);
+
+    // Function to parse a line of the positions file into an option, its quantity and its underlying, throws
+    // std::invalid_argument with the reason of MatrixPricerEuropean::ValidateRow, or for a missing or malformed quantity
+    static EuropeanOption ParsePosition(const std::string& line, double& quantity, std::string& underlying);
+
+    // Function to return the expiry bucket of a time to expiration
+    int Bucket(const double& T) const;
+
+    // Function to return the label of an expiry bucket, "All" for bucket -1
+    std::string BucketName(const int& bucket) const;
+
+    // Function to aggregate every position of the input file, returns the number of positions. Throws the first error
+    // of the pricing threads, such as a malformed position row, once every thread has finished, and clears the report.
+    std::size_t Run(const std::string& input_path);
+
+    // Function to return the net exposures of the last run, the all-expiries group of each underlying first
+    const Report& Exposures() const { return m_report; }
+
+    // Function to write the net exposures of the last run to a CSV file
+    void WriteCSV(const std::string& output_path) const;
+
+    // Overloaded stream insertion operator
+    friend std::ostream& operator<<(std::ostream& os, const RiskAggregator& aggregator);
+};
+
+// End of the conditional inclusion of the header file
+#endif
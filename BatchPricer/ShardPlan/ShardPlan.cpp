@@ -0,0 +1,286 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// ShardPlan.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the ShardPlan class
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <spawn.h>
+#include <sys/wait.h>
+extern char** environ;
+#endif
+
+#include "ShardPlan.hpp"
+
+// Function to read the report of shard k
+bool ShardPlan::ReadReport(const std::size_t& k, Report& report) const
+{
+    std::ifstream file(ReportPath(k));
+    std::string line;
+    if (!std::getline(file, line))
+    {
+        return false;
+    }
+
+    char comma[4] = {};
+    std::istringstream fields(line);
+    return fields >> report.index >> comma[0] >> report.begin >> comma[1] >> report.end >> comma[2] >> report.rows >> comma[3] >>
+        report.seconds && std::count(comma, comma + 4, ',') == 4;
+}
+
+// Constructor with the input and output paths and the number of shards
+ShardPlan::ShardPlan(const std::string& input_path, const std::string& output_path, const std::size_t& count) :
+    m_input_path(input_path),
+    m_output_path(output_path)
+{
+    if (count < 1)
+    {
+        throw std::invalid_argument("The number of shards must be positive");
+    }
+
+    std::ifstream file(input_path, std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::invalid_argument("Unable to open input file: " + input_path);
+    }
+
+    file.seekg(0, std::ios::end);
+    const unsigned long long size = static_cast<unsigned long long>(file.tellg());
+    file.seekg(0, std::ios::beg);
+
+    // The rows start after the header
+    std::string line;
+    std::getline(file, line);
+    const unsigned long long first = file.eof() ? size : static_cast<unsigned long long>(file.tellg());
+
+    unsigned long long begin = first;
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        unsigned long long end = size;
+
+        if (k + 1 < count)
+        {
+            end = first + (size - first) * (k + 1) / count;
+
+            if (end <= begin)
+            {
+                // The previous boundary moved past this one over a long line, the shard is empty
+                end = begin;
+            }
+            else
+            {
+                // Move the boundary to the start of the next line, which is the boundary itself after a line end
+                file.clear();
+                file.seekg(end - 1);
+                std::getline(file, line);
+                end = file.eof() ? size : static_cast<unsigned long long>(file.tellg());
+            }
+        }
+
+        m_shards.push_back(Shard{ begin, end });
+        begin = end;
+    }
+}
+
+// Copy constructor
+ShardPlan::ShardPlan(const ShardPlan& source) :
+    m_input_path(source.m_input_path),
+    m_output_path(source.m_output_path),
+    m_shards(source.m_shards)
+{}
+
+// Assignment operator
+ShardPlan& ShardPlan::operator=(const ShardPlan& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_input_path = source.m_input_path;
+    m_output_path = source.m_output_path;
+    m_shards = source.m_shards;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to return the output path of shard k
+std::string ShardPlan::ShardPath(const std::size_t& k) const
+{
+    return m_output_path + ".shard" + std::to_string(k);
+}
+
+// Function to return the report path of shard k
+std::string ShardPlan::ReportPath(const std::size_t& k) const
+{
+    return ShardPath(k) + ".done";
+}
+
+// Function to write the report of shard k once its output is complete
+void ShardPlan::WriteReport(const std::size_t& k, const unsigned long long& rows, const double& seconds) const
+{
+    if (k >= m_shards.size())
+    {
+        throw std::invalid_argument("Shard index out of range: " + std::to_string(k));
+    }
+
+    // A report torn by a crash does not parse and the shard counts as not completed
+    std::ofstream file(ReportPath(k));
+    file << k << ',' << m_shards[k].begin << ',' << m_shards[k].end << ',' << rows << ',' << seconds << '\n';
+    if (!file)
+    {
+        throw std::runtime_error("Unable to write shard report: " + ReportPath(k));
+    }
+}
+
+// Function to run one local worker process per shard and wait for all of them
+std::size_t ShardPlan::RunLocal(const std::vector<std::string>& arguments) const
+{
+    if (arguments.empty())
+    {
+        throw std::invalid_argument("The worker command line needs at least the program");
+    }
+
+    std::size_t failures = 0;
+#ifdef _WIN32
+    std::vector<intptr_t> workers;
+#else
+    std::vector<pid_t> workers;
+#endif
+
+    for (std::size_t k = 0; k < m_shards.size(); ++k)
+    {
+        std::vector<std::string> worker_arguments(arguments);
+        worker_arguments.push_back("--shard");
+        worker_arguments.push_back(std::to_string(k));
+
+        std::vector<char*> argv;
+        for (auto& argument : worker_arguments) argv.push_back(&argument[0]);
+        argv.push_back(nullptr);
+
+#ifdef _WIN32
+        // The arguments are passed unquoted, paths with spaces are not supported
+        intptr_t worker = _spawnvp(_P_NOWAIT, argv[0], argv.data());
+        if (worker == -1)
+#else
+        pid_t worker = 0;
+        if (posix_spawnp(&worker, argv[0], nullptr, nullptr, argv.data(), environ) != 0)
+#endif
+        {
+            ++failures;
+            continue;
+        }
+        workers.push_back(worker);
+    }
+
+    for (const auto& worker : workers)
+    {
+        int status = 0;
+#ifdef _WIN32
+        if (_cwait(&status, worker, 0) == -1 || status != 0) ++failures;
+#else
+        if (waitpid(worker, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) ++failures;
+#endif
+    }
+
+    return failures;
+}
+
+// Function to concatenate the shard outputs into the output in shard order and remove the shard files
+std::vector<ShardPlan::Report> ShardPlan::Merge() const
+{
+    std::vector<Report> reports(m_shards.size());
+
+    for (std::size_t k = 0; k < m_shards.size(); ++k)
+    {
+        if (!ReadReport(k, reports[k]))
+        {
+            throw std::runtime_error("Shard " + std::to_string(k) + " has not completed: " + ShardPath(k));
+        }
+        if (reports[k].index != k || reports[k].begin != m_shards[k].begin || reports[k].end != m_shards[k].end)
+        {
+            throw std::runtime_error("Shard " + std::to_string(k) + " was planned on another input: " + ShardPath(k));
+        }
+    }
+
+    Concatenate(m_output_path);
+    for (std::size_t k = 0; k < m_shards.size(); ++k)
+    {
+        std::remove(ReportPath(k).c_str());
+    }
+
+    return reports;
+}
+
+// Function to concatenate the files "<path>.shard<k>" into path in shard order and remove them
+void ShardPlan::Concatenate(const std::string& path) const
+{
+    std::ofstream output(path, std::ios::binary);
+    if (!output.is_open())
+    {
+        throw std::runtime_error("Unable to open output file: " + path);
+    }
+
+    std::vector<char> buffer(1 << 20);
+    for (std::size_t k = 0; k < m_shards.size(); ++k)
+    {
+        const std::string shard_path = path + ".shard" + std::to_string(k);
+        std::ifstream shard(shard_path, std::ios::binary);
+        if (!shard.is_open())
+        {
+            throw std::runtime_error("Unable to open shard output: " + shard_path);
+        }
+
+        while (shard.read(buffer.data(), buffer.size()) || shard.gcount() > 0)
+        {
+            output.write(buffer.data(), shard.gcount());
+        }
+    }
+
+    output.close();
+    if (!output)
+    {
+        throw std::runtime_error("Unable to write output file: " + path);
+    }
+
+    // The shard files are only removed once the merged file is complete
+    for (std::size_t k = 0; k < m_shards.size(); ++k)
+    {
+        std::remove((path + ".shard" + std::to_string(k)).c_str());
+    }
+}
+
+// Function to print the timing of every shard and the balance between them
+void ShardPlan::PrintReports(std::ostream& os, const std::vector<Report>& reports)
+{
+    unsigned long long rows = 0;
+    double slowest = 0, total = 0;
+
+    for (const auto& report : reports)
+    {
+        os << "Shard " << report.index << ": " << report.rows << " options in " << report.seconds << " s ("
+            << (report.seconds > 0 ? report.rows / report.seconds : 0) << " options/s), bytes " << report.begin << "-"
+            << report.end << "\n";
+
+        rows += report.rows;
+        total += report.seconds;
+        slowest = std::max(slowest, report.seconds);
+    }
+
+    if (!reports.empty())
+    {
+        double mean = total / reports.size();
+        os << "Shards: " << reports.size() << ", " << rows << " options, slowest " << slowest << " s, mean " << mean
+            << " s, imbalance " << (mean > 0 ? slowest / mean : 1) << "\n";
+    }
+}
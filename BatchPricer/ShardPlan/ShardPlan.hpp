@@ -0,0 +1,91 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// ShardPlan.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the ShardPlan class
+
+// If SHARDPLAN_HPP is not defined
+#ifndef SHARDPLAN_HPP
+// Define SHARDPLAN_HPP
+#define SHARDPLAN_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+// Class definition for ShardPlan, the split of an input CSV file into byte-range shards priced by independent
+// processes. The rows after the header are cut into shards of about the same number of bytes, each boundary moved
+// forward to the start of the next line, so the plan only depends on the contents of the file: every worker computes
+// it again from the shared input and prices its own range, on this host or on another one that sees the same files.
+// Shard k is written to "<output>.shard<k>", the first one behind the output header, and a worker that finishes
+// writes a report "<output>.shard<k>.done" with its range, rows and seconds. The merge checks that every report is
+// there and matches the plan, then concatenates the shard outputs in shard order, so the output is the one a single
+// process writes whatever the order in which the workers finished.
+class ShardPlan
+{
+public:
+
+    // Byte range [begin, end) of the input priced by a shard
+    struct Shard
+    {
+        unsigned long long begin;
+        unsigned long long end;
+    };
+
+    // Report written by the worker of a shard once its output is complete
+    struct Report
+    {
+        std::size_t index; // Shard index
+        unsigned long long begin; // Byte range priced
+        unsigned long long end;
+        unsigned long long rows; // Rows written
+        double seconds; // Wall time of the worker
+    };
+
+private:
+
+    std::string m_input_path; // Input CSV file
+    std::string m_output_path; // Merged output file, the shard files are named after it
+    std::vector<Shard> m_shards; // Byte ranges, in input order
+
+    // Function to read the report of shard k, returns false when there is none
+    bool ReadReport(const std::size_t& k, Report& report) const;
+
+public:
+
+    // Constructor with the input and output paths and the number of shards
+    ShardPlan(const std::string& input_path, const std::string& output_path, const std::size_t& count);
+
+    // Copy constructor
+    ShardPlan(const ShardPlan& source);
+
+    // Assignment operator
+    ShardPlan& operator=(const ShardPlan& source);
+
+    // Function to return the byte ranges of the shards
+    const std::vector<Shard>& Shards() const { return m_shards; }
+
+    // Functions to return the output and report paths of shard k
+    std::string ShardPath(const std::size_t& k) const;
+    std::string ReportPath(const std::size_t& k) const;
+
+    // Function to write the report of shard k once its output is complete
+    void WriteReport(const std::size_t& k, const unsigned long long& rows, const double& seconds) const;
+
+    // Function to run one local worker process per shard, each with the given arguments followed by "--shard k",
+    // and wait for all of them, returns the number of workers that failed
+    std::size_t RunLocal(const std::vector<std::string>& arguments) const;
+
+    // Function to concatenate the shard outputs into the output in shard order and remove the shard files, returns
+    // the reports of the shards. Throws when a shard has not completed or was planned on another input.
+    std::vector<Report> Merge() const;
+
+    // Function to concatenate the files "<path>.shard<k>" written by the shards into path in shard order and remove
+    // them, for the other files of a run such as its rejected rows. Throws when the file of a shard is missing.
+    void Concatenate(const std::string& path) const;
+
+    // Function to print the timing of every shard and the balance between them
+    static void PrintReports(std::ostream& os, const std::vector<Report>& reports);
+};
+
+// End of the conditional inclusion of the header file
+#endif
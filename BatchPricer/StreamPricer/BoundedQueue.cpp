@@ -0,0 +1,137 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// BoundedQueue.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the templated BoundedQueue class
+
+// If BOUNDEDQUEUE_CPP is not defined
+#ifndef BOUNDEDQUEUE_CPP
+// Define BOUNDEDQUEUE_CPP
+#define BOUNDEDQUEUE_CPP
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include "BoundedQueue.hpp"
+
+// Function to back off while the queue is full or empty
+template <typename T>
+void BoundedQueue<T>::Wait(std::size_t& attempts)
+{
+    // Spin briefly, then give the core away so a stalled stage does not starve the others
+    if (++attempts < 64)
+    {
+        std::this_thread::yield();
+    }
+    else
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+// Constructor with the minimum capacity, rounded up to a power of two
+template <typename T>
+BoundedQueue<T>::BoundedQueue(const std::size_t& capacity) :
+    m_enqueue_pos(0),
+    m_dequeue_pos(0)
+{
+    std::size_t size = 2;
+    while (size < capacity) size <<= 1;
+
+    m_buffer.reset(new Cell[size]);
+    m_mask = size - 1;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        m_buffer[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+// Function to push a value, returns false if the queue is full
+template <typename T>
+bool BoundedQueue<T>::TryPush(const T& value)
+{
+    std::size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        Cell& cell = m_buffer[pos & m_mask];
+        std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+        if (diff == 0)
+        {
+            // The slot is free for this position, claim it
+            if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell.data = value;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The slot still holds a value from the previous lap
+            return false;
+        }
+        else
+        {
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// Function to pop a value, returns false if the queue is empty
+template <typename T>
+bool BoundedQueue<T>::TryPop(T& value)
+{
+    std::size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        Cell& cell = m_buffer[pos & m_mask];
+        std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+
+        if (diff == 0)
+        {
+            // The slot holds a value for this position, claim it
+            if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                value = cell.data;
+                cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // No value has been published in this slot yet
+            return false;
+        }
+        else
+        {
+            pos = m_dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// Function to push a value, waiting while the queue is full
+template <typename T>
+void BoundedQueue<T>::Push(const T& value)
+{
+    std::size_t attempts = 0;
+    while (!TryPush(value)) Wait(attempts);
+}
+
+// Function to pop a value, waiting while the queue is empty
+template <typename T>
+T BoundedQueue<T>::Pop()
+{
+    T value;
+    std::size_t attempts = 0;
+    while (!TryPop(value)) Wait(attempts);
+    return value;
+}
+
+// End of the conditional inclusion of the header file
+#endif
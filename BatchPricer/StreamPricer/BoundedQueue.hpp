@@ -0,0 +1,63 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// BoundedQueue.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the templated BoundedQueue class
+
+// If BOUNDEDQUEUE_HPP is not defined
+#ifndef BOUNDEDQUEUE_HPP
+// Define BOUNDEDQUEUE_HPP
+#define BOUNDEDQUEUE_HPP
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+// Define the BoundedQueue class, a fixed-capacity lock-free queue that can be shared by
+// several producer and consumer threads (each slot carries a sequence number that tells
+// producers and consumers whose turn it is, so no mutex is ever taken)
+template <typename T>
+class BoundedQueue
+{
+private:
+    // Slot of the ring buffer
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> m_buffer; // Ring buffer of slots
+    std::size_t m_mask; // Capacity minus one, capacity is a power of two
+    alignas(64) std::atomic<std::size_t> m_enqueue_pos; // Next slot to write
+    alignas(64) std::atomic<std::size_t> m_dequeue_pos; // Next slot to read
+
+    // Function to back off while the queue is full or empty
+    static void Wait(std::size_t& attempts);
+
+public:
+    // Constructor with the minimum capacity, rounded up to a power of two
+    explicit BoundedQueue(const std::size_t& capacity);
+
+    // Queues are shared between threads by reference and cannot be copied
+    BoundedQueue(const BoundedQueue& source) = delete;
+    BoundedQueue& operator=(const BoundedQueue& source) = delete;
+
+    // Function to push a value, returns false if the queue is full
+    bool TryPush(const T& value);
+    // Function to pop a value, returns false if the queue is empty
+    bool TryPop(T& value);
+
+    // Function to push a value, waiting while the queue is full
+    void Push(const T& value);
+    // Function to pop a value, waiting while the queue is empty
+    T Pop();
+};
+
+// Must be the same name as in source file #define
+#ifndef BOUNDEDQUEUE_CPP
+#include "BoundedQueue.cpp"
+#endif
+// It includes the contents of BoundedQueue.cpp in the header file of BOUNDEDQUEUE_CPP is not already defined
+
+// End of the conditional inclusion of the header file
+#endif
@@ -0,0 +1,39 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// RowBlock.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the RowBlock structure
+
+// If ROWBLOCK_HPP is not defined
+#ifndef ROWBLOCK_HPP
+// Define ROWBLOCK_HPP
+#define ROWBLOCK_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "../Arena/Arena.hpp"
+
+// Define the RowBlock structure, a chunk of input lines and their priced output rows that
+// travels reader -> pricer -> writer and is then handed back to the reader for reuse.
+// The line strings and the output arena are never shrunk, so once every block has
+// warmed up to the chunk size, steady-state processing performs no memory allocation.
+struct RowBlock
+{
+    // Position of the block in the input file, used by the writer to restore the order
+    std::size_t sequence = 0;
+    // Byte offset in the input file just past the last line of the block
+    unsigned long long input_offset = 0;
+    // Number of valid rows in the block
+    std::size_t size = 0;
+    // Raw input lines
+    std::vector<std::string> lines;
+    // Formatted output rows, rewound when the block is recycled
+    Arena output;
+    // Number of lines that failed validation, and their reject records when a reject file is written
+    std::size_t rejected = 0;
+    Arena rejects;
+};
+
+// End of the conditional inclusion of the header file
+#endif
@@ -0,0 +1,480 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// StreamPricer.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the templated StreamPricer class
+
+// If STREAMPRICER_CPP is not defined
+#ifndef STREAMPRICER_CPP
+// Define STREAMPRICER_CPP
+#define STREAMPRICER_CPP
+
+#include <string>
+#include <iostream>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <stdexcept>
+
+#include "StreamPricer.hpp"
+
+// Function run by the reader thread: fills free blocks with input lines
+template <typename PricerType>
+void StreamPricer<PricerType>::ReadStage(std::ifstream& file, const unsigned long long& end, BlockQueue& free_blocks,
+    BlockQueue& work) const
+{
+    std::size_t sequence = 0;
+    bool eof = false;
+
+    // Bytes read so far, counted line by line to stop at the end of a byte range. Only exact in binary mode, which
+    // is how ranges are read; in text mode the end of the file comes first.
+    unsigned long long position = static_cast<unsigned long long>(file.tellg());
+
+    while (!eof)
+    {
+        RowBlock* block = free_blocks.Pop();
+        block->size = 0;
+
+        // Size a new block once, with room for typical line lengths
+        if (block->lines.size() < m_chunk_size)
+        {
+            block->lines.resize(m_chunk_size);
+            for (auto& line : block->lines) line.reserve(128);
+        }
+
+        // Reading into the recycled strings reuses their capacity
+        while (block->size < m_chunk_size)
+        {
+            if (position >= end || !std::getline(file, block->lines[block->size]))
+            {
+                eof = true;
+                break;
+            }
+            position += block->lines[block->size].size() + 1;
+            if (!block->lines[block->size].empty()) ++block->size;
+        }
+
+        if (block->size == 0)
+        {
+            free_blocks.Push(block);
+            break;
+        }
+
+        // The input position is only taken once per block, at the end of the file it is the file size
+        block->input_offset = file.eof() || position >= end ? end : static_cast<unsigned long long>(file.tellg());
+        block->sequence = sequence++;
+        work.Push(block);
+    }
+
+    // One end marker per pricer thread
+    for (int t = 0; t < m_threads; ++t)
+    {
+        work.Push(nullptr);
+    }
+}
+
+// Function run by each pricer thread: parses and prices the lines of each block
+template <typename PricerType>
+void StreamPricer<PricerType>::PriceStage(BlockQueue& work, BlockQueue& done) const
+{
+    for (;;)
+    {
+        RowBlock* block = work.Pop();
+
+        if (block == nullptr)
+        {
+            done.Push(nullptr);
+            return;
+        }
+
+        block->output.Reset();
+        block->rejects.Reset();
+        block->rejected = m_pricer.PriceLines(block->lines, block->size, block->output, m_delimiter,
+            m_reject_path.empty() ? nullptr : &block->rejects);
+
+        done.Push(block);
+    }
+}
+
+// Function run by the writer thread: writes priced blocks in input order, checkpoints and recycles them
+template <typename PricerType>
+void StreamPricer<PricerType>::WriteStage(std::ofstream& file, std::ofstream& rejects, std::ofstream& checkpoint,
+    BlockQueue& done, BlockQueue& free_blocks, const std::size_t& blocks, std::size_t& total) const
+{
+    // Blocks finished out of order wait here; at most 'blocks' are in flight so slots never collide
+    std::vector<RowBlock*> pending(blocks, nullptr);
+    std::size_t next = 0;
+    unsigned long long last_offset = 0;
+    int finished = 0;
+
+    // Appends a record for the rows written up to an input offset, the reject offset only with a reject file
+    auto write_checkpoint = [&](const unsigned long long& input_offset)
+    {
+        file.flush();
+        checkpoint << input_offset << ',' << total << ',' << static_cast<unsigned long long>(file.tellp());
+        if (rejects.is_open())
+        {
+            rejects.flush();
+            checkpoint << ',' << static_cast<unsigned long long>(rejects.tellp());
+        }
+        checkpoint << '\n';
+        checkpoint.flush();
+    };
+
+    while (finished < m_threads)
+    {
+        RowBlock* block = done.Pop();
+
+        if (block == nullptr)
+        {
+            ++finished;
+            continue;
+        }
+
+        pending[block->sequence % blocks] = block;
+
+        while (pending[next % blocks] != nullptr && pending[next % blocks]->sequence == next)
+        {
+            RowBlock* ready = pending[next % blocks];
+            pending[next % blocks] = nullptr;
+
+            file.write(ready->output.Data(), ready->output.Size());
+            if (rejects.is_open()) rejects.write(ready->rejects.Data(), ready->rejects.Size());
+
+            total += ready->size - ready->rejected;
+            m_rejected += ready->rejected;
+            ++next;
+
+            // The record is written only once the rows it counts are flushed, so it never runs ahead of the output
+            if (checkpoint.is_open() && next % m_checkpoint_interval == 0)
+            {
+                write_checkpoint(ready->input_offset);
+            }
+
+            last_offset = ready->input_offset;
+            free_blocks.Push(ready);
+        }
+    }
+
+    // Final record of a completed run
+    if (checkpoint.is_open() && next % m_checkpoint_interval != 0)
+    {
+        write_checkpoint(last_offset);
+    }
+}
+
+// Constructor with a configured pricer and execution settings
+template <typename PricerType>
+StreamPricer<PricerType>::StreamPricer(const PricerType& pricer, const int& threads, const std::size_t& chunk_size,
+    const char& delimiter) :
+    m_pricer(pricer),
+    m_threads(std::max(threads, 1)),
+    m_chunk_size(std::max<std::size_t>(chunk_size, 1)),
+    m_delimiter(delimiter),
+    m_checkpoint_interval(10),
+    m_rejected(0)
+{}
+
+// Copy constructor
+template <typename PricerType>
+StreamPricer<PricerType>::StreamPricer(const StreamPricer& source) :
+    m_pricer(source.m_pricer),
+    m_threads(source.m_threads),
+    m_chunk_size(source.m_chunk_size),
+    m_delimiter(source.m_delimiter),
+    m_checkpoint_path(source.m_checkpoint_path),
+    m_checkpoint_interval(source.m_checkpoint_interval),
+    m_reject_path(source.m_reject_path),
+    m_rejected(source.m_rejected)
+{}
+
+// Assignment operator
+template <typename PricerType>
+StreamPricer<PricerType>& StreamPricer<PricerType>::operator=(const StreamPricer& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_pricer = source.m_pricer;
+    m_threads = source.m_threads;
+    m_chunk_size = source.m_chunk_size;
+    m_delimiter = source.m_delimiter;
+    m_checkpoint_path = source.m_checkpoint_path;
+    m_checkpoint_interval = source.m_checkpoint_interval;
+    m_reject_path = source.m_reject_path;
+    m_rejected = source.m_rejected;
+
+    return *this;
+}
+
+// Function to write checkpoint records to a file every interval blocks
+template <typename PricerType>
+StreamPricer<PricerType>& StreamPricer<PricerType>::Checkpoints(const std::string& checkpoint_path, const std::size_t& interval)
+{
+    if (interval == 0)
+    {
+        throw std::invalid_argument("The checkpoint interval must be positive");
+    }
+
+    m_checkpoint_path = checkpoint_path;
+    m_checkpoint_interval = interval;
+    return *this;
+}
+
+// Function to write the rows that fail validation to a reject file
+template <typename PricerType>
+StreamPricer<PricerType>& StreamPricer<PricerType>::Rejects(const std::string& reject_path)
+{
+    m_reject_path = reject_path;
+    return *this;
+}
+
+// Function to write the header of the reject file
+template <typename PricerType>
+void StreamPricer<PricerType>::WriteRejectHeader(std::ofstream& rejects, const std::string& input_header) const
+{
+    std::string header = input_header;
+    if (!header.empty() && header.back() == '\r') header.pop_back();
+
+    rejects << "Reason" << m_delimiter << header << "\n";
+}
+
+// Function to read the last complete record of a checkpoint file
+template <typename PricerType>
+bool StreamPricer<PricerType>::ReadCheckpoint(const std::string& checkpoint_path, Checkpoint& record)
+{
+    std::ifstream file(checkpoint_path, std::ios::binary);
+    std::string line;
+    bool found = false;
+
+    // A record torn by a crash has no line end and is ignored
+    while (std::getline(file, line))
+    {
+        if (file.eof())
+        {
+            break;
+        }
+
+        Checkpoint candidate = { 0, 0, 0, 0 };
+        char comma1 = 0, comma2 = 0, comma3 = 0;
+        std::istringstream fields(line);
+        if (fields >> candidate.input_offset >> comma1 >> candidate.rows >> comma2 >> candidate.output_offset &&
+            comma1 == ',' && comma2 == ',')
+        {
+            // The reject offset is only there for runs with a reject file
+            if (fields >> comma3 && (comma3 != ',' || !(fields >> candidate.reject_offset)))
+            {
+                continue;
+            }
+
+            record = candidate;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+// Function to price every option of the input file and write the results
+template <typename PricerType>
+std::size_t StreamPricer<PricerType>::Run(const std::string& input_path, const std::string& output_path, const bool& resume) const
+{
+    std::ifstream input(input_path);
+    if (!input.is_open())
+    {
+        std::cerr << "Unable to open file: " << input_path << std::endl;
+        return 0;
+    }
+
+    // Size of the input, the offset of the end of the last block
+    input.seekg(0, std::ios::end);
+    const unsigned long long end = static_cast<unsigned long long>(input.tellg());
+    input.seekg(0, std::ios::beg);
+
+    const std::string header = m_pricer.Header(m_delimiter);
+    Checkpoint record = { 0, 0, 0, 0 };
+    bool resuming = resume && !m_checkpoint_path.empty() && ReadCheckpoint(m_checkpoint_path, record);
+
+    if (resuming)
+    {
+        // The output must have been written by the same configuration and hold every byte the record counts
+        std::ifstream previous(output_path);
+        std::string previous_header;
+        std::getline(previous, previous_header);
+        previous.close();
+
+        std::error_code error;
+        unsigned long long size = std::filesystem::file_size(output_path, error);
+        if (error || previous_header != header || size < record.output_offset)
+        {
+            throw std::invalid_argument("The output file does not match the checkpoint file: " + output_path);
+        }
+
+        // Drop the rows written after the last record, they are priced again
+        std::filesystem::resize_file(output_path, record.output_offset);
+
+        // Same for the rejects, a run that wrote none starts its reject file again
+        if (!m_reject_path.empty() && record.reject_offset > 0)
+        {
+            size = std::filesystem::file_size(m_reject_path, error);
+            if (error || size < record.reject_offset)
+            {
+                throw std::invalid_argument("The reject file does not match the checkpoint file: " + m_reject_path);
+            }
+            std::filesystem::resize_file(m_reject_path, record.reject_offset);
+        }
+    }
+
+    std::ofstream output(output_path, resuming ? std::ios::app : std::ios::out);
+    if (!output.is_open())
+    {
+        std::cerr << "Unable to open file: " << output_path << std::endl;
+        return 0;
+    }
+
+    std::ofstream checkpoint;
+    if (!m_checkpoint_path.empty())
+    {
+        checkpoint.open(m_checkpoint_path, resuming ? std::ios::app | std::ios::binary : std::ios::out | std::ios::binary);
+        if (!checkpoint.is_open())
+        {
+            std::cerr << "Unable to open file: " << m_checkpoint_path << std::endl;
+            return 0;
+        }
+    }
+
+    std::ofstream rejects;
+    const bool append_rejects = resuming && record.reject_offset > 0;
+    if (!m_reject_path.empty())
+    {
+        rejects.open(m_reject_path, append_rejects ? std::ios::app : std::ios::out);
+        if (!rejects.is_open())
+        {
+            std::cerr << "Unable to open file: " << m_reject_path << std::endl;
+            return 0;
+        }
+    }
+
+    // The reject file repeats the input header behind the reason column
+    std::string line;
+    std::getline(input, line);
+    if (rejects.is_open() && !append_rejects)
+    {
+        WriteRejectHeader(rejects, line);
+    }
+
+    if (resuming)
+    {
+        // Skip every block already written
+        input.seekg(record.input_offset);
+    }
+    else
+    {
+        // The input header is skipped, write the output header
+        output << header << "\n";
+    }
+
+    std::size_t total = Pipeline(input, end, output, rejects, checkpoint, static_cast<std::size_t>(record.rows));
+    output.close();
+
+    return total;
+}
+
+// Function to price the rows in a byte range of the input file
+template <typename PricerType>
+std::size_t StreamPricer<PricerType>::Run(const std::string& input_path, const std::string& output_path,
+    const unsigned long long& begin, const unsigned long long& end, const bool& header) const
+{
+    // Binary mode, so that the bytes counted by the reader are the bytes of the file
+    std::ifstream input(input_path, std::ios::binary);
+    if (!input.is_open())
+    {
+        std::cerr << "Unable to open file: " << input_path << std::endl;
+        return 0;
+    }
+
+    // Text mode like a whole run, so that the shard outputs concatenate into the same bytes
+    std::ofstream output(output_path);
+    if (!output.is_open())
+    {
+        std::cerr << "Unable to open file: " << output_path << std::endl;
+        return 0;
+    }
+
+    std::ofstream rejects;
+    if (!m_reject_path.empty())
+    {
+        rejects.open(m_reject_path);
+        if (!rejects.is_open())
+        {
+            std::cerr << "Unable to open file: " << m_reject_path << std::endl;
+            return 0;
+        }
+    }
+
+    if (header)
+    {
+        output << m_pricer.Header(m_delimiter) << "\n";
+
+        if (rejects.is_open())
+        {
+            std::string input_header;
+            std::getline(input, input_header);
+            WriteRejectHeader(rejects, input_header);
+            input.clear();
+        }
+    }
+
+    input.seekg(begin);
+    std::ofstream checkpoint;
+    std::size_t total = Pipeline(input, end, output, rejects, checkpoint, 0);
+    output.close();
+
+    return total;
+}
+
+// Function to run the reader, pricer and writer threads over an opened input and output
+template <typename PricerType>
+std::size_t StreamPricer<PricerType>::Pipeline(std::ifstream& input, const unsigned long long& end, std::ofstream& output,
+    std::ofstream& rejects, std::ofstream& checkpoint, const std::size_t& rows) const
+{
+    // Enough blocks for every pricer to hold one while the reader fills and the writer drains others
+    const std::size_t blocks = 2 * static_cast<std::size_t>(m_threads) + 2;
+    std::vector<RowBlock> storage(blocks);
+    BlockQueue free_blocks(blocks);
+    BlockQueue work(blocks + m_threads);
+    BlockQueue done(blocks + m_threads);
+
+    for (auto& block : storage)
+    {
+        free_blocks.Push(&block);
+    }
+
+    std::size_t total = rows;
+    m_rejected = 0;
+
+    std::thread reader(&StreamPricer::ReadStage, this, std::ref(input), std::cref(end), std::ref(free_blocks), std::ref(work));
+    std::vector<std::thread> pricers;
+    for (int t = 0; t < m_threads; ++t)
+    {
+        pricers.emplace_back(&StreamPricer::PriceStage, this, std::ref(work), std::ref(done));
+    }
+    std::thread writer(&StreamPricer::WriteStage, this, std::ref(output), std::ref(rejects), std::ref(checkpoint),
+        std::ref(done), std::ref(free_blocks), std::cref(blocks), std::ref(total));
+
+    reader.join();
+    for (auto& pricer : pricers)
+    {
+        pricer.join();
+    }
+    writer.join();
+
+    return total;
+}
+
+// End of the conditional inclusion of the header file
+#endif
@@ -0,0 +1,111 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// StreamPricer.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the templated StreamPricer class
+
+// If STREAMPRICER_HPP is not defined
+#ifndef STREAMPRICER_HPP
+// Define STREAMPRICER_HPP
+#define STREAMPRICER_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "../MatrixPricer/MatrixPricerEuropean.hpp"
+#include "../MatrixPricer/MatrixPricerAmerican.hpp"
+#include "BoundedQueue.hpp"
+#include "RowBlock.hpp"
+
+// Define the StreamPricer class, which prices an input CSV file with a configured MatrixPricerEuropean
+// or MatrixPricerAmerican through a three-stage pipeline: a reader thread fills blocks of raw lines,
+// a pool of pricer threads parses and prices them, and a writer thread writes them back in input order.
+// The stages exchange a fixed set of reusable blocks through bounded lock-free queues, so disk I/O
+// overlaps with pricing and memory use does not depend on the size of the input file.
+// The output is only ever appended to, block by block. With a checkpoint file, the writer flushes the output every
+// few blocks and then appends a checkpoint record (input byte offset, rows done, output byte offset), so a run that
+// dies can be resumed: the output is cut back to the last record and the input is read from its offset, skipping
+// every block already written. A byte range of the input can also be priced on its own, which is how the shards of a
+// multi-process run are priced.
+// Rows that fail validation never stop the run: the pricer sets them aside and, with a reject file, the writer
+// appends them there with the reason they were rejected, in input order, as it writes the priced rows.
+template <typename PricerType>
+class StreamPricer
+{
+public:
+    // Checkpoint record, written as one line "input offset,rows,output offset" of the checkpoint file, followed by
+    // ",reject offset" when the run writes a reject file
+    struct Checkpoint
+    {
+        unsigned long long input_offset; // Input bytes consumed, header included
+        unsigned long long rows; // Rows written
+        unsigned long long output_offset; // Output bytes written, header included
+        unsigned long long reject_offset; // Reject file bytes written, header included, 0 without a reject file
+    };
+
+private:
+    typedef BoundedQueue<RowBlock*> BlockQueue;
+
+    PricerType m_pricer; // Matrix pricer holding the configuration
+    int m_threads; // Number of pricing threads
+    std::size_t m_chunk_size; // Number of rows per block
+    char m_delimiter; // Output field delimiter
+    std::string m_checkpoint_path; // Checkpoint file, empty to run without checkpoints
+    std::size_t m_checkpoint_interval; // Number of blocks between checkpoints
+    std::string m_reject_path; // Reject file, empty to only count the rejected rows
+    mutable std::size_t m_rejected; // Number of rows rejected by the last run
+
+    // Function run by the reader thread: fills free blocks with input lines, end is the size of the input file
+    void ReadStage(std::ifstream& file, const unsigned long long& end, BlockQueue& free_blocks, BlockQueue& work) const;
+    // Function run by each pricer thread: parses and prices the lines of each block
+    void PriceStage(BlockQueue& work, BlockQueue& done) const;
+    // Function run by the writer thread: writes priced blocks in input order, checkpoints and recycles them
+    void WriteStage(std::ofstream& file, std::ofstream& rejects, std::ofstream& checkpoint, BlockQueue& done,
+        BlockQueue& free_blocks, const std::size_t& blocks, std::size_t& total) const;
+    // Function to run the three stages over the input up to byte end, rows already written before, returns the rows written
+    std::size_t Pipeline(std::ifstream& input, const unsigned long long& end, std::ofstream& output, std::ofstream& rejects,
+        std::ofstream& checkpoint, const std::size_t& rows) const;
+    // Function to write the header of the reject file, the reason column followed by the input header
+    void WriteRejectHeader(std::ofstream& rejects, const std::string& input_header) const;
+
+public:
+    // Constructor with a configured pricer and execution settings
+    StreamPricer(const PricerType& pricer, const int& threads = 1, const std::size_t& chunk_size = 10000,
+        const char& delimiter = ',');
+
+    // Copy constructor
+    StreamPricer(const StreamPricer& source);
+
+    // Assignment operator
+    StreamPricer& operator=(const StreamPricer& source);
+
+    // Function to write checkpoint records to a file every interval blocks, or to stop checkpointing with an empty path
+    StreamPricer& Checkpoints(const std::string& checkpoint_path, const std::size_t& interval = 10);
+
+    // Function to write the rows that fail validation to a reject file, or only to count them with an empty path
+    StreamPricer& Rejects(const std::string& reject_path);
+
+    // Function to return the number of rows rejected by the last run, since its checkpoint when it was resumed
+    std::size_t Rejected() const { return m_rejected; }
+
+    // Function to read the last complete record of a checkpoint file, returns false when there is none
+    static bool ReadCheckpoint(const std::string& checkpoint_path, Checkpoint& record);
+
+    // Function to price every option of the input file and write the results, returns the number of rows in the output.
+    // With resume, a run with the same checkpoint file is continued from its last record.
+    std::size_t Run(const std::string& input_path, const std::string& output_path, const bool& resume = false) const;
+
+    // Function to price the rows in the byte range [begin, end) of the input file, which must start and end on line
+    // boundaries, and write them to the output behind the header if asked, returns the number of rows in the output
+    std::size_t Run(const std::string& input_path, const std::string& output_path, const unsigned long long& begin,
+        const unsigned long long& end, const bool& header) const;
+};
+
+// Must be the same name as in source file #define
+#ifndef STREAMPRICER_CPP
+#include "StreamPricer.cpp"
+#endif
+// It includes the contents of StreamPricer.cpp in the header file of STREAMPRICER_CPP is not already defined
+
+// End of the conditional inclusion of the header file
+#endif
@@ -12,10 +12,46 @@
 #include "ArrayPricer/ArrayPricer.hpp"
 #include "MatrixPricer/MatrixPricerEuropean.hpp"
 #include "MatrixPricer/MatrixPricerAmerican.hpp"
+#include "Driver/BatchDriver.hpp"
+#include "OptionBatch/MixedPrecision.hpp"
+#include "ParityScanner/ParityScanner.hpp"
+#include "PricingCache/PricingCache.hpp"
+#include "BumpEngine/BumpEngine.hpp"
+#include "VolSurface/VolSurface.hpp"
+#include "YieldCurve/YieldCurve.hpp"
+#include "RiskAggregator/RiskAggregator.hpp"
+#include "HistoricalVaR/HistoricalVaR.hpp"
+#include "HedgeSimulator/HedgeSimulator.hpp"
+#include "Options/HestonOption.hpp"
+#include "PricingService/PricingServer.hpp"
+#include "PricingService/LoadGenerator.hpp"
+#include "BatchEngine/BatchEngine.hpp"
+#include "ChebyshevProxy/ChebyshevProxy.hpp"
 
 // Main function of the program
-int main()
+int main(int argc, char* argv[])
 {
+    // Run the command-line batch driver when arguments are given, e.g.
+    // BatchPricer --input Inputs/EuropeanOptionBatch.csv --output Outputs/EuropeanOptionBatchPriced.csv --config all --threads 8
+    if (argc > 1)
+    {
+        try
+        {
+            return BatchDriver(argc, argv).Run();
+        }
+        catch (const std::logic_error& e)
+        {
+            std::cerr << "Error: " << e.what() << "\n" << std::endl;
+            BatchDriver::PrintUsage(std::cerr);
+            return 1;
+        }
+        catch (const std::runtime_error& e)
+        {
+            // Failures of the run itself, such as a shard that has not completed, do not need the usage
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
 
     // Price European Call and Put options using the Black-Scholes Model (BSM)
     EuropeanOption option_1("Call", 0.25, 65, 60, 0.08, 0.3, 1);
@@ -48,8 +84,10 @@ int main()
     option_1.CheckPutCallParity(2.1534, 0.05);
     option_1.CheckPutCallParity(2.5534, 0.05);
 
-    // Price a range of European Options using ArrayPricer class and save the output to CSV
-    ArrayPricer<EuropeanOption>(option_1, 10, 200, 5, "S", true).PriceArray(&EuropeanOption::Price, "Outputs/ArrayPricer.csv");
+    // Price a range of European Options using ArrayPricer class, with their Delta, Gamma and Vega in the same sweep, and
+    // save the output to CSV
+    ArrayPricer<EuropeanOption>(option_1, 10, 200, 5, "S", true).PriceArray(
+        { &EuropeanOption::Price, &EuropeanOption::Delta, &EuropeanOption::Gamma, &EuropeanOption::Vega }, "Outputs/ArrayPricer.csv");
 
     // Price a batch of European Options from a CSV file using MatrixPricerEuropean class and save the results
     MatrixPricerEuropean("Inputs/EuropeanOptionBatch.csv", true, "price").Price("Outputs/EuropeanOptionBatchPriced.csv");
@@ -66,15 +104,10 @@ int main()
     // Apply sensitivity formulas (e.g., Delta, Gamma) to a batch of European Options using MatrixPricerEuropean
     MatrixPricerEuropean("Inputs/EuropeanOptionBatch.csv", true, "all").Price("Outputs/EuropeanOptionBatchAll.csv");
 
-    // Calculate the numerical Delta for different shock sizes using ArrayPricer
-    std::cout << "Numeric Delta with a shock size of 20" << std::endl;
-    ArrayPricer<EuropeanOption>(option_5, 20, 200, 20, "S", true).PriceArray(&EuropeanOption::NumericDelta, 20);
-    std::cout << "Numeric Delta with a shock size of 5" << std::endl;
-    ArrayPricer<EuropeanOption>(option_5, 20, 200, 20, "S", true).PriceArray(&EuropeanOption::NumericDelta, 5);
-    std::cout << "Numeric Delta with a shock size of 0.001" << std::endl;
-    ArrayPricer<EuropeanOption>(option_5, 20, 200, 20, "S", true).PriceArray(&EuropeanOption::NumericDelta, 0.001);
-    std::cout << "Delta using its analytical formula" << std::endl;
-    ArrayPricer<EuropeanOption>(option_5, 20, 200, 20, "S", true).PriceArray(&EuropeanOption::NumericDelta, 0.001);
+    // Calculate the numerical Delta for different shock sizes and the analytical Delta in a single sweep using ArrayPricer
+    std::cout << "Numeric Delta with a shock size of 20, 5 and 0.001, and Delta using its analytical formula" << std::endl;
+    ArrayPricer<EuropeanOption>(option_5, 20, 200, 20, "S", true).PriceArray({ { &EuropeanOption::NumericDelta, 20 },
+        { &EuropeanOption::NumericDelta, 5 }, { &EuropeanOption::NumericDelta, 0.001 }, &EuropeanOption::Delta });
 
     // Test American Perpetual Option pricing for both Call and Put options
     AmericanOption option_6("Call", 100, 110, 0.1, 0.1, 0.02, 6);
@@ -82,6 +115,11 @@ int main()
     option_6.type("Put");
     std::cout << option_6 << ", Price: " << option_6.Price() << std::endl;
 
+    // Compare the analytic sensitivities of the American Perpetual Put with their numeric counterparts
+    std::cout << option_6 << ", Delta: " << option_6.Delta() << ", Numeric Delta: " << option_6.NumericDelta(0.01)
+        << ", Gamma: " << option_6.Gamma() << ", Numeric Gamma: " << option_6.NumericGamma(0.01) << std::endl;
+    std::cout << option_6 << ", Vega: " << option_6.Vega() << ", Rho: " << option_6.Rho() << ", Carry Rho: " << option_6.CarryRho() << std::endl;
+
     // Price an array of American Perpetual Options using ArrayPricer class
     ArrayPricer<AmericanOption>(option_6, 10, 200, 10, "S", true).PriceArray(&AmericanOption::Price);
 
@@ -98,6 +136,120 @@ int main()
     // Price a matrix of American Perpetual Options using the MatrixPricerAmerican class and save the results
     MatrixPricerAmerican("Inputs/AmericanOptionBatch.csv", true, "all").Price(0.5, "Outputs/AmericanOptionBatchPriced.csv");
 
+    // Compare single precision batch pricing against double precision over a strip of European options
+    std::vector<EuropeanOption> strip;
+    for (int strike = 50; strike <= 150; strike += 5)
+    {
+        strip.push_back(EuropeanOption("Call", 0.5, strike, 100, 0.05, 0.25, strike, 0.05));
+        strip.push_back(EuropeanOption("Put", 0.5, strike, 100, 0.05, 0.25, strike, 0.05));
+    }
+    std::cout << PrecisionReport(strip) << std::endl;
+
+    // Check put-call parity for the strip in single precision, refining borderline rows in double
+    std::vector<double> market_prices;
+    for (std::size_t i = 0; i < strip.size(); ++i)
+    {
+        market_prices.push_back(strip[i].PricePutCallParity() * (i % 7 == 0 ? 1.01 : i % 3 == 0 ? 1.02 : 1.005));
+    }
+    std::vector<bool> satisfied;
+    std::size_t refined = CheckPutCallParityMixed(strip, market_prices, 0.01, satisfied);
+    std::cout << "Put-Call Parity checked in mixed precision, " << refined << " of " << strip.size()
+        << " rows refined in double precision" << std::endl;
+
+    // Bump and revalue the strip in a single pricing pass, central differences with Richardson extrapolation
+    BumpEngine<EuropeanOption> engine(strip, BumpEngine<EuropeanOption>::BUMP_ALL, BumpEngine<EuropeanOption>::SCHEME_CENTRAL, true);
+    const std::vector<BumpEngine<EuropeanOption>::Risk>& risks = engine.Run();
+    std::cout << "Revalued " << engine.ScenarioCount() << " scenarios in one pass" << std::endl;
+    std::cout << strip[20] << ", Bumped Delta: " << risks[20].delta << ", Delta: " << strip[20].Delta()
+        << ", Bumped Gamma: " << risks[20].gamma << ", Gamma: " << strip[20].Gamma()
+        << ", Bumped Vega: " << risks[20].vega << ", Vega: " << strip[20].Vega() << std::endl;
+
+    // Scan a chain of matched call/put quotes for put-call parity violations larger than 0.1
+    ParityScanner scanner("Inputs/ParityQuotes.csv");
+    for (const auto& offender : scanner.Scan(0.1))
+    {
+        std::cout << "Pair " << offender.id << ", Parity violation: " << offender.violation << ", Excess: " << offender.excess << std::endl;
+    }
+
+    // Share a pricing cache between the matrix and array pricers, repeated contracts are served from the cache
+    std::shared_ptr<PricingCache> cache = std::make_shared<PricingCache>();
+    MatrixPricerEuropean("Inputs/EuropeanOptionBatch.csv", false, "price").Cache(cache).Price();
+    MatrixPricerEuropean("Inputs/EuropeanOptionBatch.csv", false, "price").Cache(cache).Price();
+    ArrayPricer<EuropeanOption>(option_5, 10, 200, 5, "S", false).Cache(cache).PriceArray(&EuropeanOption::Price);
+    ArrayPricer<EuropeanOption>(option_5, 10, 200, 5, "S", false).Cache(cache).PriceArray(&EuropeanOption::Price);
+    std::cout << *cache << std::endl;
+
+    // Read the volatility smile at six months from a surface and reprice the strip with its volatilities
+    std::shared_ptr<VolSurface> surface = std::make_shared<VolSurface>("Inputs/VolSurface.csv");
+    for (double strike = 80; strike <= 120; strike += 10)
+    {
+        std::cout << "T: 0.5, K: " << strike << ", S: 100, Surface volatility: " << surface->Volatility(0.5, strike, 100) << std::endl;
+    }
+    std::vector<std::vector<std::string>> surface_prices = MatrixPricerEuropean(strip, false, "price").Surface(surface).Price();
+    std::cout << strip[20] << ", Price: " << strip[20].Price() << ", Surface price: " << surface_prices[20].back() << std::endl;
+
+    // Take the rate and the cost of carry of every option from discount and carry curves at its maturity
+    std::shared_ptr<YieldCurve> rate_curve = std::make_shared<YieldCurve>("Inputs/YieldCurve.csv");
+    std::shared_ptr<YieldCurve> carry_curve = std::make_shared<YieldCurve>("Inputs/CarryCurve.csv");
+    std::cout << "Discount factor at T = 3: " << rate_curve->Discount(3) << ", Zero rate: " << rate_curve->ZeroRate(3) << std::endl;
+    std::cout << EuropeanOption(strip[20]).r(*rate_curve).b(*carry_curve) << std::endl;
+    MatrixPricerEuropean("Inputs/EuropeanOptionBatch.csv", true, "basic").Curves(rate_curve, carry_curve).Price();
+
+    // Net the value, Delta, Gamma and Vega of a book of positions per underlying and expiry bucket
+    RiskAggregator aggregator({ 0.25, 1 });
+    aggregator.Run("Inputs/EuropeanPositions.csv");
+    std::cout << aggregator;
+
+    // Revalue the same book under 250 historical shock vectors and read the VaR and Expected Shortfall
+    HistoricalVaR simulation("Inputs/EuropeanPositions.csv");
+    simulation.Run(HistoricalVaR::ReadScenarios("Inputs/HistoricalShocks.csv"));
+    std::cout << simulation << std::endl;
+
+    // Backtest delta hedging a short six-month call, on recorded paths and on simulated paths at two hedge frequencies
+    EuropeanOption hedged("Call", 0.5, 100, 100, 0.05, 0.2, 1, 0.03);
+    HedgeSimulator<EuropeanOption> recorded(hedged, 0.5, 13);
+    recorded.Load("Inputs/HedgePaths.csv").Run();
+    std::cout << "Recorded paths, " << recorded.Summary() << std::endl;
+    for (std::size_t steps : { 26, 126 })
+    {
+        HedgeSimulator<EuropeanOption> backtest(hedged, 0.5, steps);
+        backtest.Generate(10000, 0.08, 0.2).Run();
+        std::cout << steps << " rebalances, " << backtest.Summary() << std::endl;
+    }
+
+    // Price a one-year Heston strike chain with one transform and compare with pricing every strike on its own
+    HestonOption heston("Call", 1, 100, 100, 0.0, 0.0175, 1.5768, 0.0398, 0.5751, -0.5711);
+    std::vector<HestonOption> chain;
+    for (double strike = 60; strike <= 140; strike += 0.5)
+    {
+        chain.push_back(HestonOption(heston).K(strike).type(strike < 100 ? "Put" : "Call"));
+    }
+    std::vector<double> chain_prices = HestonOption::PriceChain(chain);
+    std::cout << heston << ", Price: " << heston.Price() << ", Chain price: " << chain_prices[80]
+        << ", Numeric Delta: " << heston.NumericDelta(0.01) << std::endl;
+    ArrayPricer<HestonOption>(heston, 80, 120, 10, "K").PriceArray(&HestonOption::Price);
+
+    // Interpolate the Heston price in spot, volatility and time to expiration, then reprice from the proxy
+    ChebyshevProxy<HestonOption> proxy(heston, { 70, 130, 20 }, { 0.1, 0.2, 8 }, { 0.5, 1.5, 8 }, &HestonOption::Price, 4);
+    proxy.Build().Validate(5);
+    std::cout << proxy << std::endl;
+    std::cout << heston << ", Price: " << heston.Price() << ", Proxy price: " << proxy.Value(heston) << std::endl;
+
+    // Price the strip through the static batch engine, the kernel of each measure is resolved at compile time
+    BatchEngine<BlackScholesModel> static_engine(strip);
+    std::vector<double> static_deltas;
+    static_engine.Run<EuropeanOption::MEASURE_DELTA>(static_deltas);
+    std::cout << strip[20] << ", Delta: " << strip[20].Delta() << ", Static engine Delta: " << static_deltas[20] << std::endl;
+
+    // Serve single-option requests on a local socket and load it from eight single-request clients
+    PricingServer server("BatchPricer.sock", 200);
+    server.Start();
+    LoadGenerator clients("BatchPricer.sock", 8, 2000);
+    clients.Run();
+    std::cout << clients << std::endl;
+    server.Stop();
+    std::cout << server << std::endl;
+
     // Return 0 to indicate successful execution
     return 0;
 }
@@ -0,0 +1,288 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// VolSurface.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the VolSurface class
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "VolSurface.hpp"
+#include "../Functions/Functions.hpp"
+
+// Function to estimate the derivative at node k of a sampled function by finite differences
+static double NodeDerivative(const std::vector<double>& nodes, const double* values, const std::size_t& stride, const std::size_t& k)
+{
+    std::size_t lo = k == 0 ? 0 : k - 1;
+    std::size_t hi = k + 1 == nodes.size() ? k : k + 1;
+
+    return (values[hi * stride] - values[lo * stride]) / (nodes[hi] - nodes[lo]);
+}
+
+// Function to compute the cell coefficients from the volatilities at the nodes
+void VolSurface::Build(const std::vector<double>& vols)
+{
+    const std::size_t rows = m_T.size();
+    const std::size_t columns = m_x.size();
+
+    // Derivatives at the nodes along expiry (u), log-moneyness (v) and the cross derivative
+    std::vector<double> fu(rows * columns), fv(rows * columns), fuv(rows * columns);
+
+    for (std::size_t i = 0; i < rows; ++i)
+    {
+        for (std::size_t j = 0; j < columns; ++j)
+        {
+            fu[i * columns + j] = NodeDerivative(m_T, &vols[j], columns, i);
+            fv[i * columns + j] = NodeDerivative(m_x, &vols[i * columns], 1, j);
+        }
+    }
+    for (std::size_t i = 0; i < rows; ++i)
+    {
+        for (std::size_t j = 0; j < columns; ++j)
+        {
+            fuv[i * columns + j] = NodeDerivative(m_T, &fv[j], columns, i);
+        }
+    }
+
+    // Hermite basis matrix, the coefficients of a cell are A = M * F * M^T
+    static const double M[4][4] = { { 1, 0, 0, 0 }, { 0, 0, 1, 0 }, { -3, 3, -2, -1 }, { 2, -2, 1, 1 } };
+
+    m_coefficients.assign((rows - 1) * (columns - 1) * 16, 0);
+
+    for (std::size_t i = 0; i + 1 < rows; ++i)
+    {
+        double hu = m_T[i + 1] - m_T[i];
+
+        for (std::size_t j = 0; j + 1 < columns; ++j)
+        {
+            double hv = m_x[j + 1] - m_x[j];
+            std::size_t n00 = i * columns + j, n01 = n00 + 1, n10 = n00 + columns, n11 = n10 + 1;
+
+            // Values and derivatives at the corners, derivatives scaled to the unit cell
+            double F[4][4] =
+            {
+                { vols[n00], vols[n01], fv[n00] * hv, fv[n01] * hv },
+                { vols[n10], vols[n11], fv[n10] * hv, fv[n11] * hv },
+                { fu[n00] * hu, fu[n01] * hu, fuv[n00] * hu * hv, fuv[n01] * hu * hv },
+                { fu[n10] * hu, fu[n11] * hu, fuv[n10] * hu * hv, fuv[n11] * hu * hv }
+            };
+
+            double MF[4][4] = {};
+            for (int a = 0; a < 4; ++a)
+                for (int b = 0; b < 4; ++b)
+                    for (int c = 0; c < 4; ++c)
+                        MF[a][b] += M[a][c] * F[c][b];
+
+            double* A = &m_coefficients[(i * (columns - 1) + j) * 16];
+            for (int a = 0; a < 4; ++a)
+                for (int b = 0; b < 4; ++b)
+                    for (int c = 0; c < 4; ++c)
+                        A[a * 4 + b] += MF[a][c] * M[b][c];
+        }
+    }
+}
+
+// Function to locate the cell of a coordinate on an axis, clamped to the grid
+std::size_t VolSurface::Locate(const std::vector<double>& nodes, const double& value, double& position)
+{
+    if (value <= nodes.front())
+    {
+        position = 0;
+        return 0;
+    }
+    if (value >= nodes.back())
+    {
+        position = 1;
+        return nodes.size() - 2;
+    }
+
+    std::size_t k = std::upper_bound(nodes.begin(), nodes.end(), value) - nodes.begin() - 1;
+    position = (value - nodes[k]) / (nodes[k + 1] - nodes[k]);
+    return k;
+}
+
+// Function to evaluate the polynomial of a cell
+double VolSurface::Evaluate(const std::size_t& i, const std::size_t& j, const double& u, const double& v) const
+{
+    const double* A = &m_coefficients[(i * (m_x.size() - 1) + j) * 16];
+
+    // Horner's scheme in v for each power of u, then in u
+    double result = 0;
+    for (int a = 3; a >= 0; --a)
+    {
+        const double* row = A + a * 4;
+        result = result * u + (((row[3] * v + row[2]) * v + row[1]) * v + row[0]);
+    }
+
+    return result;
+}
+
+// Constructor with expiries, moneyness values and volatilities
+VolSurface::VolSurface(const std::vector<double>& expiries, const std::vector<double>& moneyness,
+    const std::vector<std::vector<double>>& vols) :
+    m_T(expiries)
+{
+    if (expiries.size() < 2 || moneyness.size() < 2 || vols.size() != expiries.size())
+    {
+        throw std::invalid_argument("The volatility surface needs at least two expiries and two moneyness values");
+    }
+
+    std::vector<double> values;
+    values.reserve(expiries.size() * moneyness.size());
+
+    for (const auto& m : moneyness)
+    {
+        if (!(m > 0))
+        {
+            throw std::invalid_argument("Moneyness values must be positive");
+        }
+        m_x.push_back(std::log(m));
+    }
+
+    for (const auto& row : vols)
+    {
+        if (row.size() != moneyness.size())
+        {
+            throw std::invalid_argument("Every expiry needs one volatility per moneyness value");
+        }
+        for (const auto& vol : row)
+        {
+            if (!(vol > 0))
+            {
+                throw std::invalid_argument("Volatilities must be positive");
+            }
+            values.push_back(vol);
+        }
+    }
+
+    if (!std::is_sorted(m_T.begin(), m_T.end(), std::less_equal<double>()) ||
+        !std::is_sorted(m_x.begin(), m_x.end(), std::less_equal<double>()))
+    {
+        throw std::invalid_argument("Expiries and moneyness values must be strictly increasing");
+    }
+
+    Build(values);
+}
+
+// Constructor with the path of a surface file
+VolSurface::VolSurface(const std::string& input_path)
+{
+    std::ifstream file(input_path);
+    if (!file)
+    {
+        throw std::invalid_argument("Unable to open volatility surface file: " + input_path);
+    }
+
+    std::vector<double> moneyness;
+    std::vector<std::vector<double>> vols;
+    std::vector<std::string_view> fields(64);
+    std::string line;
+    bool header = true;
+
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line == "\r")
+        {
+            continue;
+        }
+
+        std::size_t count = splitFields(line, fields.data(), fields.size());
+        if (count == fields.size())
+        {
+            // Grow the field buffer and split again for very wide surfaces
+            fields.resize(std::count(line.begin(), line.end(), ',') + 1);
+            count = splitFields(line, fields.data(), fields.size());
+        }
+
+        std::vector<double> values(count > 0 ? count - 1 : 0);
+        double T = 0;
+        bool valid = count > 1 && (header || parseField(fields[0], T));
+
+        for (std::size_t k = 1; valid && k < count; ++k)
+        {
+            valid = parseField(fields[k], values[k - 1]);
+        }
+
+        if (!valid)
+        {
+            throw std::invalid_argument("Malformed volatility surface row: " + line);
+        }
+
+        if (header)
+        {
+            moneyness = values;
+            header = false;
+        }
+        else
+        {
+            m_T.push_back(T);
+            vols.push_back(values);
+        }
+    }
+
+    *this = VolSurface(m_T, moneyness, vols);
+}
+
+// Copy constructor
+VolSurface::VolSurface(const VolSurface& source) :
+    m_T(source.m_T),
+    m_x(source.m_x),
+    m_coefficients(source.m_coefficients)
+{}
+
+// Assignment operator
+VolSurface& VolSurface::operator=(const VolSurface& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_T = source.m_T;
+    m_x = source.m_x;
+    m_coefficients = source.m_coefficients;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to return the volatility for an expiry and a strike and spot
+double VolSurface::Volatility(const double& T, const double& K, const double& S) const
+{
+    double u = 0, v = 0;
+    std::size_t i = Locate(m_T, T, u);
+    std::size_t j = Locate(m_x, std::log(K / S), v);
+
+    return Evaluate(i, j, u, v);
+}
+
+// Function to look up n volatilities
+void VolSurface::Volatilities(const double* T, const double* K, const double* S, double* out, const std::size_t& n) const
+{
+    // Expiry cell of the previous query, reused while the expiries stay within it
+    std::size_t i = 0;
+    double lo = 1, hi = 0;
+
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        double u = 0, v = 0;
+
+        if (T[k] >= lo && T[k] < hi)
+        {
+            u = (T[k] - lo) / (hi - lo);
+        }
+        else
+        {
+            i = Locate(m_T, T[k], u);
+            // Only interior queries can reuse the cell, the clamped ones search again
+            lo = T[k] > m_T.front() && T[k] < m_T.back() ? m_T[i] : 1;
+            hi = T[k] > m_T.front() && T[k] < m_T.back() ? m_T[i + 1] : 0;
+        }
+
+        std::size_t j = Locate(m_x, std::log(K[k] / S[k]), v);
+        out[k] = Evaluate(i, j, u, v);
+    }
+}
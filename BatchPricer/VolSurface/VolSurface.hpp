@@ -0,0 +1,61 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// VolSurface.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the VolSurface class
+
+// If VOLSURFACE_HPP is not defined
+#ifndef VOLSURFACE_HPP
+// Define VOLSURFACE_HPP
+#define VOLSURFACE_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// Class definition for VolSurface, an implied volatility surface on a grid of expiries T and moneyness K / S.
+// The surface is interpolated bicubically in (T, ln(K / S)) with node derivatives estimated by finite differences
+// and extrapolated flat beyond the grid. The 16 polynomial coefficients of every grid cell are computed once on
+// construction and stored contiguously, so a lookup is two short binary searches and one polynomial evaluation
+// on two cache lines. The batch lookup reuses the expiry cell between consecutive queries, so queries sorted by
+// expiry skip the expiry search almost always.
+class VolSurface
+{
+private:
+
+    std::vector<double> m_T; // Expiry nodes, increasing
+    std::vector<double> m_x; // Log-moneyness nodes ln(K / S), increasing
+    std::vector<double> m_coefficients; // 16 coefficients per cell, cells in expiry-major order
+
+    // Function to compute the cell coefficients from the volatilities at the nodes (expiry-major)
+    void Build(const std::vector<double>& vols);
+
+    // Function to locate the cell of a coordinate on an axis and its position within the cell, clamped to the grid
+    static std::size_t Locate(const std::vector<double>& nodes, const double& value, double& position);
+
+    // Function to evaluate the polynomial of cell (i, j) at the positions (u, v) within the cell
+    double Evaluate(const std::size_t& i, const std::size_t& j, const double& u, const double& v) const;
+
+public:
+
+    // Constructor with expiries, moneyness values K / S and volatilities (one row of moneyness values per expiry)
+    VolSurface(const std::vector<double>& expiries, const std::vector<double>& moneyness, const std::vector<std::vector<double>>& vols);
+
+    // Constructor with the path of a surface file: a header row "T,m1,m2,..." of moneyness values K / S followed by
+    // one row per expiry "T,vol1,vol2,..."
+    VolSurface(const std::string& input_path);
+
+    // Copy constructor
+    VolSurface(const VolSurface& source);
+
+    // Assignment operator
+    VolSurface& operator=(const VolSurface& source);
+
+    // Function to return the volatility for an expiry and a strike and spot
+    double Volatility(const double& T, const double& K, const double& S) const;
+
+    // Function to look up n volatilities, fastest when the queries are sorted by expiry
+    void Volatilities(const double* T, const double* K, const double* S, double* out, const std::size_t& n) const;
+};
+
+// End of the conditional inclusion of the header file
+#endif
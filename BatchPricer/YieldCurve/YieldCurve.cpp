@@ -0,0 +1,160 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// YieldCurve.cpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the source code the YieldCurve class
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "YieldCurve.hpp"
+#include "../Functions/Functions.hpp"
+
+// Function to return the segment of a maturity
+std::size_t YieldCurve::Locate(const double& T) const
+{
+    if (T >= m_T.back())
+    {
+        return m_T.size() - 2;
+    }
+
+    std::size_t k = std::upper_bound(m_T.begin() + 1, m_T.end(), T) - m_T.begin();
+    return k - 1;
+}
+
+// Constructor with maturities and the zero rates at those maturities
+YieldCurve::YieldCurve(const std::vector<double>& maturities, const std::vector<double>& rates) :
+    m_T(1, 0),
+    m_log_discount(1, 0)
+{
+    if (maturities.empty() || maturities.size() != rates.size())
+    {
+        throw std::invalid_argument("The yield curve needs one rate per maturity and at least one maturity");
+    }
+
+    for (std::size_t i = 0; i < maturities.size(); ++i)
+    {
+        if (!(maturities[i] > m_T.back()) || !std::isfinite(maturities[i]) || !std::isfinite(rates[i]))
+        {
+            throw std::invalid_argument("Yield curve maturities must be positive and strictly increasing");
+        }
+
+        m_T.push_back(maturities[i]);
+        m_log_discount.push_back(-rates[i] * maturities[i]);
+    }
+
+    for (std::size_t i = 0; i + 1 < m_T.size(); ++i)
+    {
+        m_forward.push_back((m_log_discount[i] - m_log_discount[i + 1]) / (m_T[i + 1] - m_T[i]));
+    }
+}
+
+// Constructor with the path of a curve file
+YieldCurve::YieldCurve(const std::string& input_path)
+{
+    std::ifstream file(input_path);
+    if (!file)
+    {
+        throw std::invalid_argument("Unable to open yield curve file: " + input_path);
+    }
+
+    std::vector<double> maturities, rates;
+    std::string_view fields[2];
+    std::string line;
+
+    // Skip the header row
+    std::getline(file, line);
+
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line == "\r")
+        {
+            continue;
+        }
+
+        double T = 0, rate = 0;
+        if (splitFields(line, fields, 2) != 2 || !parseField(fields[0], T) || !parseField(fields[1], rate))
+        {
+            throw std::invalid_argument("Malformed yield curve row: " + line);
+        }
+
+        maturities.push_back(T);
+        rates.push_back(rate);
+    }
+
+    *this = YieldCurve(maturities, rates);
+}
+
+// Constructor with a flat rate
+YieldCurve::YieldCurve(const double& rate) :
+    YieldCurve(std::vector<double>{ 1 }, std::vector<double>{ rate })
+{}
+
+// Copy constructor
+YieldCurve::YieldCurve(const YieldCurve& source) :
+    m_T(source.m_T),
+    m_log_discount(source.m_log_discount),
+    m_forward(source.m_forward)
+{}
+
+// Assignment operator
+YieldCurve& YieldCurve::operator=(const YieldCurve& source)
+{
+    // Check for self assignment
+    if (this == &source)
+        return *this;
+
+    m_T = source.m_T;
+    m_log_discount = source.m_log_discount;
+    m_forward = source.m_forward;
+
+    // Return the current object (the object pointed by this)
+    return *this;
+}
+
+// Function to return the log-discount factor ln P(0, T)
+double YieldCurve::LogDiscount(const double& T) const
+{
+    std::size_t k = Locate(T);
+    return m_log_discount[k] - m_forward[k] * (T - m_T[k]);
+}
+
+// Function to return the discount factor P(0, T)
+double YieldCurve::Discount(const double& T) const
+{
+    return std::exp(LogDiscount(T));
+}
+
+// Function to return the continuously compounded zero rate to maturity T
+double YieldCurve::ZeroRate(const double& T) const
+{
+    return T > 0 ? -LogDiscount(T) / T : m_forward.front();
+}
+
+// Function to look up n zero rates
+void YieldCurve::ZeroRates(const double* T, double* out, const std::size_t& n) const
+{
+    // Segment of the previous query, reused while the maturities stay within it
+    std::size_t k = 0;
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        // Options of the same maturity share one evaluation
+        if (i > 0 && T[i] == T[i - 1])
+        {
+            out[i] = out[i - 1];
+            continue;
+        }
+
+        if (!(T[i] >= m_T[k] && (T[i] < m_T[k + 1] || k + 2 == m_T.size())))
+        {
+            k = Locate(T[i]);
+        }
+
+        out[i] = T[i] > 0 ? (m_forward[k] * (T[i] - m_T[k]) - m_log_discount[k]) / T[i] : m_forward.front();
+    }
+}
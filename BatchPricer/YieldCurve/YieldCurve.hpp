@@ -0,0 +1,62 @@
+// C++: Batch Option Pricer with Analytical and Numerical Sensitivities
+// YieldCurve.hpp
+// Álvaro Sánchez de Carlos
+// Description: this file contains the header code the YieldCurve class
+
+// If YIELDCURVE_HPP is not defined
+#ifndef YIELDCURVE_HPP
+// Define YIELDCURVE_HPP
+#define YIELDCURVE_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// Class definition for YieldCurve, a term structure of continuously compounded rates given as zero rates at a set of
+// maturities. It serves both as a discount curve for the risk-free rate r and as a carry curve for the cost of carry b.
+// The curve stores the log-discount factor -z(T) * T at every node, precomputed on construction, and interpolates it
+// linearly in T, which holds the forward rate flat between nodes and keeps the discount factors arbitrage free. Before
+// the first node the first forward rate applies and beyond the last node the last forward rate continues.
+class YieldCurve
+{
+private:
+
+    std::vector<double> m_T; // Maturity nodes, increasing, starting at 0
+    std::vector<double> m_log_discount; // Log-discount factors at the nodes, 0 at maturity 0
+    std::vector<double> m_forward; // Forward rate of each segment between consecutive nodes
+
+    // Function to return the segment of a maturity, clamped to the first and last segments
+    std::size_t Locate(const double& T) const;
+
+public:
+
+    // Constructor with maturities and the zero rates at those maturities
+    YieldCurve(const std::vector<double>& maturities, const std::vector<double>& rates);
+
+    // Constructor with the path of a curve file: a header row followed by one row "T,rate" per maturity
+    YieldCurve(const std::string& input_path);
+
+    // Constructor with a flat rate
+    YieldCurve(const double& rate);
+
+    // Copy constructor
+    YieldCurve(const YieldCurve& source);
+
+    // Assignment operator
+    YieldCurve& operator=(const YieldCurve& source);
+
+    // Function to return the log-discount factor ln P(0, T)
+    double LogDiscount(const double& T) const;
+
+    // Function to return the discount factor P(0, T)
+    double Discount(const double& T) const;
+
+    // Function to return the continuously compounded zero rate to maturity T, the instantaneous rate at T = 0
+    double ZeroRate(const double& T) const;
+
+    // Function to look up n zero rates, evaluating repeated maturities once; fastest when sorted by maturity
+    void ZeroRates(const double* T, double* out, const std::size_t& n) const;
+};
+
+// End of the conditional inclusion of the header file
+#endif